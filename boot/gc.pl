@@ -42,6 +42,8 @@ system:'$gc' :-
 %
 %   Wait for signals from other threads  to perform global GC operations
 %   and do them for them.
+%   If the Prolog flag `idle_trim_time` is  non-zero, this thread wakes
+%   up when idle for that time and trims the stacks of idle engines.
 %
 %   When using [tcmalloc](https://github.com/google/tcmalloc)   we  call
 %   MallocExtension_MarkThreadIdle() to transfer the   collected  memory
@@ -63,3 +65,5 @@ process(garbage_collect_atoms) :-
     garbage_collect_atoms.
 process(garbage_collect_clauses) :-
     garbage_collect_clauses.
+process(trim_engines) :-
+    '$trim_engines'.
@@ -924,6 +924,14 @@ define_or_generate(Pred) :-
     '$get_predicate_attribute'(Pred, abstract, N).
 '$predicate_property'(size(Bytes), Pred) :-
     '$get_predicate_attribute'(Pred, size, Bytes).
+'$predicate_property'(counted, Pred) :-
+    '$get_predicate_attribute'(Pred, counted, 1).
+'$predicate_property'(call_counts(Calls, Redos, Exits, Exceptions), Pred) :-
+    '$get_predicate_attribute'(Pred, call_counts,
+                               call_counts(Calls, Redos, Exits, Exceptions)).
+'$predicate_property'(call_latency(Count, Sum, Buckets), Pred) :-
+    '$get_predicate_attribute'(Pred, call_latency,
+                               call_latency(Count, Sum, Buckets)).
 
 system_undefined(user:prolog_trace_interception/4).
 system_undefined(user:prolog_exception_hook/4).
@@ -77,6 +77,12 @@ check_c_source_compiles(
      int main() { __builtin_mul_overflow(r1,r2,&r3); }"
     HAVE___BUILTIN_MUL_OVERFLOW)
 
+check_c_source_compiles(
+    "__attribute__((target_clones(\"avx2\",\"default\")))
+     static int f(int x) { return x+1; }
+     int main() { return f(0) != 1; }"
+    HAVE_TARGET_CLONES)
+
 if(NOT STATIC_EXTENSIONS)
 check_library_exists(dl	dlopen	      "" HAVE_LIBDL)
 endif()
@@ -207,6 +213,7 @@ check_function_exists(sigaltstack HAVE_SIGALTSTACK)
 check_function_exists(kill HAVE_KILL)
 check_function_exists(backtrace HAVE_BACKTRACE)
 check_function_exists(alarm HAVE_ALARM)
+check_function_exists(timer_create HAVE_TIMER_CREATE)
 # Allocation
 check_function_exists(mtrace HAVE_MTRACE)
 # terminal
@@ -290,6 +297,7 @@ check_function_exists(pthread_getcpuclockid HAVE_PTHREAD_GETCPUCLOCKID)
 check_function_exists(pthread_attr_setstacksize HAVE_PTHREAD_ATTR_SETSTACKSIZE)
 check_function_exists(pthread_getattr_np HAVE_PTHREAD_GETATTR_NP)
 check_function_exists(sched_setaffinity HAVE_SCHED_SETAFFINITY)
+check_function_exists(sched_yield HAVE_SCHED_YIELD)
 check_function_exists(sema_init HAVE_SEMA_INIT)
 check_function_exists(sem_init HAVE_SEM_INIT)
 check_function_exists(sem_timedwait HAVE_SEM_TIMEDWAIT)
@@ -37,18 +37,44 @@
             profile/2,                  % :Goal, +Options
             show_profile/1,             % +Options
             profile_data/1,             % -Dict
-            profile_procedure_data/2    % :PI, -Data
+            profile_procedure_data/2,   % :PI, -Data
+            sample_profile/1,           % :Goal
+            sample_profile/2,           % :Goal, +Options
+            write_folded_stacks/2,      % +Stream, +Samples
+            write_pprof/2,              % +Stream, +Samples
+            alloc_profile/1,            % :Goal
+            alloc_profile/2,            % :Goal, +Options
+            count_calls/1,              % :Spec
+            count_calls/2,              % :Spec, +Options
+            nocount_calls/1,            % :Spec
+            write_call_counts/1         % +Stream
           ]).
+:- autoload(library(apply), [maplist/2, maplist/3, include/3, foldl/4]).
+:- autoload(library(assoc), [list_to_assoc/2, get_assoc/3]).
 :- autoload(library(error),[must_be/2]).
-:- autoload(library(lists), [member/2]).
-:- autoload(library(option), [option/3]).
-:- autoload(library(pairs), [map_list_to_pairs/3, pairs_values/2]).
+:- autoload(library(lists),
+            [ member/2, reverse/2, nth1/3, numlist/3, list_to_set/2,
+              clumped/2, sum_list/2
+            ]).
+:- autoload(library(option), [option/2, option/3]).
+:- autoload(library(pairs),
+            [ map_list_to_pairs/3, pairs_values/2, pairs_keys_values/3,
+              group_pairs_by_key/2
+            ]).
 :- autoload(library(prolog_code), [predicate_sort_key/2, predicate_label/2]).
+:- autoload(library(utf8), [utf8_codes/3]).
 
 :- meta_predicate
     profile(0),
     profile(0, +),
-    profile_procedure_data(:, -).
+    profile_procedure_data(:, -),
+    sample_profile(0),
+    sample_profile(0, +),
+    alloc_profile(0),
+    alloc_profile(0, +),
+    count_calls(:),
+    count_calls(:, +),
+    nocount_calls(:).
 
 :- set_prolog_flag(generate_debug_info, false).
 
@@ -299,3 +325,626 @@ value(time(Key, percentage, Stat), Data, Percent) :-
 value(Name, Data, Value) :-
     Value = Data.Name.
 
+
+                 /*******************************
+                 *       SAMPLING PROFILER      *
+                 *******************************/
+
+%!  sample_profile(:Goal) is semidet.
+%!  sample_profile(:Goal, +Options) is semidet.
+%
+%   Run once(Goal) under the _sampling_ profiler.  Unlike profile/2,
+%   this does not instrument calls.  A per-thread timer interrupts the
+%   thread at a fixed frequency and records the predicates on the
+%   current call stack.  The overhead only depends on the frequency,
+%   which makes it usable in production.  Samples taken while the
+%   garbage collector is running show up as '$garbage_collect'.
+%   Options:
+%
+%     - frequency(+Hz)
+%       Number of samples per second of the clock.  Default is 99.
+%     - time(+Which)
+%       Sample `cpu` (default) or `wall` time.
+%     - depth(+Max)
+%       Record at most Max frames of each stack.  Default is 64.
+%     - buffer_size(+Words)
+%       Size of the sample buffer.  A sample takes one word for
+%       each frame plus one.  If the buffer is full, samples are
+%       dropped.  Default is 1,000,000.
+%     - samples(-Samples)
+%       Unify Samples with a dict holding the collected samples.
+%       See write_folded_stacks/2 for its layout.
+%     - folded(+File)
+%       Write the samples to File using write_folded_stacks/2.
+%     - pprof(+File)
+%       Write the samples to File using write_pprof/2.
+%
+%   If none of the last three options is given, the top 25
+%   predicates are printed.  This requires timer_create() and is
+%   not supported on Windows.
+
+sample_profile(Goal) :-
+    sample_profile(Goal, []).
+
+sample_profile(Goal0, Options) :-
+    option(frequency(Hz), Options, 99),
+    option(time(Which), Options, cpu),
+    option(depth(Depth), Options, 64),
+    option(buffer_size(Size), Options, 1 000 000),
+    time_name(Which, How),
+    expand_goal(Goal0, Goal),
+    (   setup_call_cleanup(
+            '$prof_sample_start'(How, Hz, Depth, Size),
+            catch(once(Goal), E, true),
+            '$prof_sample_stop')
+    ->  Result = true
+    ;   Result = false
+    ),
+    sample_data(Which, Hz, Samples),
+    sample_output(Samples, Options),
+    (   var(E)
+    ->  Result == true
+    ;   throw(E)
+    ).
+
+sample_data(Which, Hz,
+            samples{time:Which, period:Period,
+                    taken:Taken, dropped:Dropped, stacks:Stacks}) :-
+    '$prof_samples'(Raw, samples(Taken, Dropped)),
+    Period is round(1.0e9/Hz),
+    msort(Raw, Sorted),
+    clumped(Sorted, Counted),
+    sort(2, @>=, Counted, Stacks).
+
+sample_output(Samples, Options) :-
+    option(samples(S), Options),
+    !,
+    S = Samples,
+    sample_files(Samples, Options).
+sample_output(Samples, Options) :-
+    (   option(folded(_), Options)
+    ;   option(pprof(_), Options)
+    ),
+    !,
+    sample_files(Samples, Options).
+sample_output(Samples, Options) :-
+    get_dict(space, Samples, _),
+    !,
+    show_alloc_samples(Samples, Options).
+sample_output(Samples, Options) :-
+    show_samples(Samples, Options).
+
+sample_files(Samples, Options) :-
+    (   option(folded(File), Options)
+    ->  setup_call_cleanup(
+            open(File, write, Out, [encoding(utf8)]),
+            write_folded_stacks(Out, Samples),
+            close(Out))
+    ;   true
+    ),
+    (   option(pprof(PFile), Options)
+    ->  setup_call_cleanup(
+            open(PFile, write, POut, [type(binary)]),
+            write_pprof(POut, Samples),
+            close(POut))
+    ;   true
+    ).
+
+show_samples(Samples, Options) :-
+    Stacks = Samples.stacks,
+    findall(PI-Count, member([PI|_]-Count, Stacks), SelfL),
+    findall(PI-Count,
+            ( member(Stack-Count, Stacks),
+              sort(Stack, Set),
+              member(PI, Set)
+            ), TotalL),
+    sum_pairs(SelfL, Self),
+    sum_pairs(TotalL, Total),
+    list_to_assoc(Self, SelfA),
+    map_list_to_pairs(self_count(SelfA), Total, Keyed),
+    sort(1, @>=, Keyed, Sorted),
+    option(top(N), Options, 25),
+    format('~`=t~69|~n'),
+    format('Samples: ~D (~D dropped), ~w time~n',
+           [Samples.taken, Samples.dropped, Samples.time]),
+    format('~`=t~69|~n'),
+    format('~w~t~w~55|~t~w~69|~n', ['Predicate', 'Self', 'Total']),
+    format('~`=t~69|~n'),
+    forall(( nth1(I, Sorted, SelfCount-(PI-Count)),
+             I =< N
+           ),
+           ( sample_label(PI, Label),
+             format('~w~t~D~55|~t~D~69|~n', [Label, SelfCount, Count])
+           )).
+
+sum_pairs(Pairs, Summed) :-
+    keysort(Pairs, Sorted),
+    group_pairs_by_key(Sorted, Grouped),
+    maplist(sum_group, Grouped, Summed).
+
+sum_group(Key-Values, Key-Sum) :-
+    sum_list(Values, Sum).
+
+self_count(SelfA, PI-_, Count) :-
+    (   get_assoc(PI, SelfA, Count0)
+    ->  Count = Count0
+    ;   Count = 0
+    ).
+
+sample_label(PI, Label) :-
+    PI = _:_/_,
+    !,
+    predicate_label(PI, Label).
+sample_label(Label, Label) :-
+    atom(Label),
+    !.
+sample_label(Term, Label) :-
+    format(atom(Label), '~q', [Term]).
+
+%!  write_folded_stacks(+Stream, +Samples) is det.
+%
+%   Write Samples in the _folded stack_ format that is used by
+%   flamegraph.pl and compatible tools.  Each line holds the
+%   predicates of a unique stack, outermost first and separated by
+%   `;`, followed by a space and the number of samples for this
+%   stack.  Samples is a dict as returned by the samples(-Samples)
+%   option of sample_profile/2 with the following keys:
+%
+%     - time
+%       `cpu` or `wall`
+%     - period
+%       Nanoseconds between two samples
+%     - taken
+%       Number of samples taken
+%     - dropped
+%       Number of samples dropped because the buffer was full
+%     - stacks
+%       List of Stack-Count, where Stack is a list of qualified
+%       predicate indicators, leaf first.
+
+write_folded_stacks(Out, Samples) :-
+    forall(member(Stack-Count, Samples.stacks),
+           ( reverse(Stack, Path),
+             maplist(folded_label, Path, Labels),
+             atomic_list_concat(Labels, ';', Line),
+             format(Out, '~w ~d~n', [Line, Count])
+           )).
+
+folded_label(PI, Label) :-
+    sample_label(PI, Label0),
+    atomic_list_concat(Parts, ';', Label0),  % ;/2 breaks the format
+    atomic_list_concat(Parts, '|', Label).
+
+%!  write_pprof(+Stream, +Samples) is det.
+%
+%   Write Samples as an uncompressed `profile.proto` message that can
+%   be processed by pprof and compatible tools. Stream must be a binary
+%   stream. Each predicate is a function and location. Samples is
+%   described with write_folded_stacks/2 or is the result of
+%   alloc_profile/2, in which case the sample values are bytes.
+
+write_pprof(Out, Samples) :-
+    Stacks = Samples.stacks,
+    findall(PI, (member(Stack-_, Stacks), member(PI, Stack)), PIs0),
+    sort(PIs0, PIs),
+    length(PIs, NFuncs),
+    numlist(1, NFuncs, Ids),
+    pairs_keys_values(FuncPairs, PIs, Ids),
+    list_to_assoc(FuncPairs, FuncA),
+    maplist(pprof_function, PIs, Functions),
+    sample_type(Samples, Type, Unit),
+    findall(S, pprof_string(Functions, Type, S), Strings0),
+    list_to_set(['',samples,count,Unit,Type|Strings0], Strings),
+    length(Strings, NStrings),
+    MaxStr is NStrings-1,
+    numlist(0, MaxStr, StrIds),
+    pairs_keys_values(StrPairs, Strings, StrIds),
+    list_to_assoc(StrPairs, StrA),
+    phrase(pprof(Samples, Ids, Functions, FuncA, StrA, Strings), Bytes),
+    maplist(put_byte(Out), Bytes).
+
+sample_type(Samples, Type, nanoseconds) :-
+    get_dict(time, Samples, Time),
+    !,
+    time_type(Time, Type).
+sample_type(Samples, Type, bytes) :-
+    get_dict(space, Samples, Space),
+    space_type(Space, Type).
+
+time_type(cpu,  cpu).
+time_type(wall, wall).
+
+space_type(global, global_space).
+space_type(heap,   heap_space).
+
+pprof_function(PI, function(Label, Name, File, Line)) :-
+    sample_label(PI, Label),
+    format(atom(Name), '~q', [PI]),
+    (   PI = M:N/A,
+        functor(H, N, A),
+        predicate_property(M:H, file(File0)),
+        predicate_property(M:H, line_count(Line0))
+    ->  File = File0,
+        Line = Line0
+    ;   File = '',
+        Line = 0
+    ).
+
+pprof_string(Functions, _, S) :-
+    member(function(Label, Name, File, _), Functions),
+    member(S, [Label, Name, File]).
+
+pprof(Samples, Ids, Functions, FuncA, StrA, Strings) -->
+    { str(StrA, samples, SSamples), str(StrA, count, SCount),
+      sample_type(Samples, Type, Unit),
+      str(StrA, Type, SType), str(StrA, Unit, SUnit),
+      Period = Samples.period
+    },
+    pb_message(1, value_type(SSamples, SCount)),
+    pb_message(1, value_type(SType, SUnit)),
+    pb_samples(Samples.stacks, Period, FuncA),
+    pb_locations(Ids),
+    pb_functions(Functions, Ids, StrA),
+    pb_strings(Strings),
+    pb_message(11, value_type(SType, SUnit)),
+    pb_int(12, Period).
+
+str(StrA, S, Id) :-
+    get_assoc(S, StrA, Id).
+
+value_type(Type, Unit) -->
+    pb_int(1, Type),
+    pb_int(2, Unit).
+
+pb_samples([], _, _) --> [].
+pb_samples([Stack-Count|T], Period, FuncA) -->
+    { maplist(func_id(FuncA), Stack, Locs),
+      Value is Count*Period
+    },
+    pb_message(2, sample(Locs, [Count, Value])),
+    pb_samples(T, Period, FuncA).
+
+func_id(FuncA, PI, Id) :-
+    get_assoc(PI, FuncA, Id).
+
+sample(Locs, Values) -->
+    pb_packed(1, Locs),
+    pb_packed(2, Values).
+
+pb_locations([]) --> [].
+pb_locations([Id|T]) -->
+    pb_message(4, location(Id)),
+    pb_locations(T).
+
+location(Id) -->
+    pb_int(1, Id),
+    pb_message(4, line(Id)).
+
+line(FuncId) -->
+    pb_int(1, FuncId).
+
+pb_functions([], [], _) --> [].
+pb_functions([function(Label, Name, File, Line)|T], [Id|Ids], StrA) -->
+    { str(StrA, Label, SLabel), str(StrA, Name, SName),
+      str(StrA, File, SFile)
+    },
+    pb_message(5, function(Id, SLabel, SName, SFile, Line)),
+    pb_functions(T, Ids, StrA).
+
+function(Id, Label, Name, File, Line) -->
+    pb_int(1, Id),
+    pb_int(2, Label),
+    pb_int(3, Name),
+    pb_int(4, File),
+    pb_int(5, Line).
+
+pb_strings([]) --> [].
+pb_strings([H|T]) -->
+    { atom_codes(H, Codes),
+      phrase(utf8_codes(Codes), Bytes)
+    },
+    pb_bytes(6, Bytes),
+    pb_strings(T).
+
+%   Protobuf encoding.  Only non-negative integers are used.
+
+pb_int(Field, Value) -->
+    pb_key(Field, 0),
+    varint(Value).
+
+pb_bytes(Field, Bytes) -->
+    { length(Bytes, Len) },
+    pb_key(Field, 2),
+    varint(Len),
+    bytes(Bytes).
+
+pb_message(Field, Body) -->
+    { phrase(Body, Bytes) },
+    pb_bytes(Field, Bytes).
+
+pb_packed(Field, Values) -->
+    { phrase(varints(Values), Bytes) },
+    pb_bytes(Field, Bytes).
+
+pb_key(Field, WireType) -->
+    { Key is Field<<3 \/ WireType },
+    varint(Key).
+
+varints([]) --> [].
+varints([H|T]) --> varint(H), varints(T).
+
+varint(N) -->
+    { N < 0x80 },
+    !,
+    [N].
+varint(N) -->
+    { B is 0x80 \/ (N /\ 0x7f),
+      N1 is N >> 7
+    },
+    [B],
+    varint(N1).
+
+bytes([]) --> [].
+bytes([H|T]) --> [H], bytes(T).
+
+
+                 /*******************************
+                 *     ALLOCATION PROFILER      *
+                 *******************************/
+
+%!  alloc_profile(:Goal) is semidet.
+%!  alloc_profile(:Goal, +Options) is semidet.
+%
+%   Run once(Goal) while sampling memory allocation of the calling
+%   thread.  Each time a fixed number of bytes has been allocated, the
+%   predicates on the current call stack are recorded.  For the global
+%   stack, we also record whether the sampled cell survived the first
+%   garbage collection after it was allocated. Options:
+%
+%     - space(+Space)
+%       Sample the growth of the `global` stack (default) or
+%       allocation of `heap` memory through the Prolog memory
+%       allocator, e.g., for clauses and atoms.
+%     - sample_bytes(+Bytes)
+%       Take a sample after allocating Bytes.  Default is 65,536.
+%     - depth(+Max)
+%       Record at most Max frames of each stack.  Default is 64.
+%     - buffer_size(+Words)
+%       Size of the sample buffer.  A sample takes three words plus
+%       one for each frame.  Default is 1,000,000.
+%     - survival(+Bool)
+%       If `true` (default), run the garbage collector after Goal to
+%       determine the survival of the last samples.
+%     - samples(-Samples)
+%       Unify Samples with a dict holding the collected samples.
+%       The keys are `space`, `period` (bytes per sample), `taken`,
+%       `dropped`, `stacks` and `survival`.  `stacks` is described
+%       with write_folded_stacks/2.  `survival` is a list of
+%       PI-survival(Survived, Reclaimed) for the leaf predicates of
+%       the global stack samples, counted in samples.
+%     - folded(+File)
+%       Write the samples to File using write_folded_stacks/2.
+%     - pprof(+File)
+%       Write the samples to File using write_pprof/2.
+%
+%   If none of the last three options is given, the top 25
+%   predicates are printed.  Allocations by the VM are detected when
+%   a predicate is called, and are attributed to the called predicate
+%   and its ancestors.
+
+alloc_profile(Goal) :-
+    alloc_profile(Goal, []).
+
+alloc_profile(Goal0, Options) :-
+    option(space(Space), Options, global),
+    must_be(oneof([global,heap]), Space),
+    option(sample_bytes(Period), Options, 65 536),
+    option(depth(Depth), Options, 64),
+    option(buffer_size(Size), Options, 1 000 000),
+    option(survival(Survival), Options, true),
+    expand_goal(Goal0, Goal),
+    (   setup_call_cleanup(
+            '$alloc_sample_start'(Space, Period, Depth, Size),
+            ( catch(once(Goal), E, true),
+              (   Survival == true,
+                  Space == global
+              ->  garbage_collect
+              ;   true
+              )
+            ),
+            '$alloc_sample_stop')
+    ->  Result = true
+    ;   Result = false
+    ),
+    alloc_data(Space, Period, Samples),
+    sample_output(Samples, Options),
+    (   var(E)
+    ->  Result == true
+    ;   throw(E)
+    ).
+
+alloc_data(Space, Period,
+           samples{space:Space, period:Period,
+                   taken:Taken, dropped:Dropped,
+                   stacks:Stacks, survival:Survival}) :-
+    '$alloc_samples'(Raw, samples(Taken, Dropped)),
+    findall(Stack-W, member(sample(W, _, Stack), Raw), Pairs),
+    sum_pairs(Pairs, Summed),
+    sort(2, @>=, Summed, Stacks),
+    findall(PI-S, ( member(sample(W, How, [PI|_]), Raw),
+                    survival(How, W, S)
+                  ), SPairs),
+    keysort(SPairs, SSorted),
+    group_pairs_by_key(SSorted, Grouped),
+    maplist(sum_survival, Grouped, Survival).
+
+survival(survived,  W, survival(W, 0)).
+survival(reclaimed, W, survival(0, W)).
+
+sum_survival(PI-List, PI-survival(S, R)) :-
+    foldl(add_survival, List, 0-0, S-R).
+
+add_survival(survival(S, R), S0-R0, S1-R1) :-
+    S1 is S0+S,
+    R1 is R0+R.
+
+show_alloc_samples(Samples, Options) :-
+    Stacks = Samples.stacks,
+    Period = Samples.period,
+    findall(PI-Count, member([PI|_]-Count, Stacks), SelfL),
+    findall(PI-Count,
+            ( member(Stack-Count, Stacks),
+              sort(Stack, Set),
+              member(PI, Set)
+            ), TotalL),
+    sum_pairs(SelfL, Self),
+    sum_pairs(TotalL, Total),
+    list_to_assoc(Self, SelfA),
+    list_to_assoc(Samples.survival, SurvA),
+    map_list_to_pairs(self_count(SelfA), Total, Keyed),
+    sort(1, @>=, Keyed, Sorted),
+    option(top(N), Options, 25),
+    format('~`=t~79|~n'),
+    format('Samples: ~D (~D dropped), ~D bytes each, ~w space~n',
+           [Samples.taken, Samples.dropped, Period, Samples.space]),
+    format('~`=t~79|~n'),
+    format('~w~t~w~51|~t~w~67|~t~w~79|~n',
+           ['Predicate', 'Self', 'Total', 'Survived']),
+    format('~`=t~79|~n'),
+    forall(( nth1(I, Sorted, SelfCount-(PI-Count)),
+             I =< N
+           ),
+           ( sample_label(PI, Label),
+             SelfBytes is SelfCount*Period,
+             TotalBytes is Count*Period,
+             survival_column(SurvA, PI, Surv),
+             format('~w~t~D~51|~t~D~67|~t~w~79|~n',
+                    [Label, SelfBytes, TotalBytes, Surv])
+           )).
+
+survival_column(SurvA, PI, Column) :-
+    get_assoc(PI, SurvA, survival(S, R)),
+    S+R > 0,
+    !,
+    Perc is 100*S/(S+R),
+    format(atom(Column), '~1f%', [Perc]).
+survival_column(_, _, -).
+
+
+                 /*******************************
+                 *          CALL COUNTERS       *
+                 *******************************/
+
+%!  count_calls(:Spec) is det.
+%!  count_calls(:Spec, +Options) is det.
+%
+%   Start counting the ports of the  predicates   in  Spec,  which is a
+%   predicate indicator or a list or   conjunction of these. The counters
+%   are read using the predicate properties call_counts/4 and
+%   call_latency/3 or exported using write_call_counts/1.  Counting costs
+%   an atomic increment on a shared counter per port and recording the
+%   latency reads the clock twice per call.  The manual section on call
+%   counters gives an indication of the overhead.  Options:
+%
+%     * latency(+Bool)
+%     If `true` (default `false`), also maintain a histogram of the
+%     wall time between the call and each exit of the predicate.
+%
+%   If a clause ends in a call that is  subject to last call
+%   optimization, the exit or exception is counted when this last call
+%   exits or raises an exception.  The latency of such a call excludes
+%   the last call.  Foreign predicates cannot be counted.
+
+count_calls(Spec) :-
+    count_calls(Spec, []).
+
+count_calls(Spec, Options) :-
+    option(latency(Latency), Options, false),
+    must_be(boolean, Latency),
+    '$set_pattr'(Spec, pred, counted(true)),
+    '$set_pattr'(Spec, pred, count_latency(Latency)).
+
+%!  nocount_calls(:Spec) is det.
+%
+%   Stop counting the predicates in Spec and discard their counters.
+
+nocount_calls(Spec) :-
+    '$set_pattr'(Spec, pred, counted(false)).
+
+%!  write_call_counts(+Stream) is det.
+%
+%   Write the counters of all counted predicates to Stream in the
+%   Prometheus text exposition format.  The port counters are emitted
+%   as the counters `prolog_predicate_calls_total`,
+%   `prolog_predicate_redos_total`, `prolog_predicate_exits_total` and
+%   `prolog_predicate_exceptions_total`.  Latency histograms are emitted
+%   as `prolog_predicate_latency_seconds`.  All metrics are labeled with
+%   the qualified predicate indicator.
+
+write_call_counts(Out) :-
+    '$counted_predicates'(PIs0),
+    sort(PIs0, PIs),
+    maplist(call_count_data, PIs, Data),
+    forall(port_metric(Arg, Metric, Help),
+           write_port_metric(Out, Arg, Metric, Help, Data)),
+    include(has_latency, Data, Latency),
+    (   Latency == []
+    ->  true
+    ;   format(Out, '# HELP prolog_predicate_latency_seconds \c
+                     Wall time from call to exit~n', []),
+        format(Out, '# TYPE prolog_predicate_latency_seconds histogram~n', []),
+        forall(member(D, Latency), write_latency(Out, D))
+    ).
+
+port_metric(1, prolog_predicate_calls_total,      'Calls').
+port_metric(2, prolog_predicate_redos_total,      'Redos into alternative clauses').
+port_metric(3, prolog_predicate_exits_total,      'Exits').
+port_metric(4, prolog_predicate_exceptions_total, 'Exceptions').
+
+call_count_data(PI, counts(Label, Counts, Latency)) :-
+    PI = M:N/A,
+    functor(H, N, A),
+    metric_label(PI, Label),
+    (   predicate_property(M:H, call_counts(C,R,E,X))
+    ->  Counts = call_counts(C,R,E,X)
+    ;   Counts = call_counts(0,0,0,0)
+    ),
+    (   predicate_property(M:H, call_latency(Count, Sum, Buckets))
+    ->  Latency = call_latency(Count, Sum, Buckets)
+    ;   Latency = none
+    ).
+
+has_latency(counts(_, _, Latency)) :-
+    Latency \== none.
+
+write_port_metric(Out, Arg, Metric, Help, Data) :-
+    format(Out, '# HELP ~w ~w~n', [Metric, Help]),
+    format(Out, '# TYPE ~w counter~n', [Metric]),
+    forall(member(counts(Label, Counts, _), Data),
+           ( arg(Arg, Counts, Value),
+             format(Out, '~w{predicate="~w"} ~d~n', [Metric, Label, Value])
+           )).
+
+write_latency(Out, counts(Label, _, call_latency(Count, Sum, Buckets))) :-
+    foldl(write_bucket(Out, Label), Buckets, 0, _),
+    format(Out, 'prolog_predicate_latency_seconds_bucket\c
+                 {predicate="~w",le="+Inf"} ~d~n', [Label, Count]),
+    Seconds is Sum/1.0e9,
+    format(Out, 'prolog_predicate_latency_seconds_sum\c
+                 {predicate="~w"} ~15g~n', [Label, Seconds]),
+    format(Out, 'prolog_predicate_latency_seconds_count\c
+                 {predicate="~w"} ~d~n', [Label, Count]).
+
+write_bucket(Out, Label, UpperNs-N, Cum0, Cum) :-
+    Cum is Cum0+N,
+    Le is UpperNs/1.0e9,
+    format(Out, 'prolog_predicate_latency_seconds_bucket\c
+                 {predicate="~w",le="~15g"} ~d~n', [Label, Le, Cum]).
+
+%   Prometheus label values escape \, " and newline.
+
+metric_label(PI, Label) :-
+    format(string(S), '~q', [PI]),
+    split_string(S, "\\", "", P1), atomic_list_concat(P1, "\\\\", S1),
+    split_string(S1, "\"", "", P2), atomic_list_concat(P2, "\\\"", S2),
+    split_string(S2, "\n", "", P3), atomic_list_concat(P3, "\\n", Label).
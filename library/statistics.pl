@@ -199,9 +199,10 @@ shift_statistics -->
       ;   TS > 0
       ),
       !,
+      statistics(inplace_shifts, IS),
       statistics(shift_time, Time)
     },
-    [ shift{local:LS, global:GS, trail:TS, time:Time} ].
+    [ shift{local:LS, global:GS, trail:TS, inplace:IS, time:Time} ].
 shift_statistics --> [].
 
 thread_counts -->
@@ -424,9 +425,16 @@ msg_statistics(shift, S) -->
       get_dict(trail, S, Trail),
       get_dict(time, S, Time)
     },
-    [ 'Stack shifts: ~D local, ~D global, ~D trail in ~3f seconds'-
-      [ Local, Global, Trail, Time ]
-    ].
+    [ 'Stack shifts: ~D local, ~D global, ~D trail'-
+      [ Local, Global, Trail ]
+    ],
+    (   { get_dict(inplace, S, InPlace),
+          InPlace > 0
+        }
+    ->  [ ' (~D in place)'-[InPlace] ]
+    ;   []
+    ),
+    [ ' in ~3f seconds'-[Time] ].
 msg_statistics(thread, S) -->
     { get_dict(count, S, Count),
       get_dict(finished, S, Finished),
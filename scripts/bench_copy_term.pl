@@ -0,0 +1,85 @@
+/*  Part of SWI-Prolog
+
+    Author:        agent
+    E-mail:        agent@local
+    WWW:           http://www.swi-prolog.org
+    Copyright (c)  2026, agent
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in
+       the documentation and/or other materials provided with the
+       distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+
+:- module(bench_copy_term,
+          [ bench_copy_term/0,
+            bench_copy_term/1                   % +Count
+          ]).
+:- use_module(library(main)).
+:- use_module(library(apply), [foldl/4, maplist/3]).
+:- use_module(library(lists), [numlist/3]).
+
+:- initialization(main, main).
+
+/** <module> Benchmark copy_term/2 on ground terms
+
+Copy ground terms of increasing size Count times and report the CPU time
+for each.  The terms are lists of `r(I, "text", 1.5)` records with 10 to
+100,000 elements and a term where each level shares its subterm twice.
+Ground terms are not copied, so the time is spent deciding the term is
+ground.  The default Count is 1,000.  Run as
+
+    swipl scripts/bench_copy_term.pl [Count]
+*/
+
+main(Argv) :-
+    (   Argv = [A]
+    ->  atom_number(A, Count),
+        bench_copy_term(Count)
+    ;   bench_copy_term
+    ).
+
+bench_copy_term :-
+    bench_copy_term(1 000).
+
+bench_copy_term(Count) :-
+    forall(member(Len, [10, 1 000, 10 000, 100 000]),
+           ( records(Len, List),
+             bench(list(Len), List, Count)
+           )),
+    numlist(1, 20, Levels),
+    foldl([_,T0,f(T0,T0)]>>true, Levels, leaf, DAG),
+    bench(dag(20), DAG, Count).
+
+records(Len, List) :-
+    numlist(1, Len, Is),
+    maplist([I,r(I,"text",1.5)]>>true, Is, List).
+
+bench(Name, Term, Count) :-
+    call_time(copies(Term, Count), Time),
+    format("~w: ~D copies in ~3f sec~n", [Name, Count, Time.cpu]).
+
+copies(Term, Count) :-
+    forall(between(1, Count, _),
+           copy_term(Term, _)).
@@ -0,0 +1,79 @@
+/*  Part of SWI-Prolog
+
+    Author:        agent
+    E-mail:        agent@local
+    WWW:           http://www.swi-prolog.org
+    Copyright (c)  2026, agent
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in
+       the documentation and/or other materials provided with the
+       distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+
+:- module(bench_format,
+          [ bench_format/0,
+            bench_format/1                      % +Count
+          ]).
+:- use_module(library(main)).
+
+:- initialization(main, main).
+
+/** <module> Benchmark format/3
+
+Format Count log lines to ``/dev/null`` using format/3 with a format
+string (parsed on every call), a format atom (implicitly compiled and
+cached) and a template from format_compile/2, and report the CPU time
+for each.  The default Count is 1,000,000.  Run as
+
+    swipl scripts/bench_format.pl [Count]
+*/
+
+main(Argv) :-
+    (   Argv = [A]
+    ->  atom_number(A, Count),
+        bench_format(Count)
+    ;   bench_format
+    ).
+
+bench_format :-
+    bench_format(1 000 000).
+
+bench_format(Count) :-
+    Fmt = '[~a] request ~a from host ~a took ~d ms, status ~a~n',
+    atom_string(Fmt, String),
+    format_compile(Fmt, Template),
+    forall(member(Type-F, [string-String, atom-Fmt, template-Template]),
+           bench(Type, F, Count)).
+
+bench(Type, Fmt, Count) :-
+    setup_call_cleanup(
+        open('/dev/null', write, Out),
+        call_time(log_lines(Out, Fmt, Count), Time),
+        close(Out)),
+    format("~w: ~D lines in ~3f sec~n", [Type, Count, Time.cpu]).
+
+log_lines(Out, Fmt, Count) :-
+    forall(between(1, Count, I),
+           format(Out, Fmt, [info, get, localhost, I, ok])).
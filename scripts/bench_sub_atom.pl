@@ -0,0 +1,124 @@
+/*  Part of SWI-Prolog
+
+    Author:        agent
+    E-mail:        agent@local
+    WWW:           http://www.swi-prolog.org
+    Copyright (c)  2026, agent
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in
+       the documentation and/or other materials provided with the
+       distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+
+:- module(bench_sub_atom,
+          [ bench_sub_atom/0,
+            bench_sub_atom/1                    % +Size
+          ]).
+:- use_module(library(main)).
+
+:- initialization(main, main).
+
+/** <module> Benchmark substring search
+
+Search for a needle in a haystack using sub_atom/5, sub_string/5 and
+sub_atom_icasechk/3 and report the CPU time for each.  The cases are
+
+  - `worst`: a needle a^200 b in a haystack of Size times `a`.  This
+    is the quadratic case for a naive search.
+  - `text`: a 12 character needle in a haystack of Size characters of
+    text.
+  - `all`: enumerate all occurrences of a short needle in a haystack of
+    Size characters of text.
+
+The default Size is 1,000,000.  Run as
+
+    swipl scripts/bench_sub_atom.pl [Size]
+*/
+
+main(Argv) :-
+    (   Argv = [A]
+    ->  atom_number(A, Size),
+        bench_sub_atom(Size)
+    ;   bench_sub_atom
+    ).
+
+bench_sub_atom :-
+    bench_sub_atom(1 000 000).
+
+bench_sub_atom(Size) :-
+    forall(haystack(Case, Size, Hay, Needle, Count),
+           bench(Case, Hay, Needle, Count)).
+
+bench(all, Hay, Needle, Count) :-
+    !,
+    atom_string(Hay, HayS),
+    atom_string(Needle, NeedleS),
+    time_goal(all-sub_atom,
+              repeat_goal(Count, aggregate_all(count,
+                                               sub_atom(Hay, _, _, _, Needle),
+                                               _))),
+    time_goal(all-sub_string,
+              repeat_goal(Count, aggregate_all(count,
+                                               sub_string(HayS, _, _, _,
+                                                          NeedleS),
+                                               _))).
+bench(Case, Hay, Needle, Count) :-
+    atom_string(Hay, HayS),
+    atom_string(Needle, NeedleS),
+    time_goal(Case-sub_atom,
+              repeat_goal(Count, once(sub_atom(Hay, _, _, _, Needle)))),
+    time_goal(Case-sub_string,
+              repeat_goal(Count, once(sub_string(HayS, _, _, _, NeedleS)))),
+    time_goal(Case-sub_atom_icasechk,
+              repeat_goal(Count, sub_atom_icasechk(Hay, _, Needle))).
+
+time_goal(Name, Goal) :-
+    call_time(Goal, Time),
+    format("~w: ~3f sec~n", [Name, Time.cpu]).
+
+repeat_goal(Count, Goal) :-
+    forall(between(1, Count, _), ignore(Goal)).
+
+haystack(worst, Size, Hay, Needle, 5) :-
+    length(Codes, Size),
+    maplist(=(0'a), Codes),
+    atom_codes(Hay, Codes),
+    length(NCodes, 200),
+    maplist(=(0'a), NCodes),
+    append(NCodes, `b`, NeedleCodes),
+    atom_codes(Needle, NeedleCodes).
+haystack(text, Size, Hay, 'not in there', 20) :-
+    text(Size, Hay).
+haystack(all, Size, Hay, 'fox jumps', 5) :-
+    text(Size, Hay).
+
+text(Size, Hay) :-
+    Sentence = "The quick brown fox jumps over the lazy dog. ",
+    string_length(Sentence, Len),
+    Times is Size // Len + 1,
+    length(L, Times),
+    maplist(=(Sentence), L),
+    atomic_list_concat(L, Hay0),
+    sub_atom(Hay0, 0, Size, _, Hay).
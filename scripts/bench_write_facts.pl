@@ -0,0 +1,91 @@
+/*  Part of SWI-Prolog
+
+    Author:        agent
+    E-mail:        agent@local
+    WWW:           http://www.swi-prolog.org
+    Copyright (c)  2026, agent
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in
+       the documentation and/or other materials provided with the
+       distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+
+:- module(bench_write_facts,
+          [ bench_write_facts/0,
+            bench_write_facts/1,                % +Count
+            bench_write_facts/2                 % +Count, +File
+          ]).
+:- use_module(library(main)).
+
+:- initialization(main, main).
+
+/** <module> Benchmark writing facts
+
+Write Count facts using write_canonical/2 and writeq/2 to a file and
+report the CPU time for each.  The default is to write 10,000,000 facts
+to ``/dev/null``.  Run as
+
+    swipl scripts/bench_write_facts.pl [Count [File]]
+*/
+
+main(Argv) :-
+    (   Argv = [A|T]
+    ->  atom_number(A, Count),
+        (   T = [File]
+        ->  true
+        ;   File = '/dev/null'
+        ),
+        bench_write_facts(Count, File)
+    ;   bench_write_facts
+    ).
+
+bench_write_facts :-
+    bench_write_facts(10 000 000).
+
+bench_write_facts(Count) :-
+    bench_write_facts(Count, '/dev/null').
+
+bench_write_facts(Count, File) :-
+    forall(member(Writer, [write_canonical, writeq]),
+           bench(Writer, Count, File)).
+
+bench(Writer, Count, File) :-
+    setup_call_cleanup(
+        open(File, write, Out),
+        call_time(write_facts(Writer, Out, Count), Time),
+        close(Out)),
+    format("~w: ~D facts in ~3f sec~n", [Writer, Count, Time.cpu]).
+
+write_facts(Writer, Out, Count) :-
+    forall(between(1, Count, I),
+           ( fact(I, Fact),
+             call(Writer, Out, Fact),
+             nl(Out)
+           )).
+
+fact(I, edge(I, J, Label, Weight, [node, 'Node Label', I])) :-
+    J is I+1,
+    Label = 'connects to',
+    Weight is I/7.
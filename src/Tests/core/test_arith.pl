@@ -48,12 +48,14 @@ test_arith :-
                     minint_promotion,
                     maxint,
                     maxint_promotion,
+		    int128,
 		    round,
 		    float_overflow,
 		    float_zero,
 		    float_special,
 		    float_compare,
-		    arith_misc
+		    arith_misc,
+		    compile_expression
 		  ]).
 
 :- begin_tests(div).
@@ -387,6 +389,35 @@ test(multiplication) :-
 
 :- end_tests(maxint_promotion).
 
+:- begin_tests(int128, [condition(current_prolog_flag(bounded,false))]).
+
+% Integers between 64 and 128 bits are computed natively if the
+% platform supports __int128.
+
+test(mulmod, R == 23973268) :-
+	R is (1234567890123*9876543210987) mod 1000000007.
+test(back_to_small, [X == 42, true(integer(X))]) :-
+	X is (1<<100) + 42 - (1<<100).
+test(fnv, H == 0xaf63dc4c8601ec8c) :-
+	H is ((14695981039346656037 xor 0x61) * 1099511628211)
+	     /\ 0xFFFFFFFFFFFFFFFF.
+test(add_bound, A == B) :-
+	X is (1<<127) - 1,
+	A is X + X,
+	B is X * 2.
+test(mul_bound, X == 0x3fffffffffffffff0000000000000001) :-
+	X is 0x7fffffffffffffff * 0x7fffffffffffffff.
+test(mod, R == 734549) :-
+	R is (-(1<<100) - 12345) mod 1000003.
+test(div, Q == -3) :-
+	Q is ((1<<100)+1) div -((1<<99)).
+test(pow, X == 0x100000000000000000000000000000000) :-
+	X is 2^128.
+test(pow, X =:= 3^80) :-
+	X is 3^40 * 3^40.
+
+:- end_tests(int128).
+
 :- begin_tests(round).
 
 test(half_down, N == 0) :-
@@ -494,5 +525,84 @@ test(float_rval) :-
 :- set_prolog_flag(optimise, true).
 test(float_rval) :-
 	6.5 is max(6.5,3).
+test(mpq_constant, [condition(current_prolog_flag(bounded, false)),
+		    X == 4r3]) :-
+	X is 1r3+1.
+test(mpq_constant, [condition(current_prolog_flag(bounded, false)),
+		    X == 1267650600228229401496703205379r3]) :-
+	X is 1267650600228229401496703205376r3+1.
 
 :- end_tests(arith_misc).
+
+
+:- begin_tests(compile_expression).
+
+test(eval, V =:= X*2+sin(Y)-max(X,3)/Y) :-
+	compile_expression(A*2+sin(B)-max(A,3)/B, C),
+	X = 3, Y = 1.5,
+	eval_expression(C, [X, Y], V).
+test(params, V == 19) :-
+	compile_expression(X-Y, [Y, X], C),
+	eval_expression(C, [1, 20], V).
+test(variant, C1 == C2) :-
+	compile_expression(X+Y*2, C1),
+	compile_expression(A+B*2, C2),
+	X-Y \== A-B.
+test(shared_param, V == 25) :-
+	compile_expression(X*X, C),
+	eval_expression(C, [5], V).
+test(constants, [condition(current_prolog_flag(bounded, false)),
+		 V =:= pi+97+2**100+1r3+0.5]) :-
+	compile_expression(pi+"a"+2**100+1r3+_X, C),
+	eval_expression(C, [0.5], V).
+test(rational_constant, [condition(current_prolog_flag(bounded, false)),
+			 V == 1267650600228229401496703205379r3]) :-
+	compile_expression(1267650600228229401496703205376r3+_X, C),
+	eval_expression(C, [1], V).
+test(rational_constant, [condition(current_prolog_flag(bounded, false)),
+			 V == 3r1267650600228229401496703205376]) :-
+	compile_expression(_X*1r1267650600228229401496703205376, C),
+	eval_expression(C, [3], V).
+test(bignum_param, [condition(current_prolog_flag(bounded, false)),
+		    V == 1267650600228229401496703205377]) :-
+	compile_expression(_X+1, C),
+	eval_expression(C, [2**100], V).
+test(expression_param, V == 7) :-
+	compile_expression(_X+1, C),
+	eval_expression(C, [2*3], V).
+test(roundtoward, Up > Down) :-
+	compile_expression(roundtoward(1/X, to_positive), C1),
+	compile_expression(roundtoward(1/X, to_negative), C2),
+	eval_expression(C1, [3.0], Up),
+	eval_expression(C2, [3.0], Down).
+test(arity, error(domain_error(arity, [1]))) :-
+	compile_expression(_X+_Y, C),
+	eval_expression(C, [1], _).
+test(partial_list, error(instantiation_error)) :-
+	compile_expression(_X+_Y, C),
+	eval_expression(C, [1|_], _).
+test(not_list, error(type_error(list, [1|a]))) :-
+	compile_expression(_X+_Y, C),
+	eval_expression(C, [1|a], _).
+test(not_evaluable, error(type_error(evaluable, foo/1))) :-
+	compile_expression(foo(_), _).
+test(unbound, error(instantiation_error)) :-
+	compile_expression(X+_, [X], _).
+test(zero_div, error(evaluation_error(zero_divisor))) :-
+	compile_expression(1//_X, C),
+	eval_expression(C, [0], _).
+test(deep, true) :-
+	left_nested_sum(1 000 000, _X, E),
+	catch(( compile_expression(E, C),
+		eval_expression(C, [0], V),
+		assertion(V == 1 000 000)
+	      ),
+	      error(resource_error(_), _),
+	      true).
+
+left_nested_sum(0, E, E) :- !.
+left_nested_sum(N, E0, E) :-
+	N1 is N-1,
+	left_nested_sum(N1, E0+1, E).
+
+:- end_tests(compile_expression).
@@ -56,6 +56,49 @@ test(share, Shared == [x(1)]) :-
 test(cycle, [sto(rational_trees)]) :-
     f(X) = X,
     test_copy(X, _Shared).
+test(ground) :-
+    T = f(a, g(1, "s"), [x,y]),
+    copy_term(T, Copy),
+    assertion(same_term(T, Copy)).
+test(ground_dag) :-				% exponential tree, linear DAG
+    numlist(1, 100, L),
+    foldl([_,T0,f(T0,T0)]>>true, L, a, T),
+    copy_term(T, Copy),
+    assertion(same_term(T, Copy)).
+test(ground_dag_repeat) :-			% must not expand the DAG
+    numlist(1, 1 000 000, Big),		% make the global stack large
+    numlist(1, 60, L),
+    foldl([_,T0,f(T0,T0)]>>true, L, a, T),
+    forall(between(1, 1000, _),
+	   ( copy_term(T, Copy),
+	     assertion(same_term(T, Copy))
+	   )),
+    length(Big, _).
+test(ground_large) :-				% beyond the unmarked budget
+    numlist(1, 100000, L),
+    maplist([I,r(I,"s")]>>true, L, T),
+    copy_term(T, Copy),
+    assertion(same_term(T, Copy)),
+    copy_term(T, Copy2),			% marks must be cleared
+    assertion(same_term(T, Copy2)).
+test(nonground_dag) :-				% variable found while marking
+    numlist(1, 20, L),
+    foldl([_,T0,f(T0,T0)]>>true, L, a, DAG),
+    copy_term(t(DAG, g(X)), Copy),
+    Copy = t(DAG2, g(Y)),
+    assertion(same_term(DAG, DAG2)),
+    assertion(var(Y)),
+    assertion(Y \== X),
+    copy_term(DAG, Copy2),			% marks must be cleared
+    assertion(same_term(DAG, Copy2)).
+test(ground_cycle, [sto(rational_trees), Copy == X]) :-
+    X = f(a, X),
+    copy_term(X, Copy).
+test(deep_var, Copy =@= T) :-
+    numlist(1, 100000, L),
+    append(L, [_], T),
+    copy_term(T, Copy),
+    assertion(\+ same_term(T, Copy)).
 
 :- end_tests(copy_term).
 
@@ -70,4 +70,31 @@ test(radix, error(domain_error(radix, 37))) :-
 test(asterisk, error(format('no or negative integer for `*\' argument'))) :-
     format('~t~*|', [-1]).
 
+test(string, A == "ab-x-cd") :-
+	format(string(A), "ab-~w-cd", [x]).
+test(compile, L == ["a:   x|", "b:   y|"]) :-
+	format_compile('~w:~t~a~6||', T),
+	findall(S, ( member(X-Y, [a-x,b-y]),
+		     format(string(S), T, [X,Y])
+		   ), L).
+test(compile, L == ['~x...', '~yy..']) :-
+	format_compile("~~~a~`.t~*|", T),
+	format(atom(A), T, [x, 5]),
+	format(atom(B), T, [yy, 5]),
+	L = [A,B].
+test(compile, error(format('not enough arguments'))) :-
+	format_compile('~w ~w', T),
+	format(atom(_), T, [a]).
+test(compile, error(type_error(text, f(x)))) :-
+	format_compile(f(x), _).
+test(position, P == 6) :-
+	with_output_to(string(_),
+		       ( format('ab~ncd ef~w', [g]),
+			 line_position(current_output, P)
+		       )).
+test(cached, L == [a1, a2, a3]) :-
+	findall(A, ( between(1, 3, I),
+		     format(atom(A), 'a~w', [I])
+		   ), L).
+
 :- end_tests(format).
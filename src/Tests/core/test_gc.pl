@@ -47,6 +47,8 @@ test_gc :-
 		    gc_crash,
 		    gc_crash2,
 		    gc_mark,
+		    gc_policy,
+		    stack_reserve,
 		    agc
 		  ]).
 
@@ -252,6 +254,94 @@ a(Y) :- length(Y,_).
 :- end_tests(gc_mark).
 
 
+:- begin_tests(gc_policy).
+
+:- dynamic
+	gc_event/1.
+
+record_gc(Dict) :-
+	assertz(gc_event(Dict)).
+
+churn(0) :- !.
+churn(N) :-
+	numlist(1, 1000, L),
+	msort(L, _),
+	N2 is N-1,
+	churn(N2).
+
+with_gc_flag(Flag, Value, Goal) :-
+	current_prolog_flag(Flag, Old),
+	setup_call_cleanup(
+	    set_prolog_flag(Flag, Value),
+	    Goal,
+	    set_prolog_flag(Flag, Old)).
+
+restore_factors(Global, Trail) :-
+	set_prolog_stack(global, factor(Global)),
+	set_prolog_stack(trail, factor(Trail)).
+
+test(event, [ Reason-After == user-true,
+	      cleanup(prolog_unlisten(gc, record_gc))
+	    ]) :-
+	retractall(gc_event(_)),
+	prolog_listen(gc, record_gc),
+	garbage_collect,
+	findall(D, gc_event(D), [Dict|_]),
+	get_dict(reason, Dict, Reason),
+	(   _{global_before:Before, global_after:Used,
+	      global_size:Size, time:Time} :< Dict,
+	    Used =< Before,
+	    Used =< Size,
+	    float(Time)
+	->  After = true
+	;   After = false
+	).
+test(fraction, [ F > F0,
+		 cleanup(restore_factors(F0, TF0))
+	       ]) :-
+	prolog_stack_property(global, factor(F0)),
+	prolog_stack_property(trail, factor(TF0)),
+	with_gc_flag(gc_target_fraction, 0.000001, churn(20000)),
+	prolog_stack_property(global, factor(F)),
+	prolog_stack_property(trail, factor(TF)),
+	assertion(TF == TF0).
+test(pause, [ F < 10,
+	      cleanup(restore_factors(F0, TF0))
+	    ]) :-
+	prolog_stack_property(global, factor(F0)),
+	prolog_stack_property(trail, factor(TF0)),
+	set_prolog_stack(global, factor(20)),
+	with_gc_flag(gc_target_pause, 1.0e-9, churn(20000)),
+	prolog_stack_property(global, factor(F)).
+test(range, error(domain_error(_, 1))) :-
+	set_prolog_flag(gc_target_fraction, 1).
+test(range, error(domain_error(not_less_than_zero, -1))) :-
+	set_prolog_flag(gc_target_pause, -1).
+
+:- end_tests(gc_policy).
+
+:- begin_tests(stack_reserve,
+	       [ condition(current_prolog_flag(stack_reserve, _))
+	       ]).
+
+grow_and_trim(N) :-
+	numlist(1, N, L),
+	garbage_collect,
+	sum_list(L, Sum),
+	Sum =:= N*(N+1)//2,
+	trim_stacks.
+
+test(inplace, [ I > I0,
+		cleanup(set_prolog_flag(stack_reserve, Old))
+	      ]) :-
+	current_prolog_flag(stack_reserve, Old),
+	set_prolog_flag(stack_reserve, true),
+	statistics(inplace_shifts, I0),
+	forall(between(1, 3, _), grow_and_trim(200000)),
+	statistics(inplace_shifts, I).
+
+:- end_tests(stack_reserve).
+
 :- begin_tests(agc).
 
 /* - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
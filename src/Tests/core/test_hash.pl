@@ -40,7 +40,9 @@
 
 test_hash :-
 	run_tests([ variant_sha1,
-		    variant_hash
+		    variant_sha1_stream,
+		    variant_hash,
+		    term_hash
 		  ]).
 
 :- begin_tests(variant_sha1).
@@ -82,6 +84,41 @@ v(_).
 
 :- end_tests(variant_sha1).
 
+:- begin_tests(variant_sha1_stream).
+
+stream_hash(Parts, Hash) :-
+	variant_sha1_new(C),
+	forall(member(P, Parts), variant_sha1_add(C, P)),
+	variant_sha1_hash(C, Hash).
+
+test(empty, Hash1 == Hash2) :-
+	stream_hash([], Hash1),
+	variant_sha1([], Hash2).
+test(list, Hash1 == Hash2) :-
+	Parts = [a, f(X,Y,X), "str", 42, 1.5, g(_), 100000000000000000000],
+	stream_hash(Parts, Hash1),
+	variant_sha1(Parts, Hash2),
+	assertion(var(Y)).
+test(continue, Hash1 == Hash2) :-
+	variant_sha1_new(C),
+	variant_sha1_add(C, a),
+	variant_sha1_hash(C, _),
+	variant_sha1_add(C, b),
+	variant_sha1_hash(C, Hash1),
+	variant_sha1([a,b], Hash2).
+test(error_unchanged, Hash1 == Hash2) :-
+	A = a(A),
+	variant_sha1_new(C),
+	variant_sha1_add(C, a),
+	catch(variant_sha1_add(C, A), error(type_error(acyclic_term, _), _),
+	      true),
+	variant_sha1_hash(C, Hash1),
+	variant_sha1([a], Hash2).
+test(type, error(type_error(variant_sha1, foo))) :-
+	variant_sha1_add(foo, a).
+
+:- end_tests(variant_sha1_stream).
+
 :- begin_tests(variant_hash).
 
 test(variant, true) :-
@@ -103,3 +140,21 @@ test(variant, Hash1 == Hash2) :-
 v(_).
 
 :- end_tests(variant_hash).
+
+:- begin_tests(term_hash).
+
+% term_hash/2 values may be stored and must not change, regardless
+% of the hash function used for the atom table.
+
+test(atom, H == 5716028) :-
+	term_hash(foo, H).
+test(compound, H == 3432486) :-
+	term_hash(f(a,1,"s",2.5), H).
+test(list, H == 512016) :-
+	term_hash([a,b,c], 3, 1000000, H).
+test(new_atom, H1 == H2) :-
+	atom_concat(new_, atom, A),
+	term_hash(A, H1),
+	term_hash(new_atom, H2).
+
+:- end_tests(term_hash).
@@ -67,6 +67,53 @@ random_seq(0, []).
 
 test(state, [X==Y]) :-
 	tr(100, X,Y).
+test(state_bignum, [X==Y]) :-
+	set_random(seed(random)),
+	random_property(state(State)),
+	X is random(1<<100),
+	set_random(state(State)),
+	Y is random(1<<100).
+test(state_old, error(domain_error(random_state, _))) :-
+	random_property(state(State)),
+	Old is State >> 320,		% GMP state only, as in old versions
+	set_random(state(Old)).
+test(state_tampered, error(domain_error(random_state, _))) :-
+	random_property(state(State)),
+	Bad is State xor (1<<300),
+	set_random(state(Bad)).
+test(seed, [X==Y]) :-
+	set_random(seed(42)),
+	X is random(1000),
+	set_random(seed(42)),
+	Y is random(1000).
+test(jump, [X\==Y]) :-
+	set_random(seed(42)),
+	random_numbers(5, 1000000, X),
+	set_random(seed(42)),
+	set_random(jump(1)),
+	random_numbers(5, 1000000, Y).
+test(jump_interrupt, [ condition(current_prolog_flag(threads, true)),
+		       throws(stop)
+		     ]) :-
+	thread_self(Me),
+	thread_create((sleep(0.2), thread_signal(Me, throw(stop))), Id),
+	N is 1<<62,
+	call_cleanup(set_random(jump(N)), thread_join(Id)).
+test(random_numbers, [true(forall(member(X, L), (integer(X), X >= 0, X < 6)))]) :-
+	random_numbers(1000, 6, L),
+	length(L, 1000).
+test(random_numbers_float,
+     [true(forall(member(X, L), (float(X), X > 0.0, X =< 2.5)))]) :-
+	random_numbers(1000, 2.5, L).
+test(random_numbers_big,
+     [true(forall(member(X, L), (integer(X), X >= 0, X < 1<<100)))]) :-
+	Bound is 1<<100,
+	random_numbers(10, Bound, L),
+	length(L, 10).
+test(random_numbers_empty, L == []) :-
+	random_numbers(0, 6, L).
+test(random_numbers_bound, error(domain_error(not_less_than_one, 0))) :-
+	random_numbers(10, 0, _).
 
 test(random_subseq, [
 	forall((between(-3, 3, U), numlist(-3, U, List))),
@@ -46,7 +46,8 @@ Test term reading, notably option processing
 */
 
 test_read :-
-	run_tests([ read_term
+	run_tests([ read_term,
+		    read_bignum
 		  ]).
 
 :- begin_tests(read_term).
@@ -161,6 +162,53 @@ test(valid_position_dict3) :-
 
 :- end_tests(read_term).
 
+:- begin_tests(read_bignum, [condition(current_prolog_flag(bounded, false))]).
+
+test(decimal) :-
+	forall(member(E, [20, 300, 3000, 30000]),
+	       ( X is 7**E-1,
+		 round_trip('~d', X),
+		 Neg is -X,
+		 round_trip('~d', Neg)
+	       )).
+test(radix) :-
+	X is 3**5000+17,
+	forall(member(Radix, [2, 8, 16, 36]),
+	       ( format(string(S), '~w\'~*r', [Radix, Radix, X]),
+		 term_string(Y, S),
+		 assertion(Y == X)
+	       )).
+test(separators, X == Y) :-
+	X is 10**600-1,
+	length(Groups, 200),
+	maplist(=("999"), Groups),
+	atomic_list_concat(Groups, '_', S1),
+	term_string(X, S1),
+	atomic_list_concat(Groups, ' ', S2),
+	term_string(Y, S2).
+test(hex_separators, X == Y) :-
+	X is 16**300-1,
+	length(Groups, 100),
+	maplist(=("fff"), Groups),
+	atomic_list_concat(Groups, '_', S0),
+	atom_concat('0x', S0, S),
+	term_string(Y, S).
+test(unicode, X == 123456789012345678901234567890) :-
+	numlist(1, 30, L),
+	maplist(arabic_indic_digit, L, Codes),
+	atom_codes(A, Codes),
+	term_to_atom(X, A).
+
+:- end_tests(read_bignum).
+
+round_trip(Fmt, X) :-
+	format(string(S), Fmt, [X]),
+	number_string(Y, S),
+	assertion(Y == X).
+
+arabic_indic_digit(I, C) :-
+	C is 0x660 + I mod 10.
+
 %%	catch_messages(+Kind, :Goal, -Messages) is semidet.
 
 :- thread_local
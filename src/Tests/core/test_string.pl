@@ -81,6 +81,19 @@ test(split_string, L == ["SWI-Prolog"]) :-
 	split_string("  SWI-Prolog  ", "", "\s\t\n", L).
 test(split_string, L == [""]) :-
 	split_string(" ", "", " ", L).
+test(split_string, Len-Last == 200000-"f199999") :-
+	numlist(0, 199999, Nums),		% forces GC and stack shifts
+	maplist([N,F]>>format(string(F), "f~w", [N]), Nums, Fields),
+	atomic_list_concat(Fields, ',', Atom),
+	atom_string(Atom, String),
+	split_string(String, ",", "", L),
+	length(L, Len),
+	last(L, Last).
+test(string_concat, Len == 1001) :-
+	length(Codes, 1000),
+	maplist(=(0'a), Codes),
+	string_codes(S, Codes),
+	aggregate_all(count, string_concat(_, _, S), Len).
 test(string_lower, L == "abc") :-
 	string_lower("aBc", L).
 test(string_upper, L == "ABC") :-
@@ -237,6 +237,28 @@ test(neg, C = '\235\') :-		% test signed char handling
 	sub_atom('Azi\235\', _, 1, 0, C).
 test(nondet, X == 3) :-			% det when matching at last position
 	sub_atom('cadabra', X, 4, _, 'abra').
+test(search, L == [0,3,6]) :-
+	findall(B, sub_atom(abcabcabc, B, _, _, abc), L).
+test(search, L == [0,1]) :-		% periodic needle
+	findall(B, sub_atom(aaaa, B, _, _, aaa), L).
+test(search, L == [1,4]) :-		% wide haystack
+	findall(B, sub_atom('x\x3b1\yx\x3b1\y', B, _, _, '\x3b1\y'), L).
+test(search, fail) :-			% wide needle, latin-1 haystack
+	sub_atom(abc, _, _, _, '\x3b1\').
+test(search, B == 999999) :-		% large haystack
+	length(Codes, 1000000),
+	maplist(=(0'a), Codes),
+	append(Codes, `ab`, All),
+	atom_codes(Big, All),
+	sub_atom(Big, B, _, _, aab).
+test(icasechk, S == 2) :-
+	sub_atom_icasechk('xyHello', S, hello).
+test(icasechk, S == 5) :-		% uppercase in needle only matches itself
+	sub_atom_icasechk('helloHello', S, 'He').
+test(icasechk, fail) :-
+	sub_atom_icasechk('xyHello', 3, hello).
+test(icasechk) :-
+	sub_atom_icasechk('xyHello', 2, hello).
 
 :- end_tests(sub_atom).
 
@@ -46,7 +46,9 @@ unification is wrong you won't get as far as running this test :-)
 
 test_unify :-
 	run_tests([ unify,
-		    can_compare
+		    can_compare,
+		    cycle_threshold,
+		    identical_runs
 		  ]).
 
 :- begin_tests(unify).
@@ -105,3 +107,152 @@ test(ground, fail) :-
 	?=(a,X).
 
 :- end_tests(can_compare).
+
+:- begin_tests(cycle_threshold).
+
+% Run unification, comparison and variant checks with different
+% settings of the cycle_check_threshold flag.  The fast path must
+% switch to the cycle-safe algorithm for cyclic terms.
+
+with_threshold(T, Goal) :-
+	current_prolog_flag(cycle_check_threshold, Old),
+	setup_call_cleanup(
+	    set_prolog_flag(cycle_check_threshold, T),
+	    Goal,
+	    set_prolog_flag(cycle_check_threshold, Old)).
+
+cyclic(X, Y) :-
+	X = f(X, a),
+	Y = f(f(Y, a), a).
+
+test(unify, forall(member(T, [0,1,5,100000]))) :-
+	cyclic(X, Y),
+	with_threshold(T, X = Y).
+test(unify_fail, forall(member(T, [0,1,5,100000]))) :-
+	X = f(X, a),
+	Y = f(f(Y, a), b),
+	with_threshold(T, \+ X = Y).
+test(eq, forall(member(T, [0,1,5,100000]))) :-
+	cyclic(X, Y),
+	with_threshold(T, X == Y).
+test(compare, forall(member(T, [0,1,5,100000]))) :-
+	X = f(X, a),
+	Y = f(Y, b),
+	with_threshold(T, compare(<, X, Y)).
+test(variant, forall(member(T, [0,1,5,100000]))) :-
+	X = f(X, A),
+	Y = f(f(Y, B), B),
+	with_threshold(T, X =@= Y),
+	A \== B.
+test(not_variant, forall(member(T, [0,1,5,100000]))) :-
+	X = f(X, _),
+	Y = f(f(Y, _), _),
+	with_threshold(T, X \=@= Y).
+test(deep, forall(member(T, [0,10,100000]))) :-
+	numlist(1, 10000, L),
+	length(L1, 10000),
+	length(L2, 10000),
+	with_threshold(T,
+		       ( L1 =@= L2,
+			 L1 = L, L2 = L,
+			 L1 == L2,
+			 compare(=, L1, L2)
+		       )).
+test(zero, Results0 == Results) :-
+	term_pairs(Pairs),
+	maplist(compare_pair, Pairs, Results),
+	with_threshold(0, maplist(compare_pair, Pairs, Results0)).
+test(flag, error(domain_error(not_less_than_zero, -1))) :-
+	set_prolog_flag(cycle_check_threshold, -1).
+
+% Threshold 0 uses the old algorithm.  It must give the same results as
+% the default.
+
+term_pairs([ [a,b,c]-[a,b,c],
+	     [a,b,c]-[a,b,d],
+	     f(a,b,c)-f(a,b,_),
+	     f(X,a,X)-f(Y,a,Y),
+	     f(X,a,X)-f(Y,a,_),
+	     L1-L2,
+	     C1-C2,
+	     C1-C3
+	   ]) :-
+	numlist(1, 1000, L1),
+	numlist(1, 1000, L2),
+	C1 = [a,b|C1],
+	C2 = [a,b,a,b|C2],
+	C3 = [a,c|C3].
+
+compare_pair(T1-T2, r(O, Eq, V)) :-
+	compare(O, T1, T2),
+	( T1 == T2 -> Eq = true ; Eq = false ),
+	( T1 =@= T2 -> V = true ; V = false ).
+
+:- end_tests(cycle_threshold).
+
+:- begin_tests(identical_runs).
+
+% Comparison skips runs of identical cells and runs along lists with
+% identical heads.  Verify that free variables are not considered
+% equal, that differences are found and that cyclic lists terminate.
+
+cyclic_list(N, Elem, L) :-
+	length(L0, N),
+	maplist(=(Elem), L0),
+	append(L0, L, L).
+
+test(wide_eq, true(T1 == T2)) :-
+	numlist(1, 1000, L),
+	T1 =.. [f|L],
+	T2 =.. [f|L].
+test(wide_compare, Order == (<)) :-
+	numlist(1, 1000, L),
+	append(L, [a], L1),
+	append(L, [b], L2),
+	T1 =.. [f|L1],
+	T2 =.. [f|L2],
+	compare(Order, T1, T2).
+test(wide_var, fail) :-
+	length(L, 100),
+	maplist(=(a), L),
+	append(L, [_], L1),
+	append(L, [_], L2),
+	T1 =.. [f|L1],
+	T2 =.. [f|L2],
+	T1 == T2.
+test(list_compare, Order == (>)) :-
+	numlist(1, 100000, L1),
+	numlist(1, 99999, L0),
+	append(L0, [0], L2),
+	compare(Order, L1, L2).
+test(list_var, fail) :-
+	length(L, 100),
+	maplist(=(a), L),
+	append(L, [_], L1),
+	append(L, [_], L2),
+	L1 == L2.
+test(cyclic_list, forall(member(T-N, [0-1,0-40,5-1,5-40,100000-17]))) :-
+	cyclic_list(N, a, X),
+	cyclic_list(3, a, Y),
+	with_threshold(T, X == Y).
+test(cyclic_list_compare, forall(member(T, [0,5,100000]))) :-
+	X = [a,a,b|X],
+	Y = [a,a,c|Y],
+	with_threshold(T, compare(<, X, Y)).
+test(shared_tails, true(S1 == S2)) :-
+	numlist(1, 100000, L1),
+	numlist(1, 100000, L2),
+	tails(L1, S1),
+	tails(L2, S2).
+test(variant, true) :-
+	f(a,b,c,X) =@= f(a,b,c,Y),
+	X \== Y,
+	f(a,b,X,X) \=@= f(a,b,X,Y).
+test(sort, L == [[1,2,3],[1,2,4]]) :-
+	sort([[1,2,3],[1,2,4],[1,2,3]], L).
+
+tails([], [[]]).
+tails([H|T], [[H|T]|R]) :-
+	tails(T, R).
+
+:- end_tests(identical_runs).
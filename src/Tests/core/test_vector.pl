@@ -0,0 +1,229 @@
+/*  Part of SWI-Prolog
+
+    Author:        agent
+    E-mail:        agent@local
+    WWW:           http://www.swi-prolog.org
+    Copyright (c)  2026, agent
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in
+       the documentation and/or other materials provided with the
+       distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+
+:- module(test_vector,
+	  [ test_vector/0
+	  ]).
+:- use_module(library(plunit)).
+:- use_module(library(lists), [numlist/3, sum_list/2]).
+:- use_module(library(apply), [maplist/2, maplist/3]).
+:- use_module(library(yall)).
+
+test_vector :-
+	run_tests([ vector
+		  ]).
+
+/** <module> Test packed numeric vectors
+*/
+
+:- set_prolog_flag(optimise, true).
+optimised_sum(V, X) :-
+	X is sum_vector(V).
+:- set_prolog_flag(optimise, false).
+
+:- begin_tests(vector).
+
+test(list, L == [1,-2,3,4611686018427387904,-9223372036854775808]) :-
+	list_to_vector(int64, [1,-2,3,4611686018427387904,-9223372036854775808], V),
+	vector_to_list(V, L).
+test(list, L == [1.0,2.5,-3.0]) :-
+	list_to_vector(float64, [1,2.5,-3], V),
+	vector_to_list(V, L).
+test(list, L == [0.5,0.25]) :-
+	list_to_vector(float32, [0.5,0.25], V),
+	vector_to_list(V, L).
+test(list, L == []) :-
+	list_to_vector(float64, [], V),
+	vector_to_list(V, L).
+test(list, error(type_error(integer, a))) :-
+	list_to_vector(int64, [1,a], _).
+test(list, error(representation_error(int64_t))) :-
+	X is 1<<70,
+	list_to_vector(int64, [X], _).
+test(list, error(domain_error(vector_type, int8))) :-
+	list_to_vector(int8, [], _).
+test(properties, [T-N == float32-5, nondet]) :-
+	new_vector(float32, 5, 0, V),
+	is_vector(V),
+	vector_type(V, T),
+	vector_length(V, N).
+test(get_set, [X-Y == 7-2]) :-
+	list_to_vector(int64, [1,2,3], V),
+	vector_set(V, 0, 7),
+	vector_get(V, 0, X),
+	vector_get(V, 1, Y).
+test(get_set, error(existence_error(index, 3, V))) :-
+	list_to_vector(int64, [1,2,3], V),
+	vector_get(V, 3, _).
+test(get_set, error(domain_error(not_less_than_zero, -1))) :-
+	list_to_vector(int64, [1,2,3], V),
+	vector_get(V, -1, _).
+test(get_set, error(existence_error(index, 2, V))) :-
+	new_vector(float32, 2, 0.0, V),
+	vector_set(V, 2, 1.0).
+test(get_set, X == 1.5) :-
+	new_vector(float64, 3, 0.0, V),
+	(   vector_set(V, 1, 1.5),
+	    fail
+	;   true
+	),
+	vector_get(V, 1, X).
+test(slice, L == [2,3]) :-
+	list_to_vector(int64, [1,2,3,4], V),
+	vector_slice(V, 1, 2, S),
+	vector_to_list(S, L).
+test(slice, L == []) :-
+	list_to_vector(int64, [1,2,3,4], V),
+	vector_slice(V, 4, 0, S),
+	vector_to_list(S, L).
+test(slice, error(existence_error(index, 4, V))) :-
+	list_to_vector(int64, [1,2,3,4], V),
+	vector_slice(V, 3, 2, _).
+test(slice, error(existence_error(index, 6, V))) :-
+	list_to_vector(int64, [1,2,3,4], V),
+	vector_slice(V, 6, 0, _).
+test(slice, error(domain_error(not_less_than_zero, -1))) :-
+	list_to_vector(int64, [1,2,3,4], V),
+	vector_slice(V, -1, 2, _).
+test(sum, S == Expected) :-
+	numlist(1, 1000, L),
+	sum_list(L, Expected),
+	list_to_vector(int64, L, V),
+	vector_sum(V, S).
+test(sum, S == Expected) :-
+	Max is 1<<62,
+	length(L, 100),
+	maplist(=(Max), L),
+	Expected is 100*Max,
+	list_to_vector(int64, L, V),
+	vector_sum(V, S).
+test(sum, S == Expected) :-
+	numlist(1, 37, L0),
+	maplist([X,Y]>>(Y is -X*(1<<56)), L0, L),
+	sum_list(L, Expected),
+	list_to_vector(int64, L, V),
+	vector_sum(V, S).
+test(sum, S =:= 500500) :-
+	numlist(1, 1000, L),
+	list_to_vector(float32, L, V),
+	vector_sum(V, S).
+test(dot, D == 32) :-
+	list_to_vector(int64, [1,2,3], V1),
+	list_to_vector(int64, [4,5,6], V2),
+	vector_dot(V1, V2, D).
+test(dot, D == Expected) :-
+	Big is 1<<40,
+	list_to_vector(int64, [Big,Big,1], V),
+	vector_dot(V, V, D),
+	Expected is 2*Big*Big+1.
+test(dot, D =:= 32) :-
+	list_to_vector(int64, [1,2,3], V1),
+	list_to_vector(float64, [4,5,6], V2),
+	vector_dot(V1, V2, D).
+test(dot, error(domain_error(vector_length, _))) :-
+	list_to_vector(int64, [1,2,3], V1),
+	list_to_vector(int64, [1,2], V2),
+	vector_dot(V1, V2, _).
+test(axpy, L == [6.0,9.0,12.0,15.0,18.0,21.0,24.0,27.0,30.0,33.0]) :-
+	numlist(1, 10, L1),
+	list_to_vector(float64, L1, X),
+	new_vector(float64, 10, 3, Y),
+	vector_axpy(3, X, Y, Z),
+	vector_to_list(Z, L).
+test(axpy, L == [3,5]) :-
+	list_to_vector(int64, [1,2], X),
+	list_to_vector(int64, [1,1], Y),
+	vector_axpy(2, X, Y, Z),
+	vector_to_list(Z, L).
+test(axpy, error(evaluation_error(int_overflow))) :-
+	Max is 1<<62,
+	list_to_vector(int64, [Max], X),
+	vector_axpy(2, X, X, _).
+test(min_max, Min-Max == -7-9) :-
+	list_to_vector(int64, [3,-7,9,0,1,2,3,4,5,6,7,8], V),
+	vector_min_max(V, Min, Max).
+test(min_max, Min-Max == -1.0-2.0) :-
+	NaN is nan,
+	list_to_vector(float64, [NaN,1,NaN,2,-1], V),
+	vector_min_max(V, Min, Max).
+test(min_max, fail) :-
+	new_vector(float32, 0, 0, V),
+	vector_min_max(V, _, _).
+test(sort, L == Sorted) :-
+	numlist(1, 1000, L0),
+	maplist([X,Y]>>(Y is (X*7919) mod 1009 - 500), L0, L1),
+	msort(L1, Sorted),
+	list_to_vector(int64, L1, V),
+	vector_sort(V, S),
+	vector_to_list(S, L).
+test(sort, L == Sorted) :-
+	numlist(1, 300, L0),
+	maplist([X,Y]>>(Y is sin(X)*1.0e10), L0, L1),
+	msort(L1, Sorted),
+	list_to_vector(float64, L1, V),
+	vector_sort(V, S),
+	vector_to_list(S, L).
+test(sort, L == [MInf,-1.5,-0.0,0.0,2.0,Inf]) :-
+	Inf is inf, MInf is -inf,
+	list_to_vector(float32, [2,0.0,Inf,-1.5,MInf,-0.0], V),
+	vector_sort(V, S),
+	vector_to_list(S, L).
+test(cumsum, L == [1,3,6,10]) :-
+	list_to_vector(int64, [1,2,3,4], V),
+	vector_cumsum(V, C),
+	vector_to_list(C, L).
+test(cumsum, L == [0.5,1.5,3.0]) :-
+	list_to_vector(float64, [0.5,1,1.5], V),
+	vector_cumsum(V, C),
+	vector_to_list(C, L).
+test(function, X == 6) :-
+	list_to_vector(int64, [1,2,3], V),
+	X is sum_vector(V).
+test(function, X =:= 3+14) :-
+	list_to_vector(float64, [1,2,3], V),
+	X is sum_vector(V)/2+dot_vector(V,V).
+test(function, X-Y == 1-3) :-
+	list_to_vector(int64, [3,1,2], V),
+	X is min_vector(V),
+	Y is max_vector(V).
+test(function, error(type_error(vector, foo))) :-
+	_ is sum_vector(foo).
+test(function, error(evaluation_error(undefined))) :-
+	new_vector(int64, 0, 0, V),
+	_ is max_vector(V).
+test(function, X == 6) :-
+	list_to_vector(int64, [1,2,3], V),
+	optimised_sum(V, X).
+
+:- end_tests(vector).
@@ -125,6 +125,21 @@ test(quote, S=="'\\x3B1\\'") :-
 	write_encoding(write_canonical('\u03B1'),
 		       ascii, S).
 
+test(fact, S=="f(1,-2,'a b','it\\'s',[x,'Y'|z],\"s\",1.5,:-(a))") :-
+	with_output_to(string(S),
+		       write_canonical(f(1,-2,'a b','it\'s',[x,'Y'|z],"s",1.5,(:-a)))).
+test(fact, S=="f(1, [a, b], c)") :-
+	with_output_to(string(S),
+		       write_term(f(1,[a,b],c),
+				  [ quoted(true), ignore_ops(true),
+				    spacing(next_argument)
+				  ])).
+test(position, Pos == 14) :-
+	with_output_to(string(_),
+		       ( write_canonical(f('a b',[1,2])),
+			 line_position(current_output, Pos)
+		       )).
+
 :- end_tests(write_canonical).
 
 :- begin_tests(write_quoted).
@@ -137,6 +152,16 @@ test(comment, S == "+/*") :-		% Quote /* only when at start
 	with_output_to(string(S), writeq('+/*')).
 test(comment, S == "'%'") :-
 	with_output_to(string(S), writeq('%')).
+test(cached, L == ["'a b'", "'a b'", "'==`'", "==`", "'==`'"]) :-
+	findall(S,
+		( member(A-Opts,
+			 [ 'a b'-[], 'a b'-[],
+			   '==`'-[], '==`'-[back_quotes(symbol_char)], '==`'-[]
+			 ]),
+		  with_output_to(string(S),
+				 write_term(A, [quoted(true)|Opts]))
+		),
+		L).
 test(escape, S == "\u03B1") :-		  % Greek Aplha character
 	with_output_to(string(S), write_term('\u03B1', [quoted(true)])).
 test(escape, S == "'\u03B1'") :-
@@ -224,6 +249,33 @@ test(nan) :-
 	abs(Float) >= 1,
 	abs(Float) < 2.
 
+test(shortest, X == '0.1') :-
+	with_output_to(atom(X), write(0.1)).
+test(shortest, X == '0.30000000000000004') :-
+	A is 0.1+0.2,
+	with_output_to(atom(X), write(A)).
+test(shortest, X == '1.0e+22') :-
+	with_output_to(atom(X), write(1.0e22)).
+test(shortest, X == '-0.0') :-
+	A is -0.0,
+	with_output_to(atom(X), write(A)).
+test(shortest, X == '5.0e-324') :-
+	A is nexttoward(0.0, 1),
+	with_output_to(atom(X), write(A)).
+test(shortest, X == '1.7976931348623157e+308') :-
+	A = 1.7976931348623157e308,
+	with_output_to(atom(X), write(A)).
+test(round_trip) :-
+	forall(( between(-330, 310, E),
+		 member(M, [1.0, 1.2345678901234567, 9.999999999999999])
+	       ),
+	       ( catch(F is M*10.0**E, _, fail)
+	       -> format(atom(A), '~q', [F]),
+		  term_to_atom(F2, A),
+		  F2 == F
+	       ;  true
+	       )).
+
 :- end_tests(write_float).
 
 write_encoding(Goal, Encoding, String) :-
@@ -0,0 +1,149 @@
+/*  Part of SWI-Prolog
+
+    Author:        agent
+    E-mail:        agent@local
+    WWW:           http://www.swi-prolog.org
+    Copyright (c)  2026, agent
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in
+       the documentation and/or other materials provided with the
+       distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+
+:- module(test_call_counts,
+          [ test_call_counts/0
+          ]).
+:- use_module(library(plunit)).
+:- use_module(library(prolog_profile)).
+:- use_module(library(lists)).
+
+test_call_counts :-
+    run_tests([ call_counts
+              ]).
+
+:- dynamic
+    fact/1.
+
+fact(1).
+fact(2).
+fact(3).
+
+det_p(X) :- X = 1.
+
+loop(0) :- !.
+loop(N) :- N1 is N-1, loop(N1).
+
+fails(1) :- fail.
+fails(2).
+
+throws :- throw(oops).
+
+lco_throws :- throws.			% last calls
+lco_fails :- fails(1).
+lco_nondet(X) :- fact(X).
+
+counts(PI, Counts) :-
+    PI = N/A,
+    functor(H, N, A),
+    predicate_property(test_call_counts:H, call_counts(C,R,E,X)),
+    Counts = c(C,R,E,X).
+
+:- begin_tests(call_counts, [cleanup(nocount_calls([fact/1,det_p/1,loop/1,
+                                                      fails/1,throws/0,
+                                                      lco_throws/0,
+                                                      lco_fails/0,
+                                                      lco_nondet/1]))]).
+
+test(det, Counts == c(1000,0,1000,0)) :-
+    count_calls(det_p/1),
+    forall(between(1, 1000, _), det_p(_)),
+    counts(det_p/1, Counts),
+    nocount_calls(det_p/1).
+test(redo, Counts == c(1,2,3,0)) :-
+    count_calls(fact/1),
+    forall(fact(_), true),
+    counts(fact/1, Counts),
+    nocount_calls(fact/1).
+test(first_clause_fails, Counts == c(1,0,1,0)) :-
+    count_calls(fails/1),
+    fails(_),
+    counts(fails/1, Counts),
+    nocount_calls(fails/1).
+test(exception, Counts == c(1,0,0,1)) :-
+    count_calls(throws/0),
+    catch(throws, oops, true),
+    counts(throws/0, Counts),
+    nocount_calls(throws/0).
+test(last_call_exception, Counts == c(1,0,0,1)) :-
+    count_calls(lco_throws/0),
+    catch(lco_throws, oops, true),
+    counts(lco_throws/0, Counts),
+    nocount_calls(lco_throws/0).
+test(last_call_fails, Counts == c(1,0,0,0)) :-
+    count_calls(lco_fails/0),
+    \+ lco_fails,
+    counts(lco_fails/0, Counts),
+    nocount_calls(lco_fails/0).
+test(last_call_nondet, Counts-FCounts == c(1,0,3,0)-c(1,2,3,0)) :-
+    count_calls([lco_nondet/1, fact/1]),
+    forall(lco_nondet(_), true),
+    counts(lco_nondet/1, Counts),
+    counts(fact/1, FCounts),
+    nocount_calls([lco_nondet/1, fact/1]).
+test(last_call_cut, Counts == c(1,0,1,0)) :-
+    count_calls(lco_nondet/1),
+    once(lco_nondet(_)),
+    counts(lco_nondet/1, Counts),
+    nocount_calls(lco_nondet/1).
+test(recursion, Count-Total == 101-101) :-
+    count_calls(loop/1, [latency(true)]),
+    loop(100),
+    predicate_property(loop(_), call_latency(Count, _Sum, Buckets)),
+    aggregate_all(sum(N), member(_-N, Buckets), Total),
+    nocount_calls(loop/1).
+test(last_call, Counts == c(1000001,0,1000001,0)) :-
+    count_calls(loop/1, [latency(true)]),
+    thread_create(loop(1 000 000), Id, [stack_limit(10 000 000)]),
+    thread_join(Id, Status),
+    assertion(Status == true),
+    counts(loop/1, Counts),
+    nocount_calls(loop/1).
+test(disable, fail) :-
+    count_calls(det_p/1),
+    nocount_calls(det_p/1),
+    predicate_property(det_p(_), counted).
+test(prometheus, true) :-
+    count_calls(fact/1, [latency(true)]),
+    forall(fact(_), true),
+    with_output_to(string(S), write_call_counts(current_output)),
+    nocount_calls(fact/1),
+    assertion(sub_string(S, _, _, _,
+                         "prolog_predicate_redos_total{predicate=\"test_call_counts:fact/1\"} 2")),
+    assertion(sub_string(S, _, _, _,
+                         "prolog_predicate_latency_seconds_count{predicate=\"test_call_counts:fact/1\"} 3")).
+test(foreign, error(permission_error(_,_,_))) :-
+    count_calls(system:atom_length/2).
+
+:- end_tests(call_counts).
@@ -0,0 +1,136 @@
+/*  Part of SWI-Prolog
+
+    Author:        agent
+    E-mail:        agent@local
+    WWW:           http://www.swi-prolog.org
+    Copyright (c)  2026, agent
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in
+       the documentation and/or other materials provided with the
+       distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+
+:- module(test_sample_profile,
+          [ test_sample_profile/0
+          ]).
+:- use_module(library(plunit)).
+:- use_module(library(prolog_profile)).
+
+test_sample_profile :-
+    run_tests([ sample_profile,
+                alloc_profile
+              ]).
+
+sampler_supported :-
+    catch(sample_profile(true, [samples(_)]), error(_, _), fail).
+
+loop(0) :- !.
+loop(N) :- _ is N*N, N1 is N-1, loop(N1).
+
+:- begin_tests(sample_profile, [condition(sampler_supported)]).
+
+test(samples, Taken > 0) :-
+    sample_profile(loop(2 000 000),
+                   [ frequency(1000), time(wall), samples(S) ]),
+    get_dict(taken, S, Taken),
+    get_dict(stacks, S, Stacks),
+    assertion(Stacks = [_-_|_]).
+test(leaf_first, true) :-
+    sample_profile(loop(2 000 000),
+                   [ frequency(1000), time(wall), samples(S) ]),
+    get_dict(stacks, S, Stacks),
+    once(( member(Stack-_, Stacks),
+           memberchk(test_sample_profile:loop/1, Stack) )).
+test(folded, Lines \== []) :-
+    Samples = samples{time:cpu, period:1000, taken:3, dropped:0,
+                      stacks:[[user:b/0, user:a/0]-2, ['$garbage_collect']-1]},
+    with_output_to(string(S), write_folded_stacks(current_output, Samples)),
+    split_string(S, "\n", "", Lines0),
+    exclude(==(""), Lines0, Lines),
+    assertion(Lines == ["a/0;b/0 2", "$garbage_collect 1"]).
+test(pprof, Byte == 0x0a) :-
+    Samples = samples{time:cpu, period:1000, taken:2, dropped:0,
+                      stacks:[[user:b/0, user:a/0]-2]},
+    tmp_file_stream(binary, File, Out),
+    call_cleanup(write_pprof(Out, Samples), close(Out)),
+    setup_call_cleanup(
+        open(File, read, In, [type(binary)]),
+        get_byte(In, Byte),
+        close(In)),
+    delete_file(File).
+test(exception, error(type_error(evaluable, foo/0))) :-
+    sample_profile(_ is foo, [samples(_)]).
+test(fail, fail) :-
+    sample_profile(fail, [samples(_)]).
+
+:- end_tests(sample_profile).
+
+mk(0, []) :- !.
+mk(N, [f(N)|T]) :- N1 is N-1, mk(N1, T).
+
+keep(L) :- mk(100 000, L).
+waste :- mk(100 000, _), fail.
+waste.
+
+:- dynamic fact/1.
+
+assert_facts(0) :- !.
+assert_facts(N) :- assertz(fact(N)), N1 is N-1, assert_facts(N1).
+
+:- begin_tests(alloc_profile, [cleanup(retractall(fact(_)))]).
+
+test(global, Taken > 0) :-
+    alloc_profile(keep(_), [sample_bytes(4096), samples(S)]),
+    get_dict(taken, S, Taken),
+    get_dict(stacks, S, Stacks),
+    assertion(forall(member([PI|_]-_, Stacks),
+                     PI == test_sample_profile:mk/2)).
+test(survived, Survived > 0) :-
+    alloc_profile(keep(_), [sample_bytes(4096), samples(S)]),
+    get_dict(survival, S, Survival),
+    memberchk((test_sample_profile:mk/2)-survival(Survived, _), Survival).
+test(reclaimed, Reclaimed > 0) :-
+    alloc_profile(waste, [sample_bytes(4096), samples(S)]),
+    get_dict(survival, S, Survival),
+    memberchk((test_sample_profile:mk/2)-survival(_, Reclaimed), Survival).
+test(heap, Taken > 0) :-
+    alloc_profile(assert_facts(10 000),
+                  [space(heap), sample_bytes(4096), samples(S)]),
+    get_dict(taken, S, Taken),
+    get_dict(survival, S, Survival),
+    assertion(Survival == []).
+test(pprof, Byte == 0x0a) :-
+    alloc_profile(keep(_), [sample_bytes(4096), samples(Samples)]),
+    tmp_file_stream(binary, File, Out),
+    call_cleanup(write_pprof(Out, Samples), close(Out)),
+    setup_call_cleanup(
+        open(File, read, In, [type(binary)]),
+        get_byte(In, Byte),
+        close(In)),
+    delete_file(File).
+test(space, error(type_error(oneof([global,heap]), stack))) :-
+    alloc_profile(true, [space(stack)]).
+
+:- end_tests(alloc_profile).
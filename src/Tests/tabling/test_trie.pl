@@ -43,7 +43,8 @@
 :- use_module(library(debug)).
 
 test_trie :-
-	run_tests([ trie
+	run_tests([ trie,
+		    term_intern
 		  ]).
 
 :- begin_tests(trie).
@@ -150,3 +151,51 @@ test_var(X, Y) :-
 	trie_gen(T, f(X, Y)).
 
 :- end_tests(trie).
+
+:- begin_tests(term_intern).
+
+test(same, H1 == H2) :-
+	term_intern(f(a, "s", [1, 0.5, 100000000000000000000]), H1),
+	term_intern(f(a, "s", [1, 0.5, 100000000000000000000]), H2).
+test(different, H1 \== H2) :-
+	term_intern(f(a), H1),
+	term_intern(f(b), H2).
+test(term, T == f(a, "s", [1, 0.5])) :-
+	term_intern(f(a, "s", [1, 0.5]), H),
+	term_intern(T, H).
+test(gc, T == i(5)) :-
+	forall(between(1, 10000, I), term_intern(i(I), _)),
+	garbage_collect_atoms,
+	term_intern(i(5), H),
+	term_intern(T, H).
+test(nonground, error(instantiation_error)) :-
+	term_intern(f(_), _).
+test(handle, error(type_error(interned, aap))) :-
+	term_intern(_, aap).
+test(concurrent, [ condition(current_prolog_flag(threads, true)),
+		   Statuses == [true,true,true,true]
+		 ]) :-
+	thread_create(intern_agc_loop, AGC, []),
+	findall(Id, ( between(1, 4, _),
+		      thread_create(intern_loop(20 000), Id, [])
+		    ), Ids),
+	maplist(thread_join, Ids, Statuses),
+	thread_send_message(AGC, done),
+	thread_join(AGC, AGCStatus),
+	assertion(AGCStatus == true).
+
+intern_loop(N) :-
+	forall(between(1, N, I),
+	       ( K is I mod 50,
+		 term_intern(k(K, "s"), H),
+		 term_intern(T, H),
+		 T == k(K, "s")
+	       )).
+
+intern_agc_loop :-
+	repeat,
+	garbage_collect_atoms,
+	thread_peek_message(done),
+	!.
+
+:- end_tests(term_intern).
@@ -69,9 +69,66 @@ test(gc4, [sto(rational_trees)]) :-
 		     assertion(V == 1),
 		     engine_destroy(E)
 		   ), 100).
+test(idle_trim, [ Trims > Trims0,
+		 setup(set_prolog_flag(idle_trim_time, 0.05)),
+		 cleanup(set_prolog_flag(idle_trim_time, 0.0))
+	       ]) :-
+	statistics(idle_trims, Trims0),
+	engine_create(X, (numlist(1, 500 000, L), length(L, _), member(X, [a,b])), E),
+	engine_next(E, a),
+	wait_for_trims(Trims0, Trims),
+	engine_next(E, b),
+	engine_destroy(E).
+
+test(trim_destroy, [ Trims > Trims0,
+		    setup(set_prolog_flag(idle_trim_time, 0.01)),
+		    cleanup(set_prolog_flag(idle_trim_time, 0.0))
+		  ]) :-
+	statistics(idle_trims, Trims0),
+	forall(between(1, 10, I),
+	       ( findall(E,
+			 ( between(1, 5, _),
+			   engine_create(X, ( numlist(1, 200 000, L),
+					      length(L, _),
+					      member(X, [a,b])
+					    ), E),
+			   engine_next(E, _)
+			 ), Es),
+		 T is 0.005*I,
+		 sleep(T),
+		 maplist(engine_destroy, Es)
+	       )),
+	engine_create(Y, ( numlist(1, 200 000, L1),
+			   length(L1, _),
+			   member(Y, [a,b])
+			 ), E1),
+	engine_next(E1, a),
+	wait_for_trims(Trims0, Trims),
+	engine_destroy(E1).
 
 :- end_tests(engines).
 
+%!	wait_for_trims(+Trims0, -Trims) is det.
+%
+%	Wait until the idle_trims statistic exceeds Trims0 or 10 seconds
+%	have passed and unify Trims with its final value.
+
+wait_for_trims(Trims0, Trims) :-
+	get_time(Now),
+	Deadline is Now+10,
+	wait_for_trims(Trims0, Deadline, Trims).
+
+wait_for_trims(Trims0, Deadline, Trims) :-
+	statistics(idle_trims, Trims1),
+	(   Trims1 > Trims0
+	->  Trims = Trims1
+	;   get_time(Now),
+	    Now > Deadline
+	->  Trims = Trims1
+	;   sleep(0.01),
+	    wait_for_trims(Trims0, Deadline, Trims)
+	).
+
 
 :- meta_predicate e_findall(?, 0, -).
 
@@ -51,7 +51,10 @@ test_threads :-
 		    thread_property,
 		    mutex,
 		    mutex_property,
-		    message_queue
+		    message_queue,
+		    idle_trim,
+		    atom_table,
+		    atom_cache
 		  ]).
 
 
@@ -264,3 +267,142 @@ test(size_prop, true) :-
 	message_queue_destroy(Queue).
 
 :- end_tests(message_queue).
+
+
+		 /*******************************
+		 *	     IDLE TRIM		*
+		 *******************************/
+
+:- begin_tests(idle_trim,
+	       [ setup(set_prolog_flag(idle_trim_time, 0.05)),
+		 cleanup(set_prolog_flag(idle_trim_time, 0.0))
+	       ]).
+
+test(get_message, Trims > Trims0) :-
+	statistics(idle_trims, Trims0),
+	thread_create(idle_get(done), Id, []),
+	wait_for_trims(Trims0, Trims),
+	thread_send_message(Id, done),
+	thread_join(Id, Status),
+	assertion(Status == true).
+test(once, Trims == Trims1) :-
+	statistics(idle_trims, Trims0),
+	thread_create(idle_get(done), Id, []),
+	wait_for_trims(Trims0, Trims1),
+	sleep(0.3),
+	statistics(idle_trims, Trims),
+	thread_send_message(Id, done),
+	thread_join(Id, _).
+test(time, error(domain_error(not_less_than_zero, -1.0))) :-
+	set_prolog_flag(idle_trim_time, -1.0).
+
+idle_get(Msg) :-
+	numlist(1, 500 000, L),
+	length(L, _),
+	thread_get_message(Msg).
+
+%!	wait_for_trims(+Trims0, -Trims) is det.
+%
+%	Wait until the idle_trims statistic exceeds Trims0 or 10 seconds
+%	have passed and unify Trims with its final value.
+
+wait_for_trims(Trims0, Trims) :-
+	get_time(Now),
+	Deadline is Now+10,
+	wait_for_trims(Trims0, Deadline, Trims).
+
+wait_for_trims(Trims0, Deadline, Trims) :-
+	statistics(idle_trims, Trims1),
+	(   Trims1 > Trims0
+	->  Trims = Trims1
+	;   get_time(Now),
+	    Now > Deadline
+	->  Trims = Trims1
+	;   sleep(0.01),
+	    wait_for_trims(Trims0, Deadline, Trims)
+	).
+
+:- end_tests(idle_trim).
+
+
+		 /*******************************
+		 *	    ATOM TABLE		*
+		 *******************************/
+
+:- begin_tests(atom_table).
+
+test(statistics) :-
+	forall(member(Key, [ atom_table_resizes, atom_table_retries,
+			     functor_table_resizes, functor_table_retries
+			   ]),
+	       ( statistics(Key, Value),
+		 assertion((integer(Value), Value >= 0))
+	       )).
+% Threads race to create the same atoms and functors, resizing the
+% tables if they are too small.  Each atom must be created exactly once.
+test(concurrent_grow, Count == 50 000) :-
+	statistics(atom_table_resizes, R0),
+	statistics(functor_table_resizes, F0),
+	findall(Id, ( between(1, 4, _),
+		      thread_create(make_table_atoms(50 000), Id, [])
+		    ), Ids),
+	maplist(thread_join, Ids, Statuses),
+	assertion(maplist(==(true), Statuses)),
+	statistics(atom_table_resizes, R),
+	statistics(functor_table_resizes, F),
+	assertion(R >= R0),
+	assertion(F >= F0),
+	aggregate_all(count,
+		      ( current_atom(A),
+			sub_atom(A, 0, _, _, atom_table_),
+			sub_atom(A, 11, 1, _, D),
+			char_type(D, digit(_))
+		      ),
+		      Count).
+
+make_table_atoms(N) :-
+	forall(between(1, N, I),
+	       ( format(atom(A), 'atom_table_~d', [I]),
+		 functor(_, A, 1)		% the functor keeps the atom
+	       )).
+
+:- end_tests(atom_table).
+
+
+		 /*******************************
+		 *	    ATOM CACHE		*
+		 *******************************/
+
+:- begin_tests(atom_cache).
+
+% Atoms unregistered by a thread are kept in its atom cache.  AGC must
+% flush the caches of all threads, not only its own.
+
+test(agc_other_thread, Live < 10) :-
+	thread_self(Me),
+	thread_create(make_cached_atoms(Me), Id, []),
+	thread_get_message(ready),
+	garbage_collect_atoms,
+	cached_atom_count(Live),
+	thread_send_message(Id, done),
+	thread_join(Id, Status),
+	assertion(Status == true).
+
+make_cached_atoms(Parent) :-
+	forall(between(1, 100, I),
+	       ( format(atom(A), 'agc_cache_~d', [I]),
+		 atom_length(A, _)
+	       )),
+	thread_send_message(Parent, ready),
+	thread_get_message(done).
+
+cached_atom_count(Count) :-
+	aggregate_all(count,
+		      ( current_atom(A),
+			sub_atom(A, 0, _, _, agc_cache_),
+			sub_atom(A, 10, 1, _, D),
+			char_type(D, digit(_))
+		      ),
+		      Count).
+
+:- end_tests(atom_cache).
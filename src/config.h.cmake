@@ -146,6 +146,7 @@
 #cmakedefine HAVE_RINT @HAVE_RINT@
 #cmakedefine HAVE_RU_IDRSS @HAVE_RU_IDRSS@
 #cmakedefine HAVE_SCHED_SETAFFINITY @HAVE_SCHED_SETAFFINITY@
+#cmakedefine HAVE_SCHED_YIELD @HAVE_SCHED_YIELD@
 #cmakedefine HAVE_SC_NPROCESSORS_CONF @HAVE_SC_NPROCESSORS_CONF@
 #cmakedefine HAVE_SELECT @HAVE_SELECT@
 #cmakedefine HAVE_SEMA_INIT @HAVE_SEMA_INIT@
@@ -207,6 +208,7 @@
 #cmakedefine HAVE_TCSETATTR @HAVE_TCSETATTR@
 #cmakedefine HAVE_TERM_H @HAVE_TERM_H@
 #cmakedefine HAVE_TGETENT @HAVE_TGETENT@
+#cmakedefine HAVE_TIMER_CREATE @HAVE_TIMER_CREATE@
 #cmakedefine HAVE_TIMES @HAVE_TIMES@
 #cmakedefine HAVE_UNISTD_H @HAVE_UNISTD_H@
 #cmakedefine HAVE_UNSETENV @HAVE_UNSETENV@
@@ -301,6 +303,7 @@
 #cmakedefine HAVE_TCMALLOC_EXTENSION_C_H @HAVE_TCMALLOC_EXTENSION_C_H@
 #cmakedefine O_STATIC_EXTENSIONS @O_STATIC_EXTENSIONS@
 #cmakedefine HAVE___BUILTIN_MUL_OVERFLOW @HAVE___BUILTIN_MUL_OVERFLOW@
+#cmakedefine HAVE_TARGET_CLONES @HAVE_TARGET_CLONES@
 #cmakedefine O_GMP @O_GMP@
 #cmakedefine O_BF @O_BF@
 
@@ -0,0 +1,557 @@
+/*  Part of SWI-Prolog
+
+    Author:        agent
+    E-mail:        agent@local
+    WWW:           http://www.swi-prolog.org
+    Copyright (c)  2026, agent
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in
+       the documentation and/or other materials provided with the
+       distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+
+    The code in this file re-implements Ryu by Ulf Adams
+    (https://github.com/ulfjack/ryu, Apache License 2.0 or Boost
+    Software License 1.0) and the Eisel-Lemire algorithm as implemented
+    in fast_float by Daniel Lemire et al.
+    (https://github.com/fastfloat/fast_float, Apache License 2.0, MIT
+    or Boost Software License 1.0).
+*/
+
+#include "pl-incl.h"
+#include "pl-fltconv.h"
+#include <float.h>
+
+/* - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Fast conversion between  doubles  and   their  decimal  representation.
+These routines are used for the  common   cases  and  do not allocate
+memory or lock. Other cases are still handled by dtoa.c.
+
+  - float_shortest() computes the shortest digit string that reads back
+    as the same double using the Ryu algorithm by Ulf Adams ("Ryu: fast
+    float-to-string conversion", PLDI 2018).
+
+  - fast_strtod() reads a decimal float using the fast path by Clinger
+    if possible and the Eisel-Lemire algorithm otherwise (Daniel Lemire,
+    "Number Parsing at a Gigabyte per Second", 2021).  It fails if the
+    number has more than 19 significant digits, the result is denormal
+    or out of range or the algorithm cannot decide on the rounding.  The
+    caller must use strtod() in that case.
+
+The tables are generated using the Python code below.
+
+    def ryu_inv(i):			# ryu_pow5_inv_split, 0..341
+      p = 5**i
+      return (1 << (p.bit_length()-1+125)) // p + 1
+    def ryu_pow(i):			# ryu_pow5_split, 0..325
+      p = 5**i
+      s = p.bit_length()-125
+      return p >> s if s >= 0 else p << -s
+    def el_pow(q):			# el_pow5_128, -342..308
+      if q < 0:
+        p = 5**-q
+        z = p.bit_length()
+        c = 2**(z+127 if q >= -27 else 2*z+128) // p + 1
+        while c >= 1<<128: c //= 2
+        return c
+      p = 5**q
+      while p < 1<<127: p *= 2
+      while p >= 1<<128: p //= 2
+      return p
+- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
+#define DOUBLE_MANTISSA_BITS	52
+#define DOUBLE_EXPONENT_BITS	11
+#define DOUBLE_BIAS		1023
+
+#define POW5_INV_BITCOUNT	125
+#define POW5_BITCOUNT		125
+
+#define EL_SMALLEST_POWER	(-342)
+#define EL_LARGEST_POWER	308
+
+#include "pl-fltconv-tables.h"
+
+static inline uint64_t
+umul128(uint64_t a, uint64_t b, uint64_t *hi)
+{
+#ifdef HAVE_INT128
+  unsigned __int128 r = (unsigned __int128)a * b;
+
+  *hi = (uint64_t)(r>>64);
+  return (uint64_t)r;
+#else
+  uint64_t ha = a>>32, hb = b>>32, la = (uint32_t)a, lb = (uint32_t)b;
+  uint64_t rh = ha*hb, rm0 = ha*lb, rm1 = hb*la, rl = la*lb;
+  uint64_t t = rl+(rm0<<32), c = t<rl;
+  uint64_t lo = t+(rm1<<32);
+
+  c += lo<t;
+  *hi = rh+(rm0>>32)+(rm1>>32)+c;
+  return lo;
+#endif
+}
+
+static inline uint64_t
+double_bits(double f)
+{ uint64_t bits;
+
+  memcpy(&bits, &f, sizeof(bits));
+  return bits;
+}
+
+static inline double
+bits_double(uint64_t bits)
+{ double f;
+
+  memcpy(&f, &bits, sizeof(f));
+  return f;
+}
+
+
+		 /*******************************
+		 *	 DOUBLE TO DIGITS	*
+		 *******************************/
+
+static inline int32_t
+pow5bits(int32_t e)			/* ceil(log2(5^e)) for e in [0,3528] */
+{ return (int32_t)((((uint32_t)e) * 1217359) >> 19) + 1;
+}
+
+static inline uint32_t
+log10Pow2(int32_t e)			/* floor(log10(2^e)) for e in [0,1650] */
+{ return (((uint32_t)e) * 78913) >> 18;
+}
+
+static inline uint32_t
+log10Pow5(int32_t e)			/* floor(log10(5^e)) for e in [0,2620] */
+{ return (((uint32_t)e) * 732923) >> 20;
+}
+
+static inline int
+pow5Factor(uint64_t value)
+{ int count = 0;
+
+  for(;;)
+  { uint64_t q = value/5;
+
+    if ( value - 5*q != 0 )
+      return count;
+    value = q;
+    count++;
+  }
+}
+
+static inline int
+multipleOfPowerOf5(uint64_t value, uint32_t p)
+{ return pow5Factor(value) >= (int)p;
+}
+
+static inline int
+multipleOfPowerOf2(uint64_t value, uint32_t p)
+{ return (value & ((UINT64_C(1) << p) - 1)) == 0;
+}
+
+static inline uint64_t
+mulShift64(uint64_t m, const uint64_t *mul, int32_t j)
+{ uint64_t high0, high1, low1, sum;
+  int dist = j-64;			/* 0 < dist < 64 */
+
+  low1 = umul128(m, mul[1], &high1);
+  (void)umul128(m, mul[0], &high0);
+  sum = high0 + low1;
+  if ( sum < high0 )
+    high1++;
+
+  return (high1 << (64-dist)) | (sum >> dist);
+}
+
+static int
+decimalLength17(uint64_t v)
+{ int len = 1;
+
+  while( v >= 10 )
+  { v /= 10;
+    len++;
+  }
+
+  return len;
+}
+
+/* - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+float_shortest() stores the shortest digit string  for the finite double
+|f|, without trailing zeros, in digits  and   the  position  of the dot
+relative to the digits in decpt, i.e., the value is 0.<digits> * 10^decpt.
+This is the same as dtoa() in mode 0. Returns the number of digits.
+- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
+int
+float_shortest(double f, char *digits, int *decpt)
+{ uint64_t bits = double_bits(f);
+  uint64_t ieeeMantissa = bits & ((UINT64_C(1) << DOUBLE_MANTISSA_BITS) - 1);
+  uint32_t ieeeExponent = (uint32_t)((bits >> DOUBLE_MANTISSA_BITS) &
+				     ((1u << DOUBLE_EXPONENT_BITS) - 1));
+  int32_t e2;
+  uint64_t m2, mv, vr, vp, vm, output;
+  int32_t e10;
+  int mmShift, acceptBounds;
+  int vmIsTrailingZeros = FALSE, vrIsTrailingZeros = FALSE;
+  int removed = 0;
+  uint8_t lastRemovedDigit = 0;
+  int len, i;
+
+  if ( ieeeExponent == 0 && ieeeMantissa == 0 )
+  { digits[0] = '0';
+    digits[1] = EOS;
+    *decpt = 1;
+    return 1;
+  }
+
+  if ( ieeeExponent == 0 )
+  { e2 = 1 - DOUBLE_BIAS - DOUBLE_MANTISSA_BITS - 2;
+    m2 = ieeeMantissa;
+  } else
+  { e2 = (int32_t)ieeeExponent - DOUBLE_BIAS - DOUBLE_MANTISSA_BITS - 2;
+    m2 = (UINT64_C(1) << DOUBLE_MANTISSA_BITS) | ieeeMantissa;
+  }
+  acceptBounds = (m2 & 1) == 0;
+					/* Step 2: interval of valid values */
+  mv = 4 * m2;
+  mmShift = (ieeeMantissa != 0 || ieeeExponent <= 1);
+
+					/* Step 3: convert to decimal power */
+  if ( e2 >= 0 )
+  { uint32_t q = log10Pow2(e2) - (e2 > 3);
+    int32_t k = POW5_INV_BITCOUNT + pow5bits((int32_t)q) - 1;
+    int32_t j = -e2 + (int32_t)q + k;
+
+    e10 = (int32_t)q;
+    vr = mulShift64(4*m2,            ryu_pow5_inv_split[q], j);
+    vp = mulShift64(4*m2 + 2,        ryu_pow5_inv_split[q], j);
+    vm = mulShift64(4*m2 - 1 - mmShift, ryu_pow5_inv_split[q], j);
+    if ( q <= 21 )
+    { uint32_t mvMod5 = (uint32_t)(mv - 5*(mv/5));
+
+      if ( mvMod5 == 0 )
+	vrIsTrailingZeros = multipleOfPowerOf5(mv, q);
+      else if ( acceptBounds )
+	vmIsTrailingZeros = multipleOfPowerOf5(mv - 1 - mmShift, q);
+      else
+	vp -= multipleOfPowerOf5(mv + 2, q);
+    }
+  } else
+  { uint32_t q = log10Pow5(-e2) - (-e2 > 1);
+    int32_t i = -e2 - (int32_t)q;
+    int32_t k = pow5bits(i) - POW5_BITCOUNT;
+    int32_t j = (int32_t)q - k;
+
+    e10 = (int32_t)q + e2;
+    vr = mulShift64(4*m2,            ryu_pow5_split[i], j);
+    vp = mulShift64(4*m2 + 2,        ryu_pow5_split[i], j);
+    vm = mulShift64(4*m2 - 1 - mmShift, ryu_pow5_split[i], j);
+    if ( q <= 1 )
+    { vrIsTrailingZeros = TRUE;
+      if ( acceptBounds )
+	vmIsTrailingZeros = (mmShift == 1);
+      else
+	--vp;
+    } else if ( q < 63 )
+    { vrIsTrailingZeros = multipleOfPowerOf2(mv, q);
+    }
+  }
+
+					/* Step 4: find shortest representation */
+  if ( vmIsTrailingZeros || vrIsTrailingZeros )
+  { for(;;)				/* general case (rare) */
+    { uint64_t vpDiv10 = vp/10;
+      uint64_t vmDiv10 = vm/10;
+      uint32_t vmMod10, vrMod10;
+      uint64_t vrDiv10;
+
+      if ( vpDiv10 <= vmDiv10 )
+	break;
+      vmMod10 = (uint32_t)(vm - 10*vmDiv10);
+      vrDiv10 = vr/10;
+      vrMod10 = (uint32_t)(vr - 10*vrDiv10);
+      vmIsTrailingZeros &= (vmMod10 == 0);
+      vrIsTrailingZeros &= (lastRemovedDigit == 0);
+      lastRemovedDigit = (uint8_t)vrMod10;
+      vr = vrDiv10;
+      vp = vpDiv10;
+      vm = vmDiv10;
+      removed++;
+    }
+    if ( vmIsTrailingZeros )
+    { for(;;)
+      { uint64_t vmDiv10 = vm/10;
+	uint32_t vmMod10 = (uint32_t)(vm - 10*vmDiv10);
+	uint64_t vpDiv10, vrDiv10;
+	uint32_t vrMod10;
+
+	if ( vmMod10 != 0 )
+	  break;
+	vpDiv10 = vp/10;
+	vrDiv10 = vr/10;
+	vrMod10 = (uint32_t)(vr - 10*vrDiv10);
+	vrIsTrailingZeros &= (lastRemovedDigit == 0);
+	lastRemovedDigit = (uint8_t)vrMod10;
+	vr = vrDiv10;
+	vp = vpDiv10;
+	vm = vmDiv10;
+	removed++;
+      }
+    }
+    if ( vrIsTrailingZeros && lastRemovedDigit == 5 && vr % 2 == 0 )
+      lastRemovedDigit = 4;		/* round even */
+    output = vr + ((vr == vm && (!acceptBounds || !vmIsTrailingZeros)) ||
+		   lastRemovedDigit >= 5);
+  } else				/* common case */
+  { int roundUp = FALSE;
+    uint64_t vpDiv100 = vp/100;
+    uint64_t vmDiv100 = vm/100;
+
+    if ( vpDiv100 > vmDiv100 )
+    { uint64_t vrDiv100 = vr/100;
+      uint32_t vrMod100 = (uint32_t)(vr - 100*vrDiv100);
+
+      roundUp = vrMod100 >= 50;
+      vr = vrDiv100;
+      vp = vpDiv100;
+      vm = vmDiv100;
+      removed += 2;
+    }
+    for(;;)
+    { uint64_t vpDiv10 = vp/10;
+      uint64_t vmDiv10 = vm/10;
+      uint64_t vrDiv10;
+      uint32_t vrMod10;
+
+      if ( vpDiv10 <= vmDiv10 )
+	break;
+      vrDiv10 = vr/10;
+      vrMod10 = (uint32_t)(vr - 10*vrDiv10);
+      roundUp = vrMod10 >= 5;
+      vr = vrDiv10;
+      vp = vpDiv10;
+      vm = vmDiv10;
+      removed++;
+    }
+    output = vr + (vr == vm || roundUp);
+  }
+  e10 += removed;
+
+  while ( output % 10 == 0 )		/* dtoa() has no trailing zeros */
+  { output /= 10;
+    e10++;
+  }
+
+  len = decimalLength17(output);
+  for(i=len-1; i >= 0; i--)
+  { digits[i] = (char)('0' + output%10);
+    output /= 10;
+  }
+  digits[len] = EOS;
+  *decpt = e10 + len;
+
+  return len;
+}
+
+
+		 /*******************************
+		 *	 DIGITS TO DOUBLE	*
+		 *******************************/
+
+static const double exact_pow10[] =
+{ 1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+  1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+static inline int
+leading_zeros64(uint64_t v)		/* v != 0 */
+{
+#if defined(__GNUC__) && SIZEOF_LONG == 8
+  return __builtin_clzl(v);
+#elif defined(__GNUC__)
+  return __builtin_clzll(v);
+#else
+  int n = 0;
+
+  while( !(v & (UINT64_C(1)<<63)) )
+  { v <<= 1;
+    n++;
+  }
+  return n;
+#endif
+}
+
+/* - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+eisel_lemire() computes w*10^q as a double  or returns FALSE if it cannot
+decide.
+- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
+static int
+eisel_lemire(uint64_t w, int q, int neg, double *dp)
+{ const uint64_t *pow5;
+  int64_t exponent;
+  int lz, upperbit;
+  uint64_t lower, upper, mantissa;
+
+  if ( q < EL_SMALLEST_POWER || q > EL_LARGEST_POWER )
+    return FALSE;
+  pow5 = el_pow5_128[q-EL_SMALLEST_POWER];
+
+  exponent = (((152170 + 65536) * (int64_t)q) >> 16) + 63;
+  lz = leading_zeros64(w);
+  w <<= lz;
+
+  lower = umul128(w, pow5[0], &upper);
+  if ( (upper & 0x1FF) == 0x1FF && lower + w < lower )
+  { uint64_t shi;
+
+    (void)umul128(w, pow5[1], &shi);
+    lower += shi;
+    if ( lower < shi )
+      upper++;
+    if ( (upper & 0x1FF) == 0x1FF && lower + w < lower )
+      return FALSE;			/* cannot decide */
+  }
+
+  upperbit = (int)(upper >> 63);
+  mantissa = upper >> (upperbit + 9);
+  lz += 1 ^ upperbit;
+
+  if ( lower == 0 && (upper & 0x1FF) == 0 && (mantissa & 3) == 1 )
+    return FALSE;			/* possible tie */
+
+  mantissa += mantissa & 1;		/* round */
+  mantissa >>= 1;
+  if ( mantissa >= (UINT64_C(2) << DOUBLE_MANTISSA_BITS) )
+  { mantissa = (UINT64_C(1) << DOUBLE_MANTISSA_BITS);
+    lz--;
+  }
+  mantissa &= ~(UINT64_C(1) << DOUBLE_MANTISSA_BITS);
+  exponent = exponent - lz + DOUBLE_BIAS + 1;
+  if ( exponent < 1 || exponent > 2046 )
+    return FALSE;			/* denormal or overflow */
+
+  mantissa |= (uint64_t)exponent << DOUBLE_MANTISSA_BITS;
+  if ( neg )
+    mantissa |= UINT64_C(1) << 63;
+  *dp = bits_double(mantissa);
+
+  return TRUE;
+}
+
+
+/* - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+fast_strtod() converts  the  ASCII  text   [s,e)  holding  [+-]digits,
+optionally followed by .digits and  an   exponent.  Returns  FALSE if
+the text is not in this format or the  conversion is not handled, after
+which the caller must use strtod().
+- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
+#define MAX_SIG_DIGITS 19
+#define isdigit_a(c) ((c) >= '0' && (c) <= '9')
+
+int
+fast_strtod(const char *s, const char *e, double *dp)
+{ int neg = FALSE;
+  uint64_t w = 0;
+  int ndigits = 0;
+  int q = 0;
+  const char *ds;
+
+  if ( s < e && (*s == '-' || *s == '+') )
+    neg = (*s++ == '-');
+
+  for(ds=s; s < e && isdigit_a(*s); s++)
+  { int d = *s - '0';
+
+    if ( ndigits < MAX_SIG_DIGITS )
+    { w = w*10 + d;
+      if ( w )
+	ndigits++;
+    } else if ( d == 0 )
+    { q++;
+    } else
+    { return FALSE;
+    }
+  }
+  if ( s == ds )
+    return FALSE;
+  if ( s < e && *s == '.' )
+  { for(ds=++s; s < e && isdigit_a(*s); s++)
+    { int d = *s - '0';
+
+      if ( ndigits < MAX_SIG_DIGITS )
+      { w = w*10 + d;
+	q--;
+	if ( w )
+	  ndigits++;
+      } else if ( d != 0 )
+      { return FALSE;
+      }
+    }
+    if ( s == ds )
+      return FALSE;
+  }
+  if ( s < e && (*s == 'e' || *s == 'E') )
+  { int eneg = FALSE;
+    int exp = 0;
+
+    s++;
+    if ( s < e && (*s == '-' || *s == '+') )
+      eneg = (*s++ == '-');
+    for(ds=s; s < e && isdigit_a(*s); s++)
+    { if ( exp > 100000 )
+	return FALSE;
+      exp = exp*10 + (*s - '0');
+    }
+    if ( s == ds )
+      return FALSE;
+    q += eneg ? -exp : exp;
+  }
+  if ( s != e )
+    return FALSE;
+
+  if ( w == 0 )
+  { *dp = neg ? -0.0 : 0.0;
+    return TRUE;
+  }
+
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0
+  if ( w <= (UINT64_C(1) << 53) && q >= -22 && q <= 22 )
+  { double d = (double)w;			/* Clinger's fast path */
+
+    if ( q < 0 )
+      d /= exact_pow10[-q];
+    else
+      d *= exact_pow10[q];
+    *dp = neg ? -d : d;
+    return TRUE;
+  }
+#endif
+
+  return eisel_lemire(w, q, neg, dp);
+}
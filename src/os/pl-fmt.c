@@ -77,6 +77,46 @@ typedef struct
   struct rubber rub[MAXRUBBER];
 } format_state;
 
+/* - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+A format text is first compiled  into  a   sequence  of  directives. A
+directive is either a literal run of  text   or  a ~ directive with its
+numeric argument and colon modifier. Whether  the directive refers to a
+user defined format predicate is  decided   when  executing it, so that
+format_predicate/2 also affects compiled templates.
+
+Templates are created explicitly  using   format_compile/2.  Atoms used
+as format are compiled implicitly and  kept   in  a  small per-thread
+cache, so a program that repeatedly   uses  the same format atom parses
+it only once.
+- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
+#define FMT_LITERAL	(-1)		/* directive is a literal run */
+#define FMT_STAR	(-2)		/* ~*c: argument is in the list */
+
+typedef struct fmt_directive
+{ int		code;			/* directive character or FMT_LITERAL */
+  int		arg;			/* numeric argument */
+  int		colon;			/* ~:c modifier */
+  int		ascii;			/* FMT_LITERAL: printable ASCII */
+  size_t	start;			/* FMT_LITERAL: start in text */
+  size_t	length;			/* FMT_LITERAL: # characters */
+} fmt_directive;
+
+typedef struct format_template
+{ PL_chars_t	text;			/* format text (BUF_MALLOC) */
+  size_t	count;			/* # directives */
+  fmt_directive *directives;		/* the directives */
+  int		busy;			/* executing (cached templates) */
+} format_template;
+
+#define FMT_CACHE_SIZE	 32		/* # cached atoms (power of 2) */
+#define FMT_CACHE_MAXLEN 1024		/* only cache shorter formats */
+
+typedef struct format_cache
+{ atom_t		format[FMT_CACHE_SIZE];	/* cached atom */
+  format_template      *compiled[FMT_CACHE_SIZE]; /* its template */
+} format_cache;
+
 #define BUFSIZE		1024
 #define DEFAULT		(-1)
 #define SHIFT		{ argc--; argv++; }
@@ -168,6 +208,43 @@ outstring(format_state *state, const char *s, size_t len)
 }
 
 
+/* - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Emit a literal run of printable ASCII characters from the format. If no
+rubber is pending and the run fits  in   the  buffer  of a stream whose
+encoding is ASCII compatible, copy it   directly  into the buffer. As
+the run has no control characters, updating the position is trivial.
+- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
+static WUNUSED int
+outascii(format_state *state, const char *s, size_t len)
+{ IOSTREAM *fd = state->out;
+
+  if ( !state->pending_rubber && fd->buffer && !fd->tee &&
+       (size_t)(fd->limitp - fd->bufp) >= len )
+  { switch(fd->encoding)
+    { case ENC_OCTET:
+      case ENC_ASCII:
+      case ENC_ISO_LATIN_1:
+      case ENC_UTF8:
+	memcpy(fd->bufp, s, len);
+	fd->bufp += len;
+	if ( fd->position )
+	{ fd->position->byteno  += len;
+	  fd->position->charno  += len;
+	  fd->position->linepos += (int)len;
+	}
+	fd->lastc = s[len-1]&0xff;
+	state->column += (int)len;
+	return TRUE;
+      default:
+	break;
+    }
+  }
+
+  return outstring(state, s, len);
+}
+
+
 static WUNUSED int
 oututf8(format_state *state, const char *s, size_t len)
 { const char *e = &s[len];
@@ -220,8 +297,13 @@ outtext(format_state *state, PL_chars_t *txt)
 #define format_predicates (GD->format.predicates)
 
 static int	update_column(int, Char);
-static bool	do_format(IOSTREAM *fd, PL_chars_t *fmt,
+static bool	do_format(IOSTREAM *fd, format_template *fmt,
 			  int ac, term_t av, Module m);
+static bool	compile_format(PL_chars_t *fmt, format_template *t,
+			       TmpBuffer b);
+#define cached_format(a) LDFUNC(cached_format, a)
+static format_template *cached_format(DECL_LD atom_t a);
+static bool	get_format_template(term_t t, format_template **tp);
 static void	distribute_rubber(struct rubber *, int, int);
 static WUNUSED int emit_rubber(format_state *state);
 
@@ -307,10 +389,37 @@ format_impl(IOSTREAM *out, term_t format, term_t Args, Module m)
   int argc = 0;
   term_t args = PL_copy_term_ref(Args);
   int rval;
-  PL_chars_t fmt;
+  atom_t a;
+  format_template *tmpl = NULL;
+  format_template local;
+  tmp_buffer directives;
+  int cached = FALSE;
+
+  if ( PL_get_atom(format, &a) && (tmpl=cached_format(a)) )
+  { cached = TRUE;
+  } else if ( !get_format_template(format, &tmpl) )
+  { PL_chars_t fmt;
+
+    if ( !PL_get_text(format, &fmt, CVT_ATOM|CVT_STRING|CVT_LIST|BUF_STACK) )
+      return PL_error("format", 3, NULL, ERR_TYPE, ATOM_text, format);
+
+    switch(fmt.storage)			/* format can do call-back! */
+    { case PL_CHARS_RING:
+      case PL_CHARS_STACK:
+	PL_save_text(&fmt, BUF_MALLOC);
+	break;
+      default:
+	break;
+    }
 
-  if ( !PL_get_text(format, &fmt, CVT_ATOM|CVT_STRING|CVT_LIST|BUF_STACK) )
-    return PL_error("format", 3, NULL, ERR_TYPE, ATOM_text, format);
+    initBuffer(&directives);
+    if ( !compile_format(&fmt, &local, &directives) )
+    { discardBuffer(&directives);
+      PL_free_text(&fmt);
+      return FALSE;
+    }
+    tmpl = &local;
+  }
 
   if ( (argc = (int)lengthList(args, FALSE)) >= 0 )
   { term_t head = PL_new_term_ref();
@@ -326,19 +435,17 @@ format_impl(IOSTREAM *out, term_t format, term_t Args, Module m)
     PL_put_term(argv, args);
   }
 
-  switch(fmt.storage)			/* format can do call-back! */
-  { case PL_CHARS_RING:
-    case PL_CHARS_STACK:
-      PL_save_text(&fmt, BUF_MALLOC);
-      break;
-    default:
-      break;
-  }
-
   Slock(out);
-  rval = do_format(out, &fmt, argc, argv, m);
+  if ( cached )
+    tmpl->busy++;
+  rval = do_format(out, tmpl, argc, argv, m);
+  if ( cached )
+    tmpl->busy--;
   Sunlock(out);
-  PL_free_text(&fmt);
+  if ( tmpl == &local )
+  { discardBuffer(&directives);
+    PL_free_text(&local.text);
+  }
 
   return rval;
 }
@@ -373,8 +480,11 @@ pl_format(term_t fmt, term_t args)
 
 
 static inline int
-get_chr_from_text(const PL_chars_t *t, int index)
-{ switch(t->encoding)
+get_chr_from_text(const PL_chars_t *t, size_t index)
+{ if ( index >= t->length )		/* e.g., a trailing ~ */
+    return 0;
+
+  switch(t->encoding)
   { case ENC_ISO_LATIN_1:
       return t->text.t[index]&0xff;
     case ENC_WCHAR:
@@ -386,6 +496,284 @@ get_chr_from_text(const PL_chars_t *t, int index)
 }
 
 
+		 /*******************************
+		 *          TEMPLATES		*
+		 *******************************/
+
+static void
+add_literal(PL_chars_t *fmt, TmpBuffer b, size_t start, size_t end)
+{ if ( end > start )
+  { fmt_directive d;
+    size_t i;
+
+    d.code   = FMT_LITERAL;
+    d.arg    = DEFAULT;
+    d.colon  = FALSE;
+    d.ascii  = (fmt->encoding == ENC_ISO_LATIN_1);
+    for(i=start; d.ascii && i<end; i++)
+    { int c = get_chr_from_text(fmt, i);
+
+      if ( c < ' ' || c > '~' )
+	d.ascii = FALSE;
+    }
+    d.start  = start;
+    d.length = end-start;
+    addBuffer(b, d, fmt_directive);
+  }
+}
+
+
+/* - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+compile_format() parses fmt into  directives  that   are  added  to  b.
+On success, t->directives points into   b,  t->text is a shallow copy of
+fmt and t->busy is 0. The only syntax   error detected here is numeric
+argument overflow. Unknown directives and   missing arguments are only
+reported when the template is executed.
+- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
+static bool
+compile_format(PL_chars_t *fmt, format_template *t, TmpBuffer b)
+{ size_t here = 0;
+  size_t lstart = 0;
+
+  while(here < fmt->length)
+  { int c = get_chr_from_text(fmt, here);
+
+    if ( c == '~' )
+    { fmt_directive d;
+
+      add_literal(fmt, b, lstart, here);
+      d.arg    = DEFAULT;
+      d.colon  = FALSE;
+      d.ascii  = FALSE;
+      d.start  = here;
+      c = get_chr_from_text(fmt, ++here);
+
+      if ( isDigitW(c) )
+      { int arg = c - '0';
+
+	here++;
+	while(here < fmt->length)
+	{ c = get_chr_from_text(fmt, here);
+
+	  if ( isDigitW(c) )
+	  { int dw = c - '0';
+	    int arg2 = arg*10 + dw;
+
+	    if ( (arg2 - dw)/10 != arg )	/* see mul64() in pl-arith.c */
+	    { FMT_ERROR("argument overflow");
+	    }
+	    arg = arg2;
+	    here++;
+	  } else
+	    break;
+	}
+	d.arg = arg;
+      } else if ( c == '*' )
+      { d.arg = FMT_STAR;
+	c = get_chr_from_text(fmt, ++here);
+      } else if ( c == '`' )
+      { d.arg = get_chr_from_text(fmt, ++here);
+	c = get_chr_from_text(fmt, ++here);
+      }
+
+      if ( c == ':' )
+      { d.colon = TRUE;
+	c = get_chr_from_text(fmt, ++here);
+      }
+
+      d.code   = c;
+      d.length = ++here - d.start;
+      addBuffer(b, d, fmt_directive);
+      lstart = here;
+    } else
+    { here++;
+    }
+  }
+  add_literal(fmt, b, lstart, fmt->length);
+
+  t->text       = *fmt;
+  if ( fmt->storage == PL_CHARS_LOCAL )
+    t->text.text.t = t->text.buf;
+  t->count      = entriesBuffer(b, fmt_directive);
+  t->directives = baseBuffer(b, fmt_directive);
+  t->busy       = 0;
+
+  return TRUE;
+}
+
+
+static format_template *
+new_format_template(PL_chars_t *fmt)
+{ tmp_buffer b;
+  format_template *t;
+  size_t size;
+
+  initBuffer(&b);
+  t = allocHeapOrHalt(sizeof(*t));
+  if ( !compile_format(fmt, t, &b) )
+  { discardBuffer(&b);
+    freeHeap(t, sizeof(*t));
+    return NULL;
+  }
+
+  size = t->count*sizeof(fmt_directive);
+  t->directives = allocHeapOrHalt(size);
+  if ( !PL_save_text(&t->text, BUF_MALLOC) )
+  { discardBuffer(&b);
+    freeHeap(t->directives, size);
+    freeHeap(t, sizeof(*t));
+    PL_no_memory();
+    return NULL;
+  }
+  memcpy(t->directives, baseBuffer(&b, fmt_directive), size);
+  discardBuffer(&b);
+
+  return t;
+}
+
+
+static void
+free_format_template(format_template *t)
+{ PL_free_text(&t->text);
+  freeHeap(t->directives, t->count*sizeof(fmt_directive));
+  freeHeap(t, sizeof(*t));
+}
+
+
+/* - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+cached_format() returns the compiled  template  for   the  format  atom a
+from the per-thread cache,  compiling  it   if  needed.  The  cache is
+direct-mapped on the atom index. Cached  atoms are registered such that
+atom-GC cannot reuse their handle for a  different text. A slot is not
+replaced while its template is running,   which may happen if format/2
+is called recursively from ~p, ~@, etc. Returns NULL if the atom cannot
+be cached, after which the caller compiles it as a normal text.
+- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
+static format_template *
+cached_format(DECL_LD atom_t a)
+{ format_cache *cache = LD->format.cache;
+  unsigned int i = (unsigned int)(indexAtom(a) & (FMT_CACHE_SIZE-1));
+  format_template *t;
+  PL_chars_t fmt;
+
+  if ( cache && cache->format[i] == a )
+    return cache->compiled[i];
+
+  if ( !cache )
+  { cache = allocHeapOrHalt(sizeof(*cache));
+    memset(cache, 0, sizeof(*cache));
+    LD->format.cache = cache;
+  }
+  if ( cache->compiled[i] && cache->compiled[i]->busy )
+    return NULL;
+
+  if ( !get_atom_text(a, &fmt) || fmt.length > FMT_CACHE_MAXLEN )
+    return NULL;
+  if ( !(t=new_format_template(&fmt)) )
+  { PL_clear_exception();		/* handled by the caller */
+    return NULL;
+  }
+
+  if ( cache->compiled[i] )
+  { free_format_template(cache->compiled[i]);
+    PL_unregister_atom(cache->format[i]);
+  }
+  PL_register_atom(a);
+  cache->format[i]   = a;
+  cache->compiled[i] = t;
+
+  return t;
+}
+
+
+void
+freeFormatCache(PL_local_data_t *ld)
+{ format_cache *cache = ld->format.cache;
+
+  if ( cache )
+  { int i;
+
+    ld->format.cache = NULL;
+    for(i=0; i<FMT_CACHE_SIZE; i++)
+    { if ( cache->compiled[i] )
+      { free_format_template(cache->compiled[i]);
+	PL_unregister_atom(cache->format[i]);
+      }
+    }
+    freeHeap(cache, sizeof(*cache));
+  }
+}
+
+
+typedef struct format_template_ref
+{ format_template *tmpl;
+} format_template_ref;
+
+static int
+write_format_template(IOSTREAM *s, atom_t aref, int flags)
+{ format_template_ref *ref = PL_blob_data(aref, NULL, NULL);
+  (void)flags;
+
+  Sfprintf(s, "<format_template>(%p)", ref->tmpl);
+  return TRUE;
+}
+
+static int
+release_format_template(atom_t aref)
+{ format_template_ref *ref = PL_blob_data(aref, NULL, NULL);
+
+  free_format_template(ref->tmpl);
+  return TRUE;
+}
+
+static PL_blob_t format_template_blob =
+{ PL_BLOB_MAGIC,
+  PL_BLOB_UNIQUE,
+  "format_template",
+  release_format_template,
+  NULL,
+  write_format_template
+};
+
+static bool
+get_format_template(term_t t, format_template **tp)
+{ void *data;
+  PL_blob_t *type;
+
+  if ( PL_get_blob(t, &data, NULL, &type) && type == &format_template_blob )
+  { *tp = ((format_template_ref*)data)->tmpl;
+    return TRUE;
+  }
+
+  return FALSE;
+}
+
+
+/** format_compile(+Format, -Template) is det.
+ *
+ * Compile Format into a blob that may be  passed as format to format/2
+ * and format/3.
+ */
+
+static
+PRED_IMPL("format_compile", 2, format_compile, 0)
+{ PL_chars_t fmt;
+  format_template_ref ref;
+
+  if ( !PL_get_text(A1, &fmt, CVT_ATOM|CVT_STRING|CVT_LIST|BUF_STACK) )
+    return PL_error(NULL, 0, NULL, ERR_TYPE, ATOM_text, A1);
+  if ( !(ref.tmpl = new_format_template(&fmt)) )
+    return FALSE;
+
+  if ( PL_unify_blob(A2, &ref, sizeof(ref), &format_template_blob) )
+    return TRUE;
+  free_format_template(ref.tmpl);
+  return FALSE;
+}
+
+
 typedef struct sub_state
 { char          buf[BUFSIZE];
   char         *str;
@@ -451,11 +839,11 @@ end_sub_format(sub_state *state, int rc)
 		********************************/
 
 static bool
-do_format(IOSTREAM *fd, PL_chars_t *fmt, int argc, term_t argv, Module m)
+do_format(IOSTREAM *fd, format_template *fmt, int argc, term_t argv, Module m)
 { GET_LD
   format_state state;			/* complete state */
   int tab_stop = 0;			/* padded tab stop */
-  unsigned int here = 0;
+  const fmt_directive *d, *de;
   int rc = TRUE;
 
   state.out = fd;
@@ -468,51 +856,37 @@ do_format(IOSTREAM *fd, PL_chars_t *fmt, int argc, term_t argv, Module m)
   else
     state.column = 0;
 
-  while(here < fmt->length)
-  { int c = get_chr_from_text(fmt, here);
+  for(d=fmt->directives, de=d+fmt->count; d < de; d++)
+  { int c = d->code;
 
     switch(c)
-    { case '~':
-	{ int arg = DEFAULT;		/* Numeric argument */
-	  int mod_colon = FALSE;	/* Used colon modifier */
-	  predicate_t proc;
-					/* Get the numeric argument */
-	  c = get_chr_from_text(fmt, ++here);
+    { case FMT_LITERAL:
+	{ size_t i, end = d->start+d->length;
 
-	  if ( isDigitW(c) )
-	  { arg = c - '0';
-
-	    here++;
-	    while(here < fmt->length)
-	    { c = get_chr_from_text(fmt, here);
-
-	      if ( isDigitW(c) )
-	      { int dw = c - '0';
-		int arg2 = arg*10 + dw;
+	  if ( d->ascii )
+	  { rc = outascii(&state, &fmt->text.text.t[d->start], d->length);
+	    if ( !rc )
+	      goto out;
+	    break;
+	  }
+	  for(i=d->start; i<end; i++)
+	  { rc = outchr(&state, get_chr_from_text(&fmt->text, i));
+	    if ( !rc )
+	      goto out;
+	  }
+	  break;
+	}
+      default:
+	{ int arg = d->arg;		/* Numeric argument */
+	  int mod_colon = d->colon;	/* Used colon modifier */
+	  predicate_t proc;
 
-		if ( (arg2 - dw)/10 != arg )	/* see mul64() in pl-arith.c */
-		{ FMT_ERROR("argument overflow");
-		}
-		arg = arg2;
-		here++;
-	      } else
-		break;
-	    }
-	  } else if ( c == '*' )
+	  if ( arg == FMT_STAR )
 	  { NEED_ARG;
 	    if ( PL_get_integer(argv, &arg) && arg >= 0 )
 	    { SHIFT;
 	    } else
 	      FMT_ERROR("no or negative integer for `*' argument");
-	    c = get_chr_from_text(fmt, ++here);
-	  } else if ( c == '`' && here < fmt->length )
-	  { arg = get_chr_from_text(fmt, ++here);
-	    c = get_chr_from_text(fmt, ++here);
-	  }
-
-	  if ( c == ':' )
-	  { mod_colon = TRUE;
-	    c = get_chr_from_text(fmt, ++here);
 	  }
 
 					/* Check for user defined format */
@@ -545,7 +919,6 @@ do_format(IOSTREAM *fd, PL_chars_t *fmt, int argc, term_t argv, Module m)
 	    if ( !rc )
 	      goto out;
 
-	    here++;
 	  } else
 	  { switch(c)			/* Build in formatting */
 	    { case 'a':			/* atomic */
@@ -558,7 +931,6 @@ do_format(IOSTREAM *fd, PL_chars_t *fmt, int argc, term_t argv, Module m)
 		  rc = outtext(&state, &txt);
 		  if ( !rc )
 		    goto out;
-		  here++;
 		  break;
 		}
 	      case 'c':			/* ~c: character code */
@@ -576,7 +948,6 @@ do_format(IOSTREAM *fd, PL_chars_t *fmt, int argc, term_t argv, Module m)
 		    }
 		  } else
 		    FMT_ARG("c", argv);
-		  here++;
 		  break;
 		}
 	      case 'e':			/* exponential float */
@@ -618,7 +989,6 @@ do_format(IOSTREAM *fd, PL_chars_t *fmt, int argc, term_t argv, Module m)
 		  discardBuffer(&u.b);
 		  if ( !rc )
 		    goto out;
-		  here++;
 		  break;
 		}
 	      case 'd':			/* integer */
@@ -693,7 +1063,6 @@ do_format(IOSTREAM *fd, PL_chars_t *fmt, int argc, term_t argv, Module m)
 		  discardBuffer(&b);
 		  if ( !rc )
 		    goto out;
-		  here++;
 		  break;
 		}
 	      case 's':			/* string */
@@ -713,13 +1082,11 @@ do_format(IOSTREAM *fd, PL_chars_t *fmt, int argc, term_t argv, Module m)
 		  SHIFT;
 		  if ( !rc )
 		    goto out;
-		  here++;
 		  break;
 		}
 	      case 'i':			/* ignore */
 		{ NEED_ARG;
 		  SHIFT;
-		  here++;
 		  break;
 		}
 		{ Func1 f;
@@ -749,7 +1116,6 @@ do_format(IOSTREAM *fd, PL_chars_t *fmt, int argc, term_t argv, Module m)
 		   goto out;
 
 		  SHIFT;
-		  here++;
 		  break;
 		}
 	      case 'W':			/* write_term(Value, Options) */
@@ -769,7 +1135,6 @@ do_format(IOSTREAM *fd, PL_chars_t *fmt, int argc, term_t argv, Module m)
 
 		 SHIFT;
 		 SHIFT;
-		 here++;
 		 break;
 	       }
 	      case '@':
@@ -797,14 +1162,12 @@ do_format(IOSTREAM *fd, PL_chars_t *fmt, int argc, term_t argv, Module m)
 		  }
 
 		  SHIFT;
-		  here++;
 		  break;
 		}
 	      case '~':			/* ~ */
 		{ rc = outchr(&state, '~');
 		  if ( !rc )
 		    goto out;
-		  here++;
 		  break;
 		}
 	      case 'n':			/* \n */
@@ -818,7 +1181,6 @@ do_format(IOSTREAM *fd, PL_chars_t *fmt, int argc, term_t argv, Module m)
 		    if ( !rc )
 		      goto out;
 		  }
-		  here++;
 		  break;
 		}
 	      case 't':			/* insert tab */
@@ -831,7 +1193,6 @@ do_format(IOSTREAM *fd, PL_chars_t *fmt, int argc, term_t argv, Module m)
 							: (pl_wchar_t)arg);
 		  state.rub[state.pending_rubber].size = 0;
 		  state.pending_rubber++;
-		  here++;
 		  break;
 		}
 	      case '|':			/* set tab */
@@ -882,7 +1243,6 @@ do_format(IOSTREAM *fd, PL_chars_t *fmt, int argc, term_t argv, Module m)
 		  }
 
 		  state.column = tab_stop = stop;
-		  here++;
 		  break;
 		}
 	      default:
@@ -895,14 +1255,7 @@ do_format(IOSTREAM *fd, PL_chars_t *fmt, int argc, term_t argv, Module m)
 	      }
 	    }
 	  }
-	  break;			/* the '~' switch */
-	}
-      default:
-	{ rc = outchr(&state, c);
-	  if ( !rc )
-	    goto out;
-	  here++;
-	  break;
+	  break;			/* the directive switch */
 	}
     }
   }
@@ -1746,3 +2099,12 @@ formatFloat(PL_locale *locale, int how, int arg, Number f, Buffer out)
 
   return baseBuffer(out, char);
 }
+
+
+		 /*******************************
+		 *      PUBLISH PREDICATES	*
+		 *******************************/
+
+BeginPredDefs(format)
+  PRED_DEF("format_compile", 2, format_compile, 0)
+EndPredDefs
@@ -46,5 +46,6 @@ word		pl_current_format_predicate(term_t chr, term_t descr,
 					    control_t h);
 word		pl_format(term_t fmt, term_t args);
 word		pl_format3(term_t s, term_t fmt, term_t args);
+void		freeFormatCache(PL_local_data_t *ld);
 
 #endif /*_PL_FMT_H*/
\ No newline at end of file
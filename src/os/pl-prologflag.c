@@ -914,6 +914,10 @@ set_prolog_flag_unlocked(DECL_LD Module m, atom_t k, term_t value, int flags)
 
       if ( !PL_get_int64_ex(value, &i) )
 	return FALSE;
+      if ( (k == ATOM_cycle_check_threshold || k == ATOM_idle_trim_floor) &&
+	   i < 0 )
+	return PL_error(NULL, 0, NULL, ERR_DOMAIN,
+			ATOM_not_less_than_zero, value);
       f->value.i = i;
 
 #ifdef O_ATOMGC
@@ -944,7 +948,14 @@ set_prolog_flag_unlocked(DECL_LD Module m, atom_t k, term_t value, int flags)
       { LD->fli.string_buffers.tripwire = (unsigned int)i;
       } else if ( k == ATOM_heartbeat )
       { LD->yield.frequency = i/16;
+      } else if ( k == ATOM_cycle_check_threshold )
+      { LD->prolog_flag.cycle_threshold = (size_t)i;
       }
+#ifdef O_PLMT
+      else if ( k == ATOM_idle_trim_floor )
+      { GD->idle_trim.floor = (size_t)i;
+      }
+#endif
       break;
     }
     case FT_FLOAT:
@@ -952,6 +963,28 @@ set_prolog_flag_unlocked(DECL_LD Module m, atom_t k, term_t value, int flags)
 
       if ( !PL_get_float_ex(value, &d) )
 	return FALSE;
+
+      if ( k == ATOM_gc_target_pause || k == ATOM_gc_target_fraction )
+      { if ( !(d >= 0.0) ||
+	     (k == ATOM_gc_target_fraction && d >= 1.0) )
+	  return PL_error(NULL, 0, NULL, ERR_DOMAIN,
+			  k == ATOM_gc_target_pause ? ATOM_not_less_than_zero
+						    : ATOM_gc_target_fraction,
+			  value);
+	if ( k == ATOM_gc_target_pause )
+	  GD->gc.target_pause = d;
+	else
+	  GD->gc.target_fraction = d;
+      }
+#ifdef O_PLMT
+      else if ( k == ATOM_idle_trim_time )
+      { if ( !(d >= 0.0) )
+	  return PL_error(NULL, 0, NULL, ERR_DOMAIN,
+			  ATOM_not_less_than_zero, value);
+	GD->idle_trim.time = d;
+	wakeupGCThread();		/* (re)start timed waiting */
+      }
+#endif
       f->value.f = d;
       break;
     }
@@ -1538,6 +1571,8 @@ initPrologFlags(void)
   setPrologFlag("unload_foreign_libraries", FT_BOOL, FALSE, 0);
   setPrologFlag("gc",	  FT_BOOL,	       TRUE,  PLFLAG_GC);
   setPrologFlag("trace_gc",  FT_BOOL,	       FALSE, PLFLAG_TRACE_GC);
+  setPrologFlag("gc_target_pause",    FT_FLOAT, GD->gc.target_pause);
+  setPrologFlag("gc_target_fraction", FT_FLOAT, GD->gc.target_fraction);
 #ifdef O_ATOMGC
   setPrologFlag("agc_margin", FT_INTEGER, (intptr_t)GD->atoms.margin);
   setPrologFlag("agc_close_streams", FT_BOOL, FALSE, PLFLAG_AGC_CLOSE_STREAMS);
@@ -1572,6 +1607,9 @@ initPrologFlags(void)
   setPrologFlag("gc_thread",    FT_BOOL,
 		!GD->options.nothreads &&
 		truePrologFlag(PLFLAG_GCTHREAD), PLFLAG_GCTHREAD);
+  GD->idle_trim.floor = 1024*1024;
+  setPrologFlag("idle_trim_time",  FT_FLOAT, GD->idle_trim.time);
+  setPrologFlag("idle_trim_floor", FT_INTEGER, (intptr_t)GD->idle_trim.floor);
 #else
   setPrologFlag("threads",	FT_BOOL|FF_READONLY, FALSE, 0);
   setPrologFlag("gc_thread",    FT_BOOL|FF_READONLY, FALSE, PLFLAG_GCTHREAD);
@@ -1635,6 +1673,9 @@ initPrologFlags(void)
   setPrologFlag("stream_type_check", FT_ATOM, "loose");
   setPrologFlag("occurs_check", FT_ATOM, "false");
   setPrologFlag("shift_check", FT_BOOL, FALSE,  PLFLAG_SHIFT_CHECK);
+#if defined(HAVE_SYS_MMAN_H) && SIZEOF_VOIDP == 8
+  setPrologFlag("stack_reserve", FT_BOOL, FALSE, PLFLAG_STACK_RESERVE);
+#endif
   setPrologFlag("access_level", FT_ATOM, "user");
   setPrologFlag("double_quotes", FT_ATOM,
 		GD->options.traditional ? "codes" : "string");
@@ -1692,6 +1733,9 @@ initPrologFlags(void)
 		truePrologFlag(PLFLAG_SIGNALS), PLFLAG_SIGNALS);
   setPrologFlag("packs", FT_BOOL, GD->cmdline.packs, 0);
   setPrologFlag("heartbeat", FT_INTEGER, (intptr_t)0);
+  LD->prolog_flag.cycle_threshold = CYCLE_CHECK_THRESHOLD;
+  setPrologFlag("cycle_check_threshold", FT_INTEGER,
+		(intptr_t)LD->prolog_flag.cycle_threshold);
 
 #if defined(__WINDOWS__) && defined(_DEBUG)
   setPrologFlag("kernel_compile_mode", FT_ATOM|FF_READONLY, "debug");
@@ -805,6 +805,30 @@ PL_unify_text_range(term_t term, const PL_chars_t *text,
 }
 
 
+/* - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+PL_refresh_text() re-establishes  the  pointer  of   text  if  it  was
+obtained using BUF_ALLOW_STACK from the  string   term  and points into
+the global stack. This allows  processing  a   string  as  a slice of the
+original without copying it,  while  creating   new  terms  (which may
+trigger GC or a stack shift, moving the string) in between.
+- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
+int
+PL_refresh_text(term_t term, PL_chars_t *text)
+{ if ( text->storage == PL_CHARS_STACK )
+  { GET_LD
+    Word p = valTermRef(term);
+
+    deRef(p);
+    assert(isString(*p));
+
+    return get_string_text(*p, text);
+  }
+
+  return TRUE;
+}
+
+
 /* - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 int PL_promote_text(PL_chars_t *text)
 
@@ -1731,6 +1755,293 @@ PL_cmp_text(PL_chars_t *t1, size_t o1, PL_chars_t *t2, size_t o2,
 }
 
 
+		 /*******************************
+		 *	  SUBSTRING SEARCH	*
+		 *******************************/
+
+/* - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+size_t PL_search_text(const PL_chars_t *hay, size_t from,
+		      const PL_chars_t *needle, int flags)
+
+Find the first occurrence of needle in hay  at or after the character
+offset from. Returns the offset of the match or (size_t)-1.
+
+We use the Two-Way algorithm  by   Crochemore  and Perrin, which runs in
+linear time and constant  space.  The   needle  is  first  copied to an
+array of code points such that  we   only  need to instantiate the main
+loop for the encoding of hay.
+
+If flags contains PL_SEARCH_ICASE we   realise  the `half case
+insensitive' match of sub_atom_icasechk/3: a character  from needle
+matches either the  same  character  or   the  lowercase  version  of  a
+character in hay.  This  is  an  equivalence   that  can  be  used  by
+Two-Way if needle is lowercase.  Otherwise we use a simple scan.
+
+Searching for multiple occurrences of the   same  needle, as sub_atom/5
+does on backtracking, uses PL_init_text_search()  to copy the needle and
+compute its critical factorization once,  PL_text_search()  to find the
+next match and PL_free_text_search() to release the searcher. The
+needle passed to PL_text_search() must be the same text as used for
+PL_init_text_search(). It is only used if wchar_t is UTF-16.
+- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
+#define TEXT_SEARCH_LOWER_LATIN	0x1	/* needle is makeLower() invariant */
+#define TEXT_SEARCH_LOWER_WIDE	0x2	/* needle is makeLowerW() invariant */
+
+static ssize_t
+max_suffix(const int *x, ssize_t m, ssize_t *period, int reverse)
+{ ssize_t ms = -1, j = 0, k = 1, p = 1;
+
+  while( j+k < m )
+  { int a = x[j+k];
+    int b = x[ms+k];
+
+    if ( reverse ? a > b : a < b )
+    { j += k;
+      k = 1;
+      p = j - ms;
+    } else if ( a == b )
+    { if ( k != p )
+      { k++;
+      } else
+      { j += p;
+	k = 1;
+      }
+    } else
+    { ms = j;
+      j = ms+1;
+      k = p = 1;
+    }
+  }
+
+  *period = p;
+  return ms;
+}
+
+
+#define TWO_WAY(name, type, get)					\
+static ssize_t								\
+name(const type *y, ssize_t n, const text_search *ts)			\
+{ const int *x = ts->needle;						\
+  ssize_t m = ts->length;						\
+  ssize_t ell = ts->ell;						\
+  ssize_t per = ts->period;						\
+  ssize_t i, j;								\
+									\
+  if ( ts->periodic )							\
+  { ssize_t memory = -1;						\
+									\
+    for(j=0; j <= n-m; )						\
+    { i = (ell > memory ? ell : memory) + 1;				\
+      while ( i < m && x[i] == get(y[i+j]) )				\
+	i++;								\
+      if ( i >= m )							\
+      { i = ell;							\
+	while ( i > memory && x[i] == get(y[i+j]) )			\
+	  i--;								\
+	if ( i <= memory )						\
+	  return j;							\
+	j += per;							\
+	memory = m - per - 1;						\
+      } else								\
+      { j += i - ell;							\
+	memory = -1;							\
+      }									\
+    }									\
+  } else								\
+  { for(j=0; j <= n-m; )						\
+    { i = ell + 1;							\
+      while ( i < m && x[i] == get(y[i+j]) )				\
+	i++;								\
+      if ( i >= m )							\
+      { i = ell;							\
+	while ( i >= 0 && x[i] == get(y[i+j]) )				\
+	  i--;								\
+	if ( i < 0 )							\
+	  return j;							\
+	j += per;							\
+      } else								\
+      { j += i - ell;							\
+      }									\
+    }									\
+  }									\
+									\
+  return -1;								\
+}
+
+#define SEARCH_CHR(c)	(c)
+#define SEARCH_LWRA(c)	makeLower(c)
+#define SEARCH_LWRW(c)	makeLowerW(c)
+
+TWO_WAY(two_way_latin, unsigned char, SEARCH_CHR)
+TWO_WAY(two_way_latin_icase, unsigned char, SEARCH_LWRA)
+TWO_WAY(two_way_wchar, pl_wchar_t, SEARCH_CHR)
+TWO_WAY(two_way_wchar_icase, pl_wchar_t, SEARCH_LWRW)
+
+
+static size_t
+search_text_icase(const PL_chars_t *hay, size_t from, const int *x, size_t m)
+{ size_t j, i;
+
+  for(j=from; j+m <= hay->length; j++)
+  { for(i=0; i<m; i++)
+    { int c = text_get_char(hay, j+i);
+
+      if ( x[i] != c &&
+	   x[i] != (hay->encoding == ENC_ISO_LATIN_1 ? makeLower(c)
+						     : makeLowerW(c)) )
+	break;
+    }
+    if ( i == m )
+      return j;
+  }
+
+  return (size_t)-1;
+}
+
+
+void
+PL_init_text_search(text_search *ts, const PL_chars_t *needle, int flags)
+{ size_t m = needle->length;
+  ssize_t ell, per, ell2, per2;
+  int *x;
+
+  assert(needle->canonical);
+
+  ts->length = m;
+  ts->flags  = flags;
+  ts->lower  = TEXT_SEARCH_LOWER_LATIN|TEXT_SEARCH_LOWER_WIDE;
+  ts->needle = x = (m <= TEXT_SEARCH_BUF ? ts->buf
+					 : PL_malloc(m*sizeof(int)));
+  for(size_t i=0; i<m; i++)
+  { int c = text_get_char(needle, i);
+
+    if ( makeLower(c) != c )
+      ts->lower &= ~TEXT_SEARCH_LOWER_LATIN;
+    if ( makeLowerW(c) != c )
+      ts->lower &= ~TEXT_SEARCH_LOWER_WIDE;
+    x[i] = c;
+  }
+
+  if ( m == 0 )
+  { ts->ell = -1;
+    ts->period = 1;
+    ts->periodic = TRUE;
+    return;
+  }
+
+  ell  = max_suffix(x, m, &per, FALSE);
+  ell2 = max_suffix(x, m, &per2, TRUE);
+  if ( ell2 > ell )
+  { ell = ell2;
+    per = per2;
+  }
+
+  ts->ell = ell;
+  if ( memcmp(x, x+per, (ell+1)*sizeof(int)) == 0 )
+  { ts->periodic = TRUE;
+    ts->period   = per;
+  } else
+  { ts->periodic = FALSE;
+    ts->period   = (ell+1 > (ssize_t)m-ell-1 ? ell+1 : (ssize_t)m-ell-1) + 1;
+  }
+}
+
+
+void
+PL_free_text_search(text_search *ts)
+{ if ( ts->needle != ts->buf )
+    PL_free(ts->needle);
+  ts->needle = NULL;
+}
+
+
+size_t
+PL_text_search(text_search *ts, const PL_chars_t *hay, size_t from,
+	       const PL_chars_t *needle)
+{ size_t m = ts->length;
+  size_t n = hay->length;
+  int icase = (ts->flags&PL_SEARCH_ICASE);
+  ssize_t rc;
+
+  assert(hay->canonical);
+
+#if SIZEOF_WCHAR_T == 2
+  if ( !icase &&
+       (hay->encoding == ENC_WCHAR || needle->encoding == ENC_WCHAR) )
+  { size_t hl = PL_text_length(hay);
+    size_t nl = PL_text_length(needle);
+
+    for( ; from+nl <= hl; from++ )
+    { if ( PL_cmp_text((PL_chars_t*)hay, from,
+		       (PL_chars_t*)needle, 0, nl) == CMP_EQUAL )
+	return from;
+    }
+    return (size_t)-1;
+  }
+#else
+  (void)needle;
+#endif
+
+  if ( from > n || m > n-from )
+    return (size_t)-1;
+  if ( m == 0 )
+    return from;
+
+  if ( hay->encoding == ENC_ISO_LATIN_1 )
+  { const unsigned char *y = (const unsigned char *)hay->text.t + from;
+
+    if ( !icase && m == 1 )
+    { int c = ts->needle[0];
+      const char *s;
+
+      if ( c > 0xff )
+	return (size_t)-1;
+      if ( (s = memchr(y, c, n-from)) )
+	return s - hay->text.t;
+      return (size_t)-1;
+    }
+
+    if ( icase )
+    { if ( !(ts->lower&TEXT_SEARCH_LOWER_LATIN) )
+	return search_text_icase(hay, from, ts->needle, m);
+      rc = two_way_latin_icase(y, n-from, ts);
+    } else
+    { rc = two_way_latin(y, n-from, ts);
+    }
+  } else
+  { const pl_wchar_t *y = hay->text.w + from;
+
+    if ( icase )
+    { if ( !(ts->lower&TEXT_SEARCH_LOWER_WIDE) )
+	return search_text_icase(hay, from, ts->needle, m);
+      rc = two_way_wchar_icase(y, n-from, ts);
+    } else
+    { rc = two_way_wchar(y, n-from, ts);
+    }
+  }
+
+  return rc < 0 ? (size_t)-1 : from+(size_t)rc;
+}
+
+
+size_t
+PL_search_text(const PL_chars_t *hay, size_t from,
+	       const PL_chars_t *needle, int flags)
+{ text_search ts;
+  size_t rc;
+
+  if ( from > hay->length || needle->length > hay->length-from )
+    return (size_t)-1;
+
+  PL_init_text_search(&ts, needle, flags);
+  rc = PL_text_search(&ts, hay, from, needle);
+  PL_free_text_search(&ts);
+
+  return rc;
+}
+
+
 int
 PL_concat_text(int n, PL_chars_t **text, PL_chars_t *result)
 { size_t total_length = 0;
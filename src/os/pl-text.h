@@ -73,6 +73,21 @@ typedef struct
 	  (txt)->canonical = FALSE; \
 	}
 
+#define PL_SEARCH_ICASE	0x1		/* PL_search_text(): ignore case */
+
+#define TEXT_SEARCH_BUF 64
+
+typedef struct text_search
+{ int	       *needle;			/* needle as code points */
+  size_t	length;			/* length of the needle */
+  ssize_t	ell;			/* critical factorization */
+  ssize_t	period;			/* (shift for) period */
+  int		periodic;		/* needle is periodic */
+  int		flags;			/* PL_SEARCH_* */
+  int		lower;			/* TEXT_SEARCH_LOWER_* */
+  int		buf[TEXT_SEARCH_BUF];	/* buffer for short needles */
+} text_search;
+
 #if USE_LD_MACROS
 #define	PL_get_text(l, text, flags)	LDFUNC(PL_get_text, l, text, flags)
 #endif /*USE_LD_MACROS*/
@@ -82,6 +97,7 @@ typedef struct
 int	PL_unify_text(term_t term, term_t tail, PL_chars_t *text, int type);
 int	PL_unify_text_range(term_t term, const PL_chars_t *text,
 			    size_t from, size_t len, int type);
+int	PL_refresh_text(term_t term, PL_chars_t *text);
 
 int	PL_promote_text(PL_chars_t *text);
 int	PL_mb_text(PL_chars_t *text, int flags);
@@ -91,6 +107,13 @@ int	PL_canonicalise_text_ex(PL_chars_t *text) WUNUSED;
 int	PL_cmp_text(PL_chars_t *t1, size_t o1, PL_chars_t *t2, size_t o2,
 		    size_t len);
 int	PL_concat_text(int n, PL_chars_t **text, PL_chars_t *result);
+size_t	PL_search_text(const PL_chars_t *hay, size_t from,
+		       const PL_chars_t *needle, int flags);
+void	PL_init_text_search(text_search *ts,
+			    const PL_chars_t *needle, int flags);
+size_t	PL_text_search(text_search *ts, const PL_chars_t *hay, size_t from,
+		       const PL_chars_t *needle);
+void	PL_free_text_search(text_search *ts);
 
 void	PL_free_text(PL_chars_t *text);
 int	PL_save_text(PL_chars_t *text, int flags);
@@ -47,6 +47,7 @@
 #include "pl-fli.h"
 #include "pl-setup.h"
 #include "pl-pro.h"
+#include "pl-prof.h"
 #include <math.h>
 #ifdef HAVE_MALLOC_H
 #include <malloc.h>
@@ -66,6 +67,9 @@
 #define MAP_ANONYMOUS 0
 #endif
 #endif
+#ifndef MAP_NORESERVE
+#define MAP_NORESERVE 0
+#endif
 #endif
 
 #undef LD
@@ -177,6 +181,11 @@ void *
 allocHeap(size_t n)
 { void *mem = malloc(n);
 
+#ifdef O_PROFILE
+  if ( unlikely(GD->profile.alloc_samplers) )
+    allocProfileHeap(n);
+#endif
+
 #if ALLOC_DEBUG
   if ( mem )
     memset((char *) mem, ALLOC_NEW_MAGIC, n);
@@ -810,6 +819,10 @@ allocGlobal(DECL_LD size_t n)
 
   result = gTop;
   gTop += n;
+#ifdef O_PROFILE
+  if ( unlikely(LD->alerted & ALERT_ALLOCPROF) )
+    allocProfileGlobal(environment_frame, result);
+#endif
 
   return result;
 }
@@ -823,6 +836,10 @@ allocGlobalNoShift(DECL_LD size_t n)
 
   result = gTop;
   gTop += n;
+#ifdef O_PROFILE
+  if ( unlikely(LD->alerted & ALERT_ALLOCPROF) )
+    allocProfileGlobal(environment_frame, result);
+#endif
 
   return result;
 }
@@ -1351,6 +1368,7 @@ properly on Linux. Don't bother with it.
 
 typedef struct
 { size_t size;				/* Size (including header) */
+  size_t reserved;			/* Reserved address space or 0 */
   int	 mmapped;			/* Is mmapped? */
   double data[1];			/* ensure alignment */
 } map_region;
@@ -1429,8 +1447,9 @@ tmp_malloc(size_t req)
   }
 
   if ( reg )
-  { reg->size    = req;
-    reg->mmapped = mmapped;
+  { reg->size     = req;
+    reg->reserved = 0;
+    reg->mmapped  = mmapped;
 #ifdef O_DEBUG
     memset(reg->data, 0xFB, req-SA_OFFSET);
 #endif
@@ -1442,12 +1461,86 @@ tmp_malloc(size_t req)
 }
 
 
+/* - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Reserved regions (see  the  Prolog  flag   stack_reserve)  map  a large
+address range using PROT_NONE and make only  the first `size` bytes of
+it accessible.  Resizing within the range  changes the protection of the
+tail and never moves the data.  Pages   released  by shrinking are given
+back to the OS.
+- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
+static void *
+tmp_malloc_reserved(size_t req, size_t reserve)
+{ map_region *reg;
+
+  req     = roundpgsize(req+SA_OFFSET);
+  reserve = roundpgsize(reserve+SA_OFFSET);
+  if ( reserve < req )
+    reserve = req;
+
+  reg = mmap(NULL, reserve,
+	     PROT_NONE,
+	     (MAP_PRIVATE|MAP_ANONYMOUS|MAP_NORESERVE),
+	     -1, 0);
+  if ( reg == MAP_FAILED )
+    return NULL;
+  if ( mprotect(reg, req, PROT_READ|PROT_WRITE) != 0 )
+  { munmap(reg, reserve);
+    return NULL;
+  }
+
+  reg->size     = req;
+  reg->reserved = reserve;
+  reg->mmapped  = TRUE;
+
+  return reg->data;
+}
+
+static int
+resize_reserved(map_region *reg, size_t req)
+{ if ( req > reg->size )
+  { if ( mprotect((char*)reg+reg->size, req-reg->size,
+		  PROT_READ|PROT_WRITE) != 0 )
+      return FALSE;
+#ifdef O_DEBUG
+    memset((char*)reg+reg->size, 0xFB, req-reg->size);
+#endif
+  } else if ( req < reg->size )
+  { char *tail = (char*)reg+req;
+    size_t len = reg->size-req;
+
+#ifdef MADV_DONTNEED
+    madvise(tail, len, MADV_DONTNEED);
+#endif
+    mprotect(tail, len, PROT_NONE);
+  }
+
+  reg->size = req;
+  return TRUE;
+}
+
+
 void *
 tmp_realloc(void *mem, size_t req)
 { if ( mem )
   { map_region *reg = (map_region *)((char*)mem-SA_OFFSET);
 
     req += SA_OFFSET;
+    if ( reg->reserved )
+    { req = roundpgsize(req);
+
+      if ( req <= reg->reserved )
+	return resize_reserved(reg, req) ? mem : NULL;
+      else
+      { void *nw = tmp_malloc_reserved(req-SA_OFFSET, reg->reserved*2);
+
+	if ( nw )
+	{ memcpy(nw, mem, reg->size-SA_OFFSET);
+	  tmp_free(mem);
+	}
+	return nw;
+      }
+    }
     if ( !reg->mmapped )
     { if ( req < MMAP_THRESHOLD )
       { map_region *nw = realloc(reg, req);
@@ -1510,7 +1603,7 @@ tmp_free(void *mem)
   { map_region *reg = (map_region *)((char*)mem-SA_OFFSET);
 
     if ( reg->mmapped )
-      munmap(reg, reg->size);
+      munmap(reg, reg->reserved ? reg->reserved : reg->size);
     else
       free(reg);
   }
@@ -1627,6 +1720,42 @@ stack_realloc(void *mem, size_t size)
   return ptr;
 }
 
+/* - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+stack_realloc_reserved() is as stack_realloc(),  but   if  the stack is
+(re)allocated, it is placed  in  a  range   of  `reserve`  bytes  of
+reserved address space, such that  subsequent   resizes  up  to that
+size do not move the stack.  Falls back to stack_realloc() if reserving
+is not supported or fails.
+- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
+void *
+stack_realloc_reserved(void *mem, size_t size, size_t reserve)
+{
+#ifdef MMAP_STACK
+  if ( !mem || !((map_region *)((char*)mem-SA_OFFSET))->reserved )
+  { void *ptr;
+
+    if ( (ptr = tmp_malloc_reserved(size, reserve)) )
+    { size = tmp_malloc_size(ptr);
+
+      if ( mem )
+      { size_t osize = tmp_malloc_size(mem);
+
+	memcpy(ptr, mem, osize < size ? osize : size);
+	stack_free(mem);
+      }
+      ATOMIC_ADD(&GD->statistics.stack_space, size);
+
+      return ptr;
+    }
+  }
+#else
+  (void)reserve;
+#endif
+
+  return stack_realloc(mem, size);
+}
+
 void
 stack_free(void *mem)
 { size_t size = tmp_malloc_size(mem);
@@ -1909,6 +2038,41 @@ PRED_IMPL("trim_heap", 0, trim_heap, 0)
 }
 
 
+/* - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+idleTrimStacks() is called for  a  thread   that  has  been idle for the
+Prolog flag idle_trim_time seconds, i.e.,  a   thread  that waited that
+long in thread_get_message/1,2,3 or a suspended  engine. If the combined
+stacks are larger than the Prolog flag   idle_trim_floor, it collects the
+stacks, shrinks them and hands free memory back to the OS.
+- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
+#define combinedStackSize() \
+	(sizeStack(local) + sizeStack(global) + sizeStack(trail))
+
+void
+idleTrimStacks(DECL_LD)
+{ size_t before = combinedStackSize();
+  size_t after;
+
+  if ( before <= GD->idle_trim.floor )
+    return;
+
+  LD->trim_stack_requested = TRUE;
+  garbageCollect(GC_USER);
+  trimStacks(TRUE);			/* also if GC is disabled */
+
+  if ( is_tcmalloc )
+    WEAK_TRY_CALL_VOID(MallocExtension_ReleaseFreeMemory);
+  else
+    WEAK_TRY_CALL(malloc_trim, 0);
+
+  after = combinedStackSize();
+  ATOMIC_INC(&GD->statistics.idle_trims);
+  if ( after < before )
+    ATOMIC_ADD(&GD->statistics.idle_trim_gained, before-after);
+}
+
+
 /** thread_idle(:Goal, +How)
  *
  */
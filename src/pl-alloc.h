@@ -104,6 +104,7 @@ void	free_lingering(linger_list **list, gen_t generation);
 #define	put_int64(p, i, flags)			LDFUNC(put_int64, p, i, flags)
 #define	VM_globalIndirectFromCode(pc)		LDFUNC(VM_globalIndirectFromCode, pc)
 #define	VM_equalIndirectFromCode(a, pc)		LDFUNC(VM_equalIndirectFromCode, a, pc)
+#define	idleTrimStacks(_)			LDFUNC(idleTrimStacks, _)
 #endif /*USE_LD_MACROS*/
 
 #define LDFUNC_DECLARATIONS
@@ -111,6 +112,7 @@ void	free_lingering(linger_list **list, gen_t generation);
 void		initAlloc(void);
 int		initMalloc(void);
 size_t		heapUsed(void);
+void		idleTrimStacks(void);
 #ifndef DMALLOC
 void *		allocHeap(size_t n);
 void *		allocHeapOrHalt(size_t n);
@@ -145,6 +147,8 @@ size_t		tmp_nalloc(size_t req);
 size_t		tmp_nrealloc(void *mem, size_t req);
 void *		stack_malloc(size_t req);
 void *		stack_realloc(void *mem, size_t req);
+void *		stack_realloc_reserved(void *mem, size_t req,
+				       size_t reserve);
 void		stack_free(void *mem);
 size_t		stack_nalloc(size_t req);
 size_t		stack_nrealloc(void *mem, size_t req);
@@ -64,6 +64,8 @@ in this array.
 #include "pl-prims.h"
 #include "pl-gc.h"
 #include "pl-read.h"
+#include "pl-vector.h"
+#include "pl-setup.h"
 #include "os/pl-prologflag.h"
 #include <math.h>
 #include <limits.h>
@@ -167,6 +169,69 @@ clearInteger(Number n)
 #endif
 }
 
+#ifdef O_INT128
+/* - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Integers that exceed 64 bits but fit in  128 bits are common in hashing,
+checksums and fixed-point arithmetic.   For  these   we  compute  using
+__int128 rather than promoting the operands   to  GMP numbers. The result
+is a small integer if it fits and  is   otherwise  created as a GMP number
+without going through the generic GMP functions.
+
+int128_operands() is true if at least one   of  the operands is a bignum
+and both fit in 128 bits. Operations on two small integers use the 64-bit
+code and only use __int128 if the result overflows.
+- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
+static inline int
+int128_number(Number n, __int128 *i)
+{ if ( n->type == V_INTEGER )
+  { *i = n->value.i;
+    return TRUE;
+  } else if ( n->type == V_MPZ )
+  { return mpz_to_int128(n->value.mpz, i);
+  }
+
+  return FALSE;
+}
+
+static inline int
+int128_operands(Number n1, Number n2, __int128 *i1, __int128 *i2)
+{ return ( (n1->type == V_MPZ || n2->type == V_MPZ) &&
+	   int128_number(n1, i1) &&
+	   int128_number(n2, i2) );
+}
+
+static int
+put_int128_number(Number r, __int128 i)
+{ if ( i >= PLMININT && i <= PLMAXINT )
+  { r->value.i = (int64_t)i;
+    r->type = V_INTEGER;
+  } else
+  { mpz_init_set_int128(r->value.mpz, i);
+    r->type = V_MPZ;
+  }
+
+  return TRUE;
+}
+
+#define INT128_BINOP(n1, n2, r, expr) \
+	do \
+	{ __int128 i1, i2; \
+	  if ( int128_operands(n1, n2, &i1, &i2) ) \
+	    return put_int128_number(r, expr); \
+	} while(0)
+#define INT128_BINOP_OVERFLOW(n1, n2, r, builtin) \
+	do \
+	{ __int128 i1, i2, ir; \
+	  if ( int128_operands(n1, n2, &i1, &i2) && \
+	       !builtin(i1, i2, &ir) ) \
+	    return put_int128_number(r, ir); \
+	} while(0)
+#else /*O_INT128*/
+#define INT128_BINOP(n1, n2, r, expr) (void)0
+#define INT128_BINOP_OVERFLOW(n1, n2, r, builtin) (void)0
+#endif /*O_INT128*/
+
 
 typedef struct between_state
 { number low;
@@ -758,6 +823,7 @@ freeArithLocalData(PL_local_data_t *ld)
     ld->gmp.persistent--;
     ld->arith.random.initialised = FALSE;
   }
+  freeRadixCache(ld);
 #endif
 }
 
@@ -1035,6 +1101,11 @@ valueExpression(DECL_LD term_t expr, number *result)
 	{ functor = term->definition;
 	  goto arity0;
 	}
+	if ( arity <= 2 && isVectorFunction(term->definition) )
+	{ if ( valueVectorFunction(term, n) != TRUE )
+	    goto error;
+	  break;
+	}
 
 	if ( p == start )
 	{ initSegStack(&term_stack, sizeof(Word), sizeof(term_buf), term_buf);
@@ -1451,7 +1522,8 @@ ar_add_si(Number n, long add)
 
 int
 pl_ar_add(Number n1, Number n2, Number r)
-{ if ( !same_type_numbers(n1, n2) )
+{ INT128_BINOP_OVERFLOW(n1, n2, r, __builtin_add_overflow);
+  if ( !same_type_numbers(n1, n2) )
     return FALSE;
 
   switch(n1->type)
@@ -1469,6 +1541,9 @@ pl_ar_add(Number n1, Number n2, Number r)
       r->type = V_INTEGER;
       succeed;
     overflow:
+#ifdef O_INT128
+      return put_int128_number(r, (__int128)n1->value.i + n2->value.i);
+#endif
       if ( !promoteIntNumber(n1) ||
 	   !promoteIntNumber(n2) )
 	fail;
@@ -1503,7 +1578,8 @@ pl_ar_add(Number n1, Number n2, Number r)
 
 static int
 ar_minus(Number n1, Number n2, Number r)
-{ if ( !same_type_numbers(n1, n2) )
+{ INT128_BINOP_OVERFLOW(n1, n2, r, __builtin_sub_overflow);
+  if ( !same_type_numbers(n1, n2) )
     return FALSE;
 
   switch(n1->type)
@@ -1513,6 +1589,9 @@ ar_minus(Number n1, Number n2, Number r)
       if ( (n1->value.i >= 0 && n2->value.i < 0 && r->value.i <= 0) ||
 	   (n1->value.i < 0  && n2->value.i > 0 && r->value.i >= 0) )
       {					/* overflow */
+#ifdef O_INT128
+	return put_int128_number(r, (__int128)n1->value.i - n2->value.i);
+#endif
 	if ( !promoteIntNumber(n1) ||
 	     !promoteIntNumber(n2) )
 	  fail;
@@ -1587,6 +1666,19 @@ ar_mod(Number n1, Number n2, Number r)
   if ( !toIntegerNumber(n2, 0) )
     return PL_error("mod", 2, NULL, ERR_AR_TYPE, ATOM_integer, n2);
 
+#ifdef O_INT128
+  { __int128 i1, i2;
+
+    if ( int128_operands(n1, n2, &i1, &i2) && i2 != 0 )
+    { __int128 m = i1 % i2;
+
+      if ( m != 0 && (m<0) != (i2<0) )
+	m += i2;
+      return put_int128_number(r, m);
+    }
+  }
+#endif
+
   if ( !same_type_numbers(n1, n2) )
     return FALSE;
 
@@ -2129,6 +2221,7 @@ CR_FUNC(lgamma)
       return PL_error(plop, 2, NULL, ERR_AR_TYPE, ATOM_integer, n1); \
     if ( !toIntegerNumber(n2, 0) ) \
       return PL_error(plop, 2, NULL, ERR_AR_TYPE, ATOM_integer, n2); \
+    INT128_BINOP(n1, n2, r, i1 op i2); \
     if ( !same_type_numbers(n1, n2) ) \
       return FALSE; \
     switch(n1->type) \
@@ -2363,6 +2456,28 @@ pow64(int64_t m, int64_t n, int64_t *resp)	/* *resp = m^n */
   return TRUE;
 }
 
+#ifdef O_INT128
+static int
+pow128(__int128 m, int64_t n, __int128 *resp)	/* *resp = m^n */
+{ __int128 res = 1;
+
+  while (n != 0)
+  { if ( (n&1) )
+    { if ( __builtin_mul_overflow(res, m, &res) )
+	return FALSE;
+    }
+    n >>= 1;
+    if ( n )
+    { if ( __builtin_mul_overflow(m, m, &m) )
+	return FALSE;
+    }
+  }
+
+  *resp = res;
+  return TRUE;
+}
+#endif
+
 
 static int
 ar_pow(Number n1, Number n2, Number r)
@@ -2463,6 +2578,14 @@ ar_pow(Number n1, Number n2, Number r)
 	succeed;
       }
     }
+#ifdef O_INT128
+    if ( r_bits < 127 )
+    { __int128 m, res;
+
+      if ( int128_number(n1, &m) && pow128(m, exp, &res) )
+	return put_int128_number(r, res);
+    }
+#endif
 
 #ifdef O_BIGNUM
     r->type = V_MPZ;
@@ -2902,6 +3025,14 @@ ar_tdiv(Number n1, Number n2, Number r)
     }
   }
 
+#ifdef O_INT128
+  { __int128 i1, i2;
+
+    if ( int128_number(n1, &i1) && int128_number(n2, &i2) && i2 != 0 )
+      return put_int128_number(r, i1 / i2);
+  }
+#endif
+
 #ifdef O_BIGNUM
   promoteToMPZNumber(n1);
   promoteToMPZNumber(n2);
@@ -2952,6 +3083,19 @@ ar_div(Number n1, Number n2, Number r)
     }
   }
 
+#ifdef O_INT128
+  { __int128 i1, i2;
+
+    if ( int128_number(n1, &i1) && int128_number(n2, &i2) && i2 != 0 )
+    { __int128 q = i1 / i2;
+
+      if ( (i1 > 0) != (i2 > 0) && i1 % i2 != 0 )
+	q--;
+      return put_int128_number(r, q);
+    }
+  }
+#endif
+
 #ifdef O_BIGNUM
   promoteToMPZNumber(n1);
   promoteToMPZNumber(n2);
@@ -3152,6 +3296,14 @@ ar_rem(Number n1, Number n2, Number r)
   if ( !toIntegerNumber(n2, 0) )
     return PL_error("rem", 2, NULL, ERR_AR_TYPE, ATOM_integer, n2);
 
+#ifdef O_INT128
+  { __int128 i1, i2;
+
+    if ( int128_operands(n1, n2, &i1, &i2) && i2 != 0 )
+      return put_int128_number(r, i1 % i2);
+  }
+#endif
+
   if ( !same_type_numbers(n1, n2) )
     return FALSE;
   switch(n1->type)
@@ -3497,7 +3649,8 @@ mul64(int64_t x, int64_t y, int64_t *r)
 
 int
 ar_mul(Number n1, Number n2, Number r)
-{ if ( !same_type_numbers(n1, n2) )
+{ INT128_BINOP_OVERFLOW(n1, n2, r, __builtin_mul_overflow);
+  if ( !same_type_numbers(n1, n2) )
     return FALSE;
 
   switch(n1->type)
@@ -3506,6 +3659,9 @@ ar_mul(Number n1, Number n2, Number r)
       { r->type = V_INTEGER;
 	succeed;
       }
+#ifdef O_INT128
+      return put_int128_number(r, (__int128)n1->value.i * n2->value.i);
+#endif
       /*FALLTHROUGH*/
 #ifdef O_BIGNUM
       promoteToMPZNumber(n1);
@@ -4310,6 +4466,156 @@ ar_truncate(Number n1, Number r)
 }
 
 
+		 /*******************************
+		 *	  RANDOM NUMBERS	*
+		 *******************************/
+
+/* - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Random numbers for small integer bounds and floats are generated by a
+per-thread xoshiro256** generator (Blackman and Vigna).  This is a lot
+faster than the GMP generator, which we only use for bignum bounds.
+Both generators are seeded together by set_random(seed(X)) and the state
+as returned by random_property/1 covers both.  Note that random/1 with a
+small bound and random_float/0 produce different sequences for a given
+seed than versions that used GMP for all random numbers.
+
+rand_jump() advances the xoshiro generator by 2^128 steps, which allows
+for creating non-overlapping streams for parallel computations.
+- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
+static inline uint64_t
+rotl64(uint64_t x, int k)
+{ return (x << k) | (x >> (64 - k));
+}
+
+static uint64_t
+splitmix64(uint64_t *x)
+{ uint64_t z = (*x += 0x9e3779b97f4a7c15);
+
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+
+  return z ^ (z >> 31);
+}
+
+#define rand_u64(_) LDFUNC(rand_u64, _)
+static inline uint64_t
+rand_u64(DECL_LD)
+{ uint64_t *s = LD->arith.random.s;
+  uint64_t result = rotl64(s[1] * 5, 7) * 9;
+  uint64_t t = s[1] << 17;
+
+  s[2] ^= s[0];
+  s[3] ^= s[1];
+  s[1] ^= s[2];
+  s[0] ^= s[3];
+  s[2] ^= t;
+  s[3] = rotl64(s[3], 45);
+
+  return result;
+}
+
+/* rand_below() returns a uniformly distributed integer in [0..n) */
+
+#define rand_below(n) LDFUNC(rand_below, n)
+static inline uint64_t
+rand_below(DECL_LD uint64_t n)
+{ uint64_t mask = n-1;
+  uint64_t rnd;
+
+  mask |= mask >> 1;
+  mask |= mask >> 2;
+  mask |= mask >> 4;
+  mask |= mask >> 8;
+  mask |= mask >> 16;
+  mask |= mask >> 32;
+
+  do
+  { rnd = rand_u64() & mask;
+  } while ( rnd >= n );
+
+  return rnd;
+}
+
+/* rand_double() returns a uniformly distributed float in (0.0..1.0) */
+
+#define rand_double(_) LDFUNC(rand_double, _)
+static inline double
+rand_double(DECL_LD)
+{ double f;
+
+  do
+  { f = (double)(rand_u64() >> 11) * (1.0/9007199254740992.0);
+  } while ( f == 0.0 );
+
+  return f;
+}
+
+#define rand_jump(_) LDFUNC(rand_jump, _)
+static void
+rand_jump(DECL_LD)
+{ static const uint64_t jump[] =
+  { 0x180ec6d33cfd0aba, 0xd5a61266f0c9392c,
+    0xa9582618e03fc9aa, 0x39abdc4529b1661c
+  };
+  uint64_t *s = LD->arith.random.s;
+  uint64_t s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+
+  for(int i = 0; i < 4; i++)
+  { for(int b = 0; b < 64; b++)
+    { if ( (jump[i] & (uint64_t)1 << b) )
+      { s0 ^= s[0];
+	s1 ^= s[1];
+	s2 ^= s[2];
+	s3 ^= s[3];
+      }
+      (void)rand_u64();
+    }
+  }
+
+  s[0] = s0;
+  s[1] = s1;
+  s[2] = s2;
+  s[3] = s3;
+}
+
+/* rand_seed() initialises the xoshiro state from an arbitrary number
+   of 64-bit key words, preserving up to 256 bits of entropy.
+*/
+
+#define rand_seed(key, len) LDFUNC(rand_seed, key, len)
+static void
+rand_seed(DECL_LD const uint64_t *key, size_t len)
+{ uint64_t *s = LD->arith.random.s;
+  uint64_t x = len;
+
+  memset(s, 0, sizeof(LD->arith.random.s));
+  for(size_t i=0; i<len; i++)
+    s[i%4] ^= key[i];
+  for(int i=0; i<4; i++)
+  { x ^= s[i];
+    s[i] = splitmix64(&x);
+  }
+  if ( !(s[0]|s[1]|s[2]|s[3]) )		/* all-zero state is a fixpoint */
+    s[0] = 1;
+}
+
+#define rand_seed_bytes(data, len) LDFUNC(rand_seed_bytes, data, len)
+static void
+rand_seed_bytes(DECL_LD const void *data, size_t len)
+{ uint64_t key[4] = {0};
+
+  memcpy(key, data, len < sizeof(key) ? len : sizeof(key));
+  rand_seed(key, 4);
+}
+
+#define rand_seed_int(i) LDFUNC(rand_seed_int, i)
+static void
+rand_seed_int(DECL_LD uint64_t i)
+{ rand_seed(&i, 1);
+}
+
+
 #ifdef O_BIGNUM
 #ifdef HAVE_SYS_TYPES_H
 #include <sys/types.h>
@@ -4355,6 +4661,7 @@ seed_from_dev(DECL_LD const char *dev)
 	gmp_randseed(LD->arith.random.state, seed);
 	mpz_clear(seed);
 	LD->gmp.persistent--;
+	rand_seed_bytes(seedarray, rd);
 
 	done = TRUE;
       }
@@ -4396,6 +4703,7 @@ seed_from_crypt_context(DECL_LD)
   gmp_randseed(LD->arith.random.state, seed);
   mpz_clear(seed);
   LD->gmp.persistent--;
+  rand_seed_bytes(seedarray, sizeof(seedarray));
 
   return TRUE;
 #else
@@ -4425,15 +4733,39 @@ seed_random(DECL_LD)
     LD->gmp.persistent++;
     gmp_randseed_ui(LD->arith.random.state, key);
     LD->gmp.persistent--;
+    rand_seed_int(key ^ (uintptr_t)LD);
   }
 }
 
+/* seed_random_mpz() seeds both generators from a bignum */
+
+#define seed_random_mpz(seed) LDFUNC(seed_random_mpz, seed)
+static void
+seed_random_mpz(DECL_LD mpz_t seed)
+{ size_t len = (mpz_sizeinbase(seed, 2)+63)/64;
+  uint64_t buf[16];
+  uint64_t *key = len <= 16 ? buf : PL_malloc(len*sizeof(uint64_t));
+  size_t count = 0;
+
+  gmp_randseed(LD->arith.random.state, seed);
+  mpz_export(key, &count, -1, sizeof(uint64_t), 0, 0, seed);
+  rand_seed(key, count);
+  if ( key != buf )
+    PL_free(key);
+}
+
 #else /* O_BIGNUM */
 
 #define seed_random(_) LDFUNC(seed_random, _)
 static void
 seed_random(DECL_LD)
-{ setRandom(NULL);
+{ union
+  { double t;
+    uint64_t l;
+  } u;
+
+  u.t = WallTime();
+  rand_seed_int(u.l ^ (uintptr_t)LD);
 }
 
 #endif /*O_BIGNUM*/
@@ -4441,23 +4773,136 @@ seed_random(DECL_LD)
 #define init_random(_) LDFUNC(init_random, _)
 static void
 init_random(DECL_LD)
-{
+{ if ( !LD->arith.random.initialised )
+  {
 #ifdef O_BIGNUM
-  if ( !LD->arith.random.initialised )
-  { LD->gmp.persistent++;
+    LD->gmp.persistent++;
 #ifdef HAVE_GMP_RANDINIT_MT
 #define O_RANDOM_STATE 1
     gmp_randinit_mt(LD->arith.random.state);
 #else
     gmp_randinit_default(LD->arith.random.state);
+#endif
 #endif
     LD->arith.random.initialised = TRUE;
     seed_random();
+#ifdef O_BIGNUM
     LD->gmp.persistent--;
+#endif
   }
+}
+
+
+#ifdef O_RANDOM_STATE
+/* - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+The state is represented as a  single   integer  holding  the GMP state
+shifted left by RANDOM_STATE_SHIFT bits,  the 64-bit RANDOM_STATE_TAG and
+the xoshiro state in the low 256 bits.  The tag allows rejecting states
+from versions that only used GMP, which would otherwise be misread.
+- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
+#define RANDOM_STATE_TAG   UINT64_C(0x786f7368726f3031) /* "xoshro01" */
+#define RANDOM_STATE_SHIFT (256+64)
+
+/* The low part is exchanged as big-endian bytes because LibBF only
+   implements mpz_import()/mpz_export() for this layout.
+*/
+
+#define RANDOM_STATE_BYTES (5*sizeof(uint64_t))
+
+static void
+random_state_to_bytes(const uint64_t s[5], unsigned char *buf)
+{ for(int i=0; i<5; i++)
+  { for(int b=0; b<8; b++)
+      buf[(4-i)*8+(7-b)] = (unsigned char)(s[i]>>(b*8));
+  }
+}
+
+static void
+random_state_from_bytes(uint64_t s[5], const unsigned char *buf)
+{ for(int i=0; i<5; i++)
+  { s[i] = 0;
+    for(int b=0; b<8; b++)
+      s[i] |= (uint64_t)buf[(4-i)*8+(7-b)]<<(b*8);
+  }
+}
+
+#define set_random_state(state) LDFUNC(set_random_state, state)
+static int
+set_random_state(DECL_LD mpz_t state)
+{ mpz_t gmp, high, low;
+  unsigned char buf[RANDOM_STATE_BYTES];
+  uint64_t s[5];
+  size_t count;
+  int rc = TRUE;
+
+  if ( mpz_sgn(state) <= 0 )
+    return FALSE;
+
+  mpz_init(gmp);
+  mpz_init(high);
+  mpz_init(low);
+  mpz_fdiv_q_2exp(gmp, state, RANDOM_STATE_SHIFT);
+  mpz_mul_2exp(high, gmp, RANDOM_STATE_SHIFT);
+  mpz_sub(low, state, high);
+  memset(buf, 0, sizeof(buf));
+  if ( mpz_sizeinbase(low, 2) <= RANDOM_STATE_SHIFT )
+  { unsigned char tmp[RANDOM_STATE_BYTES];
+
+    mpz_export(tmp, &count, 1, 1, 1, 0, low);
+    memcpy(buf+sizeof(buf)-count, tmp, count);
+  }
+  random_state_from_bytes(s, buf);
+
+  if ( mpz_sgn(gmp) == 0 || s[4] != RANDOM_STATE_TAG ||
+       !(s[0]|s[1]|s[2]|s[3]) )
+  { rc = FALSE;
+  } else
+  {
+#if O_GMP
+    mpz_set(LD->arith.random.state[0]._mp_seed, gmp);
+#elif O_BF
+    if ( bf_set_randstate(LD->arith.random.state, gmp) )
+      rc = FALSE;
 #endif
+    if ( rc )
+      memcpy(LD->arith.random.s, s, sizeof(LD->arith.random.s));
+  }
+
+  mpz_clear(low);
+  mpz_clear(high);
+  mpz_clear(gmp);
+
+  return rc;
 }
 
+#define get_random_state(state) LDFUNC(get_random_state, state)
+static void
+get_random_state(DECL_LD mpz_t state)
+{ mpz_t gmp, low;
+  unsigned char buf[RANDOM_STATE_BYTES];
+  uint64_t s[5];
+
+  mpz_init(gmp);
+#if O_GMP
+  LD->arith.random.state[0]._mp_seed[0]._mp_size =
+  LD->arith.random.state[0]._mp_seed[0]._mp_alloc;
+  mpz_set(gmp, LD->arith.random.state[0]._mp_seed);
+#elif O_BF
+  bf_get_randstate(gmp, LD->arith.random.state);
+#endif
+  memcpy(s, LD->arith.random.s, 4*sizeof(uint64_t));
+  s[4] = RANDOM_STATE_TAG;
+  random_state_to_bytes(s, buf);
+  mpz_init(low);
+  mpz_import(low, sizeof(buf), 1, 1, 1, 0, buf);
+  mpz_mul_2exp(gmp, gmp, RANDOM_STATE_SHIFT);
+  mpz_add(state, gmp, low);
+  mpz_clear(low);
+  mpz_clear(gmp);
+}
+#endif /*O_RANDOM_STATE*/
+
 
 static
 PRED_IMPL("set_random", 1, set_random, 0)
@@ -4489,21 +4934,35 @@ PRED_IMPL("set_random", 1, set_random, 0)
 	  case V_INTEGER:
 	    gmp_randseed_ui(LD->arith.random.state,
 			    (unsigned long)n.value.i);
+	    rand_seed_int((uint64_t)n.value.i);
 	    return TRUE;
 	  case V_MPZ:
-	    gmp_randseed(LD->arith.random.state, n.value.mpz);
+	    seed_random_mpz(n.value.mpz);
 	    return TRUE;
 #else
 	  case V_INTEGER:
-	  { unsigned int seed = (unsigned int)n.value.i;
-	    setRandom(&seed);
+	    rand_seed_int((uint64_t)n.value.i);
 	    return TRUE;
-	  }
 #endif
 	  default:
 	    return PL_error(NULL, 0, NULL, ERR_TYPE, ATOM_seed, arg);
 	}
       }
+    } else if ( name == ATOM_jump )
+    { int64_t count;
+
+      if ( !PL_get_int64_ex(arg, &count) )
+	return FALSE;
+      if ( count < 0 )
+	return PL_error(NULL, 0, NULL, ERR_DOMAIN,
+			ATOM_not_less_than_zero, arg);
+      while ( count-- > 0 )
+      { rand_jump();
+	if ( count % 1024 == 0 && PL_handle_signals() < 0 )
+	  return FALSE;
+      }
+
+      return TRUE;
 #ifdef O_RANDOM_STATE
     } else if ( name == ATOM_state )
     { number n;
@@ -4513,12 +4972,8 @@ PRED_IMPL("set_random", 1, set_random, 0)
 	   n.type != V_MPZ )
 	return PL_error(NULL, 0, NULL, ERR_TYPE, ATOM_state, arg);
 
-#if O_GMP
-      mpz_set(LD->arith.random.state[0]._mp_seed, n.value.mpz);
-#elif O_BF
-      if ( bf_set_randstate(LD->arith.random.state, n.value.mpz) )
+      if ( !set_random_state(n.value.mpz) )
 	rc = PL_domain_error("random_state", arg);
-#endif
       clearNumber(&n);
 
       return rc;
@@ -4551,13 +5006,7 @@ PRED_IMPL("random_property", 1, random_property, 0)
 
       seed.type = V_MPZ;
       mpz_init(seed.value.mpz);
-#if O_GMP
-      LD->arith.random.state[0]._mp_seed[0]._mp_size =
-      LD->arith.random.state[0]._mp_seed[0]._mp_alloc;
-      mpz_set(seed.value.mpz, LD->arith.random.state[0]._mp_seed);
-#elif O_BF
-      bf_get_randstate(seed.value.mpz, LD->arith.random.state);
-#endif
+      get_random_state(seed.value.mpz);
       rc = PL_unify_number(arg, &seed);
       clearNumber(&seed);
 
@@ -4582,30 +5031,12 @@ ar_random(Number n1, Number r)
   init_random();
 
   switch(n1->type)
-  {
-#ifdef O_BIGNUM
-    case V_INTEGER:
-    {
-#if O_BF
-      int msb = MSB64(n1->value.i);
-      uint64_t mask = ((uint64_t)1<<(msb+1))-1;
-      uint64_t rnd;
-
-      do
-      { rnd = mt_rand_u32(LD->arith.random.state);
-	if ( msb > 32 )
-	  rnd |= (uint64_t)mt_rand_u32(LD->arith.random.state)<<32;
-	rnd &= mask;
-      } while(rnd >= n1->value.i);
-
+  { case V_INTEGER:
+      r->value.i = (int64_t)rand_below((uint64_t)n1->value.i);
       r->type = V_INTEGER;
-      r->value.i = rnd;
-      return TRUE;
-#endif
-      promoteToMPZNumber(n1);
-      assert(n1->type == V_MPZ);
-      /*FALLTHROUGH*/
-    }
+
+      succeed;
+#ifdef O_BIGNUM
     case V_MPZ:
     { r->type = V_MPZ;
       mpz_init(r->value.mpz);
@@ -4613,14 +5044,6 @@ ar_random(Number n1, Number r)
 
       succeed;
     }
-#else
-    case V_INTEGER:
-      if ( n1->value.i < 1 )
-	return mustBePositive("random", 1, n1);
-      r->value.i = _PL_Random() % (uint64_t)n1->value.i;
-      r->type = V_INTEGER;
-
-      succeed;
 #endif
     default:
       assert(0);
@@ -4628,37 +5051,110 @@ ar_random(Number n1, Number r)
   }
 }
 
-#ifndef UINT64_MAX
-#define UINT64_MAX (~(uint64_t)0)
-#endif
 
 static int
 ar_random_float(Number r)
 { GET_LD
 
   init_random();
+  r->value.f = rand_double();
+  r->type = V_FLOAT;
 
-  do
-  {
-#if O_GMP
-    mpf_t rop;
-    mpf_init2(rop, sizeof(double)*8);
-    mpf_urandomb(rop, LD->arith.random.state, sizeof(double)*8);
-    r->value.f = mpf_get_d(rop);
-    mpf_clear(rop);
-#elif O_BF
-    uint64_t l = mt_rand_u32(LD->arith.random.state);
-    uint64_t h = mt_rand_u32(LD->arith.random.state);
-    uint64_t i = (l<<32) | h;
+  succeed;
+}
 
-    r->value.f = (double)i/(double)0xffffffffffffffff;
-#else
-    r->value.f = _PL_Random()/(float)UINT64_MAX;
-#endif
-  } while (r->value.f == 0.0);
 
-  r->type = V_FLOAT;
-  succeed;
+/* - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+random_numbers(+Count, +Bound, -List)
+    List is a list of Count random  numbers.   If  Bound  is an integer,
+    these are integers in [0..Bound).  If Bound is a float, these are
+    floats between 0.0 and Bound.  This is the same as calling random/1 or
+    random_float/0 Count times, but avoids evaluation for each element.
+- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
+static
+PRED_IMPL("random_numbers", 3, random_numbers, 0)
+{ PRED_LD
+  size_t len;
+  number bound;
+  size_t cell;
+  term_t list;
+  Word p;
+
+  if ( !PL_get_size_ex(A1, &len) )
+    return FALSE;
+  if ( !PL_get_number(A2, &bound) )
+    return PL_error(NULL, 0, NULL, ERR_TYPE, ATOM_number, A2);
+
+  switch(bound.type)
+  { case V_INTEGER:
+      if ( bound.value.i <= 0 )
+	return PL_error(NULL, 0, NULL, ERR_DOMAIN, ATOM_not_less_than_one, A2);
+      cell = ( bound.value.i-1 <= PLMAXTAGGEDINT ? 3 : 3+4 );
+      break;
+    case V_FLOAT:
+      if ( !(bound.value.f > 0.0) || isinf(bound.value.f) )
+	return PL_error(NULL, 0, NULL, ERR_DOMAIN, ATOM_not_less_than_zero, A2);
+      cell = 3+2+WORDS_PER_DOUBLE;
+      break;
+    default:				/* bignum or rational bound */
+    { term_t tail = PL_copy_term_ref(A3);
+      term_t head = PL_new_term_ref();
+      int rc = TRUE;
+
+      while( rc && len-- > 0 )
+      { number r;
+
+	if ( (rc=ar_random(&bound, &r)) )
+	{ rc = ( PL_unify_list(tail, head, tail) &&
+		 PL_unify_number(head, &r) );
+	  clearNumber(&r);
+	}
+      }
+      clearNumber(&bound);
+
+      return rc && PL_unify_nil(tail);
+    }
+  }
+
+  if ( len == 0 )
+    return PL_unify_nil(A3);
+  if ( len > (size_t)(PLMAXINT/sizeof(word))/cell )
+    return outOfStack((Stack)&LD->stacks.global, STACK_OVERFLOW_RAISE);
+  if ( !hasGlobalSpace(len*cell) )
+  { int rc;
+
+    if ( (rc=ensureGlobalSpace(len*cell, ALLOW_GC)) != TRUE )
+      return raiseStackOverflow(rc);
+  }
+
+  init_random();
+  list = PL_new_term_ref();
+  p = gTop;
+  gTop += len*3;			/* list skeleton, elements follow */
+  *valTermRef(list) = consPtr(p, TAG_COMPOUND|STG_GLOBAL);
+  if ( bound.type == V_INTEGER )
+  { uint64_t n = (uint64_t)bound.value.i;
+
+    while(len-- > 0)
+    { p[0] = FUNCTOR_dot2;
+      put_int64(&p[1], (int64_t)rand_below(n), ALLOW_CHECKED);
+      p[2] = consPtr(&p[3], TAG_COMPOUND|STG_GLOBAL);
+      p += 3;
+    }
+  } else
+  { double f = bound.value.f;
+
+    while(len-- > 0)
+    { p[0] = FUNCTOR_dot2;
+      put_double(&p[1], rand_double()*f, ALLOW_CHECKED);
+      p[2] = consPtr(&p[3], TAG_COMPOUND|STG_GLOBAL);
+      p += 3;
+    }
+  }
+  p[-1] = ATOM_nil;
+
+  return PL_unify(A3, list);
 }
 
 
@@ -4813,6 +5309,27 @@ PRED_IMPL("current_arithmetic_function", 1, current_arithmetic_function,
 }
 
 
+/* - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+The vector functions (see pl-vector.c) are evaluated by valueExpression()
+before their argument is evaluated.  They are registered with the  stubs
+below, such that current_arithmetic_function/1 knows about them.
+- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
+static int
+ar_vector1(Number n1, Number r)
+{ (void)r;
+
+  return PL_error(NULL, 0, NULL, ERR_AR_TYPE, ATOM_vector, n1);
+}
+
+static int
+ar_vector2(Number n1, Number n2, Number r)
+{ (void)n2;
+
+  return ar_vector1(n1, r);
+}
+
+
 typedef struct
 { functor_t	functor;
   ArithF	function;
@@ -4860,6 +5377,11 @@ static const ar_funcdef ar_funcdefs[] = {
   ADD(FUNCTOR_random1,		ar_random, 0),
   ADD(FUNCTOR_random_float0,	ar_random_float, 0),
 
+  ADD(FUNCTOR_sum_vector1,	ar_vector1, 0),
+  ADD(FUNCTOR_min_vector1,	ar_vector1, 0),
+  ADD(FUNCTOR_max_vector1,	ar_vector1, 0),
+  ADD(FUNCTOR_dot_vector2,	ar_vector2, 0),
+
   ADD(FUNCTOR_integer1,		ar_integer, F_ISO),
   ADD(FUNCTOR_round1,		ar_integer, F_ISO),
   ADD(FUNCTOR_truncate1,	ar_truncate, F_ISO),
@@ -5295,6 +5817,499 @@ ar_func_n(DECL_LD int findex, int argc)
   return rval;
 }
 
+
+		 /*******************************
+		 *     COMPILED EXPRESSIONS	*
+		 *******************************/
+
+/* - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+compile_expression(+Expr, -Compiled) translates an expression into the
+same postfix code the clause compiler emits  for  is/2 (see
+compileArithArgument() in pl-comp.c), but stored in a blob and with
+the variables of Expr replaced by parameters. eval_expression/3 runs
+this code on the arithmetic stack. Functions are called through their
+index in GD->arith.functions, so evaluation neither walks the term nor
+looks up functors.
+
+The blob is PL_BLOB_UNIQUE.  Compiling two expressions that are
+variants of each other returns the same blob and unused compiled
+expressions are reclaimed by atom garbage collection.  The function
+indices make the code specific to the running process; compiled
+expressions cannot be saved.
+- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
+#define EX_PARAM	0		/* index */
+#define EX_INTEGER	1		/* intptr_t */
+#define EX_INT64	2		/* int64_t (32-bit systems) */
+#define EX_MPZ		3		/* indirect */
+#define EX_MPQ		4		/* indirect */
+#define EX_DOUBLE	5		/* double */
+#define EX_ADD		6
+#define EX_MUL		7
+#define EX_FUNC		8		/* index, arity */
+#define EX_ROUNDTOWARD	9		/* mode */
+
+typedef struct arith_expr
+{ code		params;			/* # parameters */
+  code		codes[];		/* postfix code */
+} arith_expr;
+
+static int
+write_arith_expr(IOSTREAM *s, atom_t aref, int flags)
+{ const arith_expr *e = PL_blob_data(aref, NULL, NULL);
+  (void)flags;
+
+  Sfprintf(s, "<arith_expression>(%zd,%p)", (size_t)e->params, e);
+  return TRUE;
+}
+
+static PL_blob_t arith_expr_blob =
+{ PL_BLOB_MAGIC,
+  PL_BLOB_UNIQUE,
+  "arith_expression",
+  NULL,
+  NULL,
+  write_arith_expr
+};
+
+typedef struct
+{ tmp_buffer	codes;			/* generated code */
+  tmp_buffer	vars;			/* Word: the parameter variables */
+} expr_compiler;
+
+
+static int
+expr_param(expr_compiler *c, Word p)
+{ Word *vars = baseBuffer(&c->vars, Word);
+  size_t n = entriesBuffer(&c->vars, Word);
+
+  for(size_t i=0; i<n; i++)
+  { if ( vars[i] == p )
+      return (int)i;
+  }
+
+  return -1;
+}
+
+
+/* Collect the variables of Expr in the order of term_variables/2 */
+
+#define expr_variables(c, p) LDFUNC(expr_variables, c, p)
+static void
+expr_variables(DECL_LD expr_compiler *c, Word p)
+{ for(;;)
+  { deRef(p);
+
+    if ( isVar(*p) )
+    { if ( expr_param(c, p) < 0 )
+	addBuffer(&c->vars, p, Word);
+      return;
+    } else if ( isTerm(*p) )
+    { size_t arity = arityTerm(*p);
+      Word a = argTermP(*p, 0);
+
+      for(; arity > 1; arity--, a++)
+	expr_variables(c, a);
+      p = a;
+    } else
+      return;
+  }
+}
+
+
+#define compile_expr(p, c) LDFUNC(compile_expr, p, c)
+static int
+compile_expr(DECL_LD Word p, expr_compiler *c)
+{ functor_t fdef;
+  size_t ar;
+  int index;
+  Word a;
+
+  deRef(p);
+
+  if ( isVar(*p) )
+  { if ( (index = expr_param(c, p)) < 0 )
+      return PL_error(NULL, 0, NULL, ERR_INSTANTIATION);
+    addBuffer(&c->codes, EX_PARAM, code);
+    addBuffer(&c->codes, (code)index, code);
+    return TRUE;
+  }
+  if ( isRational(*p) )
+  { if ( storage(*p) == STG_INLINE ||
+	 wsizeofInd(*addressIndirect(*p)) == WORDS_PER_INT64 )
+    { int64_t val = valInteger(*p);
+
+      if ( val >= INTPTR_MIN && val <= INTPTR_MAX )
+      { addBuffer(&c->codes, EX_INTEGER, code);
+	addBuffer(&c->codes, (code)(intptr_t)val, code);
+      } else
+      { addBuffer(&c->codes, EX_INT64, code);
+	addMultipleBuffer(&c->codes, &val, WORDS_PER_INT64, code);
+      }
+#ifdef O_BIGNUM
+    } else
+    { Word ip = addressIndirect(*p);
+      size_t n = wsizeofInd(*ip);
+
+      addBuffer(&c->codes, (ip[1]&MP_RAT_MASK) ? EX_MPQ : EX_MPZ, code);
+      addMultipleBuffer(&c->codes, ip, n+1, code);
+#endif
+    }
+    return TRUE;
+  }
+  if ( isFloat(*p) )
+  { addBuffer(&c->codes, EX_DOUBLE, code);
+    addMultipleBuffer(&c->codes, valIndirectP(*p), WORDS_PER_DOUBLE, code);
+    return TRUE;
+  }
+
+  if ( isTextAtom(*p) )
+  { fdef = lookupFunctorDef(*p, 0);
+    ar = 0;
+    a = NULL;
+  } else if ( isTerm(*p) )
+  { fdef = functorTerm(*p);
+    ar = arityFunctor(fdef);
+    a = argTermP(*p, 0);
+  } else if ( isString(*p) )
+  { number n;
+
+  case_char_constant:
+    if ( getCharExpression(p, &n) != TRUE )
+      return FALSE;
+    addBuffer(&c->codes, EX_INTEGER, code);
+    addBuffer(&c->codes, (code)n.value.i, code);
+    return TRUE;
+  } else
+  { PL_error(NULL, 0, NULL, ERR_TYPE, ATOM_evaluable, pushWordAsTermRef(p));
+    popTermRef();
+    return FALSE;
+  }
+
+  if ( fdef == FUNCTOR_dot2 )		/* "char" */
+    goto case_char_constant;
+
+  if ( (index = indexArithFunction(fdef)) < 0 )
+    return PL_error(NULL, 0, NULL, ERR_NOT_EVALUABLE, fdef);
+  if ( isVectorFunction(fdef) )
+  { PL_error(NULL, 0, "vector functions cannot be compiled",
+	     ERR_TYPE, ATOM_evaluable, pushWordAsTermRef(p));
+    popTermRef();
+    return FALSE;
+  }
+
+  if ( fdef == FUNCTOR_roundtoward2 )
+  { Word m;
+    int mode;
+
+    deRef2(a+1, m);
+    if ( !isAtom(*m) )
+    { PL_error(NULL, 0, NULL, ERR_TYPE, ATOM_atom, pushWordAsTermRef(m));
+      popTermRef();
+      return FALSE;
+    }
+    if ( !atom_to_rounding(*m, &mode) )
+    { PL_error(NULL, 0, NULL, ERR_DOMAIN, ATOM_round, pushWordAsTermRef(m));
+      popTermRef();
+      return FALSE;
+    }
+    addBuffer(&c->codes, EX_ROUNDTOWARD, code);
+    addBuffer(&c->codes, (code)mode, code);
+    if ( !compile_expr(a, c) )
+      return FALSE;
+  } else
+  { for(size_t i=ar; i-- > 0; )		/* pushed right to left */
+    { if ( !compile_expr(a+i, c) )
+	return FALSE;
+    }
+  }
+
+  if ( fdef == FUNCTOR_plus2 )
+  { addBuffer(&c->codes, EX_ADD, code);
+  } else if ( fdef == FUNCTOR_star2 )
+  { addBuffer(&c->codes, EX_MUL, code);
+  } else
+  { addBuffer(&c->codes, EX_FUNC, code);
+    addBuffer(&c->codes, (code)index, code);
+    addBuffer(&c->codes, (code)ar, code);
+  }
+
+  return TRUE;
+}
+
+
+/* Both expr_variables() and compile_expr() recurse on the arguments,
+   so a deeply nested expression may overflow the C stack.  The caller
+   runs this inside C_STACK_OVERFLOW_GUARDED().
+*/
+
+#define compile_expression_guarded(c, expr, params) \
+	LDFUNC(compile_expression_guarded, c, expr, params)
+static int
+compile_expression_guarded(DECL_LD expr_compiler *c,
+			   term_t expr, term_t params)
+{ if ( params )
+  { term_t tail = PL_copy_term_ref(params);
+    term_t head = PL_new_term_ref();
+
+    while( PL_get_list(tail, head, tail) )
+    { Word p = valTermRef(head);
+
+      deRef(p);
+      if ( isVar(*p) )
+	addBuffer(&c->vars, p, Word);
+      else
+	return PL_error(NULL, 0, NULL, ERR_UNINSTANTIATION, 2, head);
+    }
+    if ( !PL_get_nil_ex(tail) )
+      return FALSE;
+  } else
+  { expr_variables(c, valTermRef(expr));
+  }
+
+  return compile_expr(valTermRef(expr), c);
+}
+
+
+#define compile_expression(expr, params, compiled) \
+	LDFUNC(compile_expression, expr, params, compiled)
+static int
+compile_expression(DECL_LD term_t expr, term_t params, term_t compiled)
+{ expr_compiler c;
+  int rc;
+
+  if ( !PL_is_acyclic(expr) )
+    return PL_error(NULL, 0, "cyclic term", ERR_TYPE, ATOM_expression, expr);
+
+  initBuffer(&c.codes);
+  initBuffer(&c.vars);
+  addBuffer(&c.codes, 0, code);		/* arith_expr.params */
+
+  C_STACK_OVERFLOW_GUARDED(
+      rc,
+      compile_expression_guarded(&c, expr, params),
+      (void)0);				/* buffers are discarded below */
+
+  if ( rc )
+  { arith_expr *e = baseBuffer(&c.codes, arith_expr);
+
+    e->params = entriesBuffer(&c.vars, Word);
+    rc = PL_unify_blob(compiled, e, sizeOfBuffer(&c.codes),
+		       &arith_expr_blob);
+  }
+
+  discardBuffer(&c.codes);
+  discardBuffer(&c.vars);
+
+  return rc;
+}
+
+
+static
+PRED_IMPL("compile_expression", 2, compile_expression, 0)
+{ PRED_LD
+
+  return compile_expression(A1, 0, A2);
+}
+
+
+static
+PRED_IMPL("compile_expression", 3, compile_expression, 0)
+{ PRED_LD
+
+  return compile_expression(A1, A2, A3);
+}
+
+
+/* Run the code of e on the arithmetic stack.  On success, the result is
+   in r.  On failure, the values pushed by this call are discarded.
+*/
+
+#define eval_arith_expr(e, end, params, ctx, r) \
+	LDFUNC(eval_arith_expr, e, end, params, ctx, r)
+static int
+eval_arith_expr(DECL_LD const arith_expr *e, const code *end,
+		Number params, ar_context *ctx, Number r)
+{ size_t base = LD->arith.stack.top - LD->arith.stack.base;
+  const code *pc = e->codes;
+
+  while( pc < end )
+  { switch(*pc++)
+    { case EX_PARAM:
+      { Number n = allocArithStack();
+	Number p = &params[*pc++];
+
+	if ( p->type == V_INTEGER || p->type == V_FLOAT )
+	  *n = *p;
+	else
+	  cpNumber(n, p);
+	break;
+      }
+      case EX_INTEGER:
+      { Number n = allocArithStack();
+
+	n->value.i = (intptr_t)*pc++;
+	n->type    = V_INTEGER;
+	break;
+      }
+      case EX_INT64:
+      { Number n = allocArithStack();
+
+	memcpy(&n->value.i, pc, sizeof(int64_t));
+	n->type = V_INTEGER;
+	pc += WORDS_PER_INT64;
+	break;
+      }
+#ifdef O_BIGNUM
+      case EX_MPZ:
+      { Number n = allocArithStack();
+
+	n->type = V_MPZ;
+	pc = get_mpz_from_code((Code)pc, n->value.mpz);
+	break;
+      }
+      case EX_MPQ:
+      { Number n = allocArithStack();
+
+	n->type = V_MPQ;
+	pc = get_mpq_from_code((Code)pc, n->value.mpq);
+	break;
+      }
+#endif
+      case EX_DOUBLE:
+      { Number n = allocArithStack();
+
+	memcpy(&n->value.f, pc, sizeof(double));
+	n->type = V_FLOAT;
+	pc += WORDS_PER_DOUBLE;
+	break;
+      }
+      case EX_ADD:
+      case EX_MUL:
+      { Number argv = argvArithStack(2);
+	number tmp;
+	int rc;
+
+	if ( pc[-1] == EX_ADD )
+	  rc = pl_ar_add(argv+1, argv, &tmp);
+	else
+	  rc = ar_mul(argv+1, argv, &tmp);
+	popArgvArithStack(2);
+	if ( !rc )
+	  goto error;
+	pushArithStack(&tmp);
+	break;
+      }
+      case EX_FUNC:
+      { int index = (int)pc[0];
+	int argc  = (int)pc[1];
+
+	pc += 2;
+	if ( !ar_func_n(index, argc) )
+	  goto error;
+	break;
+      }
+      case EX_ROUNDTOWARD:
+      { Number n = allocArithStack();
+
+	ctx->femode = n->value.i = fegetround();
+	n->type = V_INTEGER;
+	set_rounding((int)*pc++);
+	break;
+      }
+      default:
+	assert(0);
+    }
+  }
+
+  assert(LD->arith.stack.top - LD->arith.stack.base == base+1);
+  *r = *--LD->arith.stack.top;
+  return TRUE;
+
+error:
+  popArgvArithStack((int)(LD->arith.stack.top - LD->arith.stack.base - base));
+  return FALSE;
+}
+
+
+static
+PRED_IMPL("eval_expression", 3, eval_expression, 0)
+{ PRED_LD
+  AR_CTX
+  void *data;
+  size_t len, n, i;
+  PL_blob_t *type;
+  const arith_expr *e;
+  number pbuf[8];
+  Number params = pbuf;
+  term_t tail, head;
+  number r;
+  int rc;
+
+  if ( !PL_get_blob(A1, &data, &len, &type) || type != &arith_expr_blob )
+    return PL_error(NULL, 0, NULL, ERR_TYPE, ATOM_arith_expression, A1);
+  e = data;
+
+  switch(PL_skip_list(A2, 0, &n))
+  { case PL_LIST:
+      break;
+    case PL_PARTIAL_LIST:
+      return PL_error(NULL, 0, NULL, ERR_INSTANTIATION);
+    default:
+      return PL_error(NULL, 0, NULL, ERR_TYPE, ATOM_list, A2);
+  }
+  if ( n != e->params )
+    return PL_error(NULL, 0, "wrong number of arguments",
+		    ERR_DOMAIN, ATOM_arity, A2);
+
+  if ( !hasGlobalSpace(0) )		/* see is/2 */
+  { if ( (rc=ensureGlobalSpace(0, ALLOW_GC)) != TRUE )
+      return raiseStackOverflow(rc);
+  }
+  if ( n > sizeof(pbuf)/sizeof(pbuf[0]) )
+    params = PL_malloc(n*sizeof(*params));
+
+  tail = PL_copy_term_ref(A2);
+  head = PL_new_term_ref();
+  AR_BEGIN();
+  for(i=0, rc=TRUE; i<n && rc; i++)
+  { Word p;
+
+    PL_get_list(tail, head, tail);
+    p = valTermRef(head);
+    deRef(p);
+    if ( isTaggedInt(*p) )
+    { params[i].value.i = valInt(*p);
+      params[i].type = V_INTEGER;
+    } else if ( isFloat(*p) )
+    { params[i].value.f = valFloat(*p);
+      params[i].type = V_FLOAT;
+    } else if ( isRational(*p) )
+    { get_rational(*p, &params[i]);
+    } else if ( !(rc=valueExpression(head, &params[i])) )
+    { i--;
+    }
+  }
+
+  if ( rc )
+    rc = eval_arith_expr(e, (const code*)((char*)data+len), params,
+			 &__PL_ar_ctx, &r);
+  while( i-- > 0 )
+    clearNumber(&params[i]);
+  if ( params != pbuf )
+    PL_free(params);
+
+  if ( rc )
+  { rc = PL_unify_number(A3, &r);
+    clearNumber(&r);
+    AR_END();
+  } else
+  { AR_CLEANUP();
+  }
+
+  return rc;
+}
+
 #endif /* O_COMPILE_ARITH */
 
 
@@ -5363,6 +6378,11 @@ BeginPredDefs(arith)
 
   PRED_DEF("current_arithmetic_function", 1, current_arithmetic_function,
 	   PL_FA_NONDETERMINISTIC)
+#if O_COMPILE_ARITH
+  PRED_DEF("compile_expression", 2, compile_expression, 0)
+  PRED_DEF("compile_expression", 3, compile_expression, 0)
+  PRED_DEF("eval_expression", 3, eval_expression, 0)
+#endif
 
 #ifdef O_BIGNUM
   PRED_DEF("divmod", 4, divmod, 0)
@@ -5371,6 +6391,7 @@ BeginPredDefs(arith)
   PRED_DEF("rational", 3, rational, 0)
 #endif
   PRED_DEF("set_random", 1, set_random, 0)
+  PRED_DEF("random_numbers", 3, random_numbers, 0)
 #ifdef O_RANDOM_STATE
   PRED_DEF("random_property", 1, random_property, 0)
 #endif
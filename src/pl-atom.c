@@ -70,10 +70,13 @@ table now uses a lock-free algorithm.  This works as follows:
     - If not, but the atom table has changed we retry, now using
       the new table where all atoms are properly linked again.
     - If the resize is in progress though, we may not find the
-      atom.  In that case we create a new one.  As our hash-table
-      is still too small, we lock and call rehashAtoms().  So,
-      when we get to linking the new atom into the hash-table,
-      we will find the table is old, destroy the atom and redo.
+      atom.  In that case we would create a new one.  As our
+      hash-table is still too small, we call growAtomTable() to
+      help moving atoms to the new table (see migrateAtoms()) and
+      wait for the resize to complete, after which we redo the
+      lookup.  If we passed this test and get to linking the new
+      atom into the hash-table, we will find the table is old,
+      destroy the atom and redo.
 
   - The creation of an atom needs to guarantee that it is added
     to the latest table and only added once.  We do this by creating
@@ -203,9 +206,15 @@ Note that threads can mark their atoms and continue execution because:
 - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
 
 static int	rehashAtoms(void);
+static void	migrateAtoms(AtomTable newtab);
+static void	growAtomTable(void);
 static void	considerAGC(void);
 static unsigned int register_atom(volatile Atom p);
 static unsigned int unregister_atom(volatile Atom p);
+#ifdef O_ATOMGC
+static void	flush_atom_cache(PL_local_data_t *ld);
+static void	flush_thread_atom_cache(PL_local_data_t *ld, void *ctx);
+#endif
 #ifdef O_DEBUG_ATOMGC
 static int	tracking(const Atom a);
 IOSTREAM *atomLogFd = 0;
@@ -411,11 +420,27 @@ static const ccharp atoms[] = {
 It might be wise to  provide  for   an  option  that does not reallocate
 atoms. In that case accessing a GC'ed   atom  causes a crash rather then
 another atom.
+
+The write_types block holds a byte per  atom   for  the writer (see
+pl-write.c). It is allocated before the atom   block  such that it is
+available as soon as atoms can be created in the block.
 - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
 
 static void
 allocateAtomBlock(int idx)
-{ if ( !GD->atoms.array.blocks[idx] )
+{ if ( !GD->atoms.array.write_types[idx] )
+  { size_t bs = (size_t)1<<idx;
+    unsigned char *newblock;
+
+    if ( !(newblock=PL_malloc_uncollectable(bs)) )
+      outOfCore();
+
+    memset(newblock, 0, bs);
+    if ( !COMPARE_AND_SWAP_PTR(&GD->atoms.array.write_types[idx],
+			   NULL, newblock-bs) )
+      PL_free(newblock);
+  }
+  if ( !GD->atoms.array.blocks[idx] )
   { size_t bs = (size_t)1<<idx;
     size_t i;
     Atom newblock;
@@ -518,6 +543,10 @@ bypassed the LOCK as either GD->atoms.rehashing is TRUE or the new table
 is activated.
 - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
 
+#define CACHED_ATOM_TYPE(type) \
+	( alltrue(type, PL_BLOB_UNIQUE|PL_BLOB_TEXT) && \
+	  false(type, PL_BLOB_NOCOPY) )
+
 static int
 same_name(const Atom a, const char *s, size_t length, const PL_blob_t *type)
 { if ( false(type, PL_BLOB_NOCOPY) )
@@ -527,6 +556,23 @@ same_name(const Atom a, const char *s, size_t length, const PL_blob_t *type)
 }
 
 
+/* - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+atom_hash() computes the hash  for  an   atom.  Besides  locating the atom in
+the atom table, Atom->hash_value is used by term_hash/2 and term_hash/4
+(see atom_term_hash()).  These hashes may be  stored by the user and thus
+must not change, which is why atoms keep using MurmurHashAligned2() rather
+than WyHash32().
+- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
+static unsigned int
+atom_hash(const char *s, size_t length, const PL_blob_t *type)
+{ if ( alltrue(type, PL_BLOB_UNIQUE|PL_BLOB_NOCOPY) )
+    return MurmurHashAligned2(&s, sizeof(s), MURMUR_SEED);
+  else
+    return MurmurHashAligned2(s, length, MURMUR_SEED);
+}
+
+
 word
 lookupBlob(const char *s, size_t length, PL_blob_t *type, int *new)
 { GET_LD
@@ -534,16 +580,40 @@ lookupBlob(const char *s, size_t length, PL_blob_t *type, int *new)
   Atom *table;
   int buckets;
   Atom a, head;
+  int retry = FALSE;
 
   if ( !type->registered )		/* avoid deadlock */
     PL_register_blob_type(type);
 
-  if ( alltrue(type, PL_BLOB_UNIQUE|PL_BLOB_NOCOPY) )
-    v0 = MurmurHashAligned2(&s, sizeof(s), MURMUR_SEED);
-  else
-    v0 = MurmurHashAligned2(s, length, MURMUR_SEED);
+  v0 = atom_hash(s, length, type);
+
+#ifdef O_ATOMGC
+  if ( HAS_LD && CACHED_ATOM_TYPE(type) )
+  { Atom *cp = &LD->atoms.cache[v0 & (ATOM_CACHE_SIZE-1)];
+
+    do					/* claim the slot before looking */
+    { a = *cp;				/* at the atom: AGC may flush it */
+    } while ( a && !COMPARE_AND_SWAP_PTR(cp, a, NULL) );
+
+    if ( a )
+    { if ( a->hash_value == v0 &&
+	   a->length == length &&
+	   a->type == type &&
+	   same_name(a, s, length, type) )
+      { DEBUG(MSG_HASH_STAT, GD->atoms.cache_hits++);
+	*new = FALSE;			/* we pass the cache reference */
+	return a->atom;
+      }
+      if ( !COMPARE_AND_SWAP_PTR(cp, NULL, a) )
+	unregister_atom(a);
+    }
+  }
+#endif
 
 redo:
+  if ( retry )
+    ATOMIC_INC(&GD->atoms.retries);
+  retry = TRUE;
   acquire_atom_table(table, buckets);
 
   v  = v0 & (buckets-1);
@@ -579,15 +649,12 @@ redo:
     }
   }
 
-  if ( GD->atoms.table->buckets * 2 < GD->statistics.atoms )
-  { int rc;
-
-    PL_LOCK(L_REHASH_ATOMS);
-    rc = rehashAtoms();
-    PL_UNLOCK(L_REHASH_ATOMS);
-
-    if ( !rc )
-      outOfCore();
+  if ( GD->atoms.table->buckets * 2 < GD->statistics.atoms &&
+       GD->cleaning == CLN_NORMAL )
+  { release_atom_table();
+    release_atom_bucket();
+    growAtomTable();
+    goto redo;
   }
 
   if ( !( table == GD->atoms.table->table && head == table[v] ) )
@@ -596,6 +663,7 @@ redo:
   a = reserveAtom();
   a->length = length;
   a->type = type;
+  *atomWriteTypeP(a->atom) = 0;
   if ( false(type, PL_BLOB_NOCOPY) )
   { if ( type->padding )
     { size_t pad = type->padding;
@@ -1045,6 +1113,11 @@ pl_garbage_collect_atoms(void)
   PL_LOCK(L_REHASH_ATOMS);
   blockSignals(&set);
   t = CpuTime(CPU_USER);
+  if ( HAS_LD )
+    flush_atom_cache(LD);
+#ifdef O_PLMT
+  forThreadLocalDataUnsuspended(flush_thread_atom_cache, NULL);
+#endif
   unmarkAtoms();
   markAtomsOnStacks(LD, NULL);
 #ifdef O_PLMT
@@ -1133,6 +1206,99 @@ register_atom(volatile Atom p)
 }
 
 
+/* - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Thread atom cache
+
+Each thread keeps a small direct   mapped cache (LD->atoms.cache) of text
+atoms for which it owns  a   reference.  PL_unregister_atom() does not
+decrement the reference count of such an  atom, but moves the reference
+into the cache slot selected by the  hash   of  the atom. If lookupBlob()
+finds the text in the cache  or   PL_register_atom()  is  called on the
+cached atom, the reference is passed back to the caller. The very common
+sequence lookup/use/unregister on  hot  atoms   thus  does  not need the
+atomic operations on the shared  Atom->references   and  does not walk
+the shared hash bucket.
+
+As the cache holds a normal reference, cached  atoms are simply not AGC
+candidates. If a slot is reused, the  old   reference  is released by
+unregister_atom(). AGC flushes the caches of  all threads before it
+clears the marks and a thread's cache  is flushed when the thread
+terminates. Slots are updated using CAS,  which makes it safe for AGC
+to flush the cache of another thread  and for a signal handler to
+unregister atoms. If the owner loses the  race for a slot it simply
+uses the shared reference count.  As  another thread may flush the slot
+and release the atom at any time,  lookupBlob() first claims the slot
+and only then inspects the atom.  If the atom does not match, it is put
+back or, if the slot was filled meanwhile, released.
+- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
+#ifdef O_ATOMGC
+static int
+cache_atom_reference(Atom p)
+{ GET_LD
+
+  if ( HAS_LD && LD->magic == LD_MAGIC && CACHED_ATOM_TYPE(p->type) )
+  { Atom *cp = &LD->atoms.cache[p->hash_value & (ATOM_CACHE_SIZE-1)];
+    Atom old;
+
+    do
+    { old = *cp;
+    } while ( !COMPARE_AND_SWAP_PTR(cp, old, p) );
+
+    if ( old )
+      unregister_atom(old);
+
+    return TRUE;
+  }
+
+  return FALSE;
+}
+
+
+static int
+uncache_atom_reference(Atom p)
+{ GET_LD
+
+  if ( HAS_LD )
+  { Atom *cp = &LD->atoms.cache[p->hash_value & (ATOM_CACHE_SIZE-1)];
+
+    return *cp == p && COMPARE_AND_SWAP_PTR(cp, p, NULL);
+  }
+
+  return FALSE;
+}
+
+
+static void
+flush_atom_cache(PL_local_data_t *ld)
+{ for(int i=0; i<ATOM_CACHE_SIZE; i++)
+  { Atom a;
+
+    if ( (a=ld->atoms.cache[i]) &&
+	 COMPARE_AND_SWAP_PTR(&ld->atoms.cache[i], a, NULL) )
+      unregister_atom(a);
+  }
+}
+
+
+static void
+flush_thread_atom_cache(PL_local_data_t *ld, void *ctx)
+{ (void)ctx;
+
+  flush_atom_cache(ld);
+}
+#endif /*O_ATOMGC*/
+
+
+void
+freeAtomCache(PL_local_data_t *ld)
+{
+#ifdef O_ATOMGC
+  flush_atom_cache(ld);
+#endif
+}
+
+
 void
 (PL_register_atom)(atom_t a)
 {
@@ -1142,7 +1308,8 @@ void
   if ( index >= GD->atoms.builtin )
   { Atom p = fetchAtomArray(index);
 
-    register_atom(p);
+    if ( !uncache_atom_reference(p) )
+      register_atom(p);
   }
 #endif
 }
@@ -1270,7 +1437,8 @@ void
   { Atom p;
 
     p = fetchAtomArray(index);
-    unregister_atom(p);
+    if ( !cache_atom_reference(p) )
+      unregister_atom(p);
   }
 #endif
 }
@@ -1379,9 +1547,6 @@ checkAtoms_src(const char *file, int line)
 static int
 rehashAtoms(void)
 { AtomTable newtab;
-  uintptr_t mask;
-  size_t index;
-  int i, last=FALSE;
 
   if ( GD->cleaning != CLN_NORMAL )
     return TRUE;			/* no point anymore and foreign ->type */
@@ -1399,46 +1564,126 @@ rehashAtoms(void)
   }
   memset(newtab->table, 0, newtab->buckets * sizeof(Atom));
   newtab->prev = GD->atoms.table;
-  mask = newtab->buckets-1;
 
   DEBUG(MSG_HASH_STAT,
 	Sdprintf("rehashing atoms (%d --> %d)\n",
 		 GD->atoms.table->buckets, newtab->buckets));
 
   GD->atoms.rehashing = TRUE;
+  MEMORY_BARRIER();			/* See (**) in lookupBlob() */
+  newtab->migrate_high = GD->atoms.highest;
+  newtab->migrate_next = 1;
+  newtab->migrated     = 1;
+  MEMORY_BARRIER();
+  GD->atoms.migrating  = newtab;
 
-  for(index=1, i=0; !last; i++)
-  { size_t upto = (size_t)2<<i;
-    size_t high = GD->atoms.highest;
-    Atom b = GD->atoms.array.blocks[i];
+  migrateAtoms(newtab);
+  for(unsigned int spins=0; newtab->migrated < newtab->migrate_high; )
+    spin_wait(&spins);			/* wait for helpers */
 
-    if ( upto >= high )
-    { upto = high;
-      last = TRUE;
-    }
+  GD->atoms.migrating = NULL;
+  GD->atoms.table = newtab;
+  GD->atoms.rehashing = FALSE;
+  GD->atoms.rehashes++;
 
-    for(; index<upto; index++)
-    { volatile Atom a = b + index;
+  return TRUE;
+}
+
+
+/* - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+migrateAtoms() links the atoms into a new   table  that is being created
+by rehashAtoms(). The work is split  in   chunks  of ATOM_MIGRATE_CHUNK
+atoms. Chunks are claimed by  incrementing newtab->migrate_next. Besides
+the thread running rehashAtoms(), threads that   need the table to grow
+while it is being rehashed find  GD->atoms.migrating   set  in
+growAtomTable() and call migrateAtoms()   to  migrate chunks rather than
+blocking on L_REHASH_ATOMS until a single  thread has moved all atoms.
+Each thread adds the number of atoms it moved to newtab->migrated and
+rehashAtoms() installs the new table after this reaches migrate_high. As
+multiple threads add atoms to the same  bucket, the new buckets are
+updated using CAS.
+- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
+#define ATOM_MIGRATE_CHUNK 1024
+
+static void
+migrateAtoms(AtomTable newtab)
+{ uintptr_t mask = newtab->buckets-1;
+  size_t high = newtab->migrate_high;
+
+  for(;;)
+  { size_t index = ATOMIC_ADD(&newtab->migrate_next, ATOM_MIGRATE_CHUNK) -
+		   ATOM_MIGRATE_CHUNK;
+    size_t upto = index + ATOM_MIGRATE_CHUNK;
+
+    if ( index >= high )
+      break;
+    if ( upto > high )
+      upto = high;
+
+    for(size_t i=index; i<upto; i++)
+    { volatile Atom a = fetchAtomArray(i);
       unsigned int ref;
-redo:
-      ref = a->references;
-      if ( ATOM_IS_RESERVED(ref) )
-      { if ( !ATOM_IS_VALID(ref) )
-	  goto redo;
-	if ( true(a->type, PL_BLOB_UNIQUE) )
-	{ size_t v;
-	  v = a->hash_value & mask;
-	  a->next = newtab->table[v];
-	  newtab->table[v] = a;
-	}
+
+      while ( ATOM_IS_RESERVED(ref=a->references) && !ATOM_IS_VALID(ref) )
+	;				/* being created */
+
+      if ( ATOM_IS_RESERVED(ref) && true(a->type, PL_BLOB_UNIQUE) )
+      { Atom *bp = &newtab->table[a->hash_value & mask];
+	Atom head;
+
+	do
+	{ head = *bp;
+	  a->next = head;
+	} while ( !COMPARE_AND_SWAP_PTR(bp, head, a) );
       }
     }
+
+    ATOMIC_ADD(&newtab->migrated, upto-index);
   }
+}
 
-  GD->atoms.table = newtab;
-  GD->atoms.rehashing = FALSE;
 
-  return TRUE;
+/* - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Called by lookupBlob() if the table  is   too  small. If a rehash is in
+progress we help migrating. New atoms can  only be added to the new
+table, so after our work is done we   wait  for the other migrating
+threads to finish and the new table  to become active. We do not take
+L_REHASH_ATOMS in that case, but return  to lookupBlob() to redo the
+lookup. Otherwise we take the lock and  rehash. rehashAtoms() verifies
+the table is still too small, so threads   that found the table too
+small just before it was replaced  merely   wait  for the rehash to
+complete. Must be called without holding the atom table.
+- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
+static void
+growAtomTable(void)
+{ AtomTable newtab;
+  int rc;
+
+  if ( (newtab=GD->atoms.migrating) )
+  {
+#ifdef O_PLMT
+    GET_LD
+    LD->thread.info->access.atom_table = newtab;
+    MEMORY_BARRIER();
+    if ( GD->atoms.migrating == newtab )
+      migrateAtoms(newtab);
+    LD->thread.info->access.atom_table = NULL;
+#else
+    migrateAtoms(newtab);
+#endif
+    for(unsigned int spins=0; GD->atoms.migrating == newtab; )
+      spin_wait(&spins);
+    return;
+  }
+
+  PL_LOCK(L_REHASH_ATOMS);
+  rc = rehashAtoms();
+  PL_UNLOCK(L_REHASH_ATOMS);
+
+  if ( !rc )
+    outOfCore();
 }
 
 
@@ -1495,7 +1740,7 @@ resetListAtoms(void)
   modify:
     a->name   = s;
     a->length = strlen(s);
-    a->hash_value = MurmurHashAligned2(s, a->length, MURMUR_SEED);
+    a->hash_value = atom_hash(s, a->length, a->type);
     v = a->hash_value & (GD->atoms.table->buckets-1);
 
     a->next      = GD->atoms.table->table[v];
@@ -1535,7 +1780,7 @@ registerBuiltinAtoms(void)
       len = strlen(s);
     }
 
-    v0 = MurmurHashAligned2(s, len, MURMUR_SEED);
+    v0 = atom_hash(s, len, &text_atom);
     v  = v0 & (GD->atoms.table->buckets-1);
 
     a = &GD->atoms.array.blocks[idx][index];
@@ -1566,6 +1811,8 @@ exitAtoms(int status, void *context)
 
   Sdprintf("hashstat: %d lookupAtom() calls used %d strcmp() calls\n",
 	   GD->atoms.lookups, GD->atoms.cmps);
+  Sdprintf("hashstat: %d lookups from the thread atom cache\n",
+	   GD->atoms.cache_hits);
 
   return 0;
 }
@@ -1644,7 +1891,8 @@ cleanupAtoms(void)
   i = 0;
   while( GD->atoms.array.blocks[i] )
   { size_t bs = (size_t)1<<i;
-    PL_free(GD->atoms.array.blocks[i++] + bs);
+    PL_free(GD->atoms.array.blocks[i] + bs);
+    PL_free(GD->atoms.array.write_types[i++] + bs);
   }
 
   for(i=0; i<256; i++)			/* char-code -> char-atom map */
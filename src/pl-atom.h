@@ -47,6 +47,7 @@ word		lookupAtom(const char *s, size_t len);
 word		lookupBlob(const char *s, size_t len,
 			   PL_blob_t *type, int *new);
 word		pl_atom_hashstat(term_t i, term_t n);
+void		freeAtomCache(PL_local_data_t *ld);
 void		do_init_atoms(void);
 int		resetListAtoms(void);
 void		cleanupAtoms(void);
@@ -60,4 +61,13 @@ size_t		atom_space(void);
 word		pl_track_atom(term_t which, term_t stream);
 #endif
 
+/* atom_term_hash() returns the hash for an atom as used by term_hash/2
+   and term_hash/4.  See atom_hash() in pl-atom.c
+*/
+
+static inline unsigned int
+atom_term_hash(const Atom a)
+{ return a->hash_value;
+}
+
 #endif /*_PL_ATOM_H*/
\ No newline at end of file
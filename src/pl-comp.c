@@ -59,6 +59,7 @@
 #include "pl-gc.h"
 #include "pl-index.h"
 #include "pl-setup.h"
+#include "pl-vector.h"
 #include <limits.h>
 #ifdef HAVE_DLADDR
 #include <dlfcn.h>
@@ -1258,6 +1259,7 @@ Variable table operations.
 #define	compileSimpleAddition(Word, compileInfo)	LDFUNC(compileSimpleAddition, Word, compileInfo)
 #define	compileArith(Word, compileInfo)			LDFUNC(compileArith, Word, compileInfo)
 #define	compileArithArgument(Word, compileInfo)		LDFUNC(compileArithArgument, Word, compileInfo)
+#define	hasVectorFunction(Word)				LDFUNC(hasVectorFunction, Word)
 #define	compileBodyUnify(arg, ci)			LDFUNC(compileBodyUnify, arg, ci)
 #define	compileBodyEQ(arg, ci)				LDFUNC(compileBodyEQ, arg, ci)
 #define	compileBodyNEQ(arg, ci)				LDFUNC(compileBodyNEQ, arg, ci)
@@ -1282,6 +1284,7 @@ forwards bool	compileSimpleAddition(Word, compileInfo *);
 #if O_COMPILE_ARITH
 forwards int	compileArith(Word, compileInfo *);
 forwards bool	compileArithArgument(Word, compileInfo *);
+forwards int	hasVectorFunction(Word);
 #endif
 #if O_COMPILE_IS
 forwards int	compileBodyUnify(Word arg, compileInfo *ci);
@@ -2922,7 +2925,7 @@ A non-void variable. Create a I_USERCALL0 instruction for it.
 	   compileSimpleAddition(arg, ci) )
 	succeed;
 #if O_COMPILE_ARITH
-      if ( truePrologFlag(PLFLAG_OPTIMISE) )
+      if ( truePrologFlag(PLFLAG_OPTIMISE) && !hasVectorFunction(arg) )
 	 return compileArith(arg, ci);
 #endif
     }
@@ -3323,6 +3326,32 @@ compileArith(DECL_LD Word arg, compileInfo *ci)
 }
 
 
+/* Vector functions (see pl-vector.c) take a vector rather than a number
+   as argument.  Expressions using them are not compiled and left to the
+   arithmetic predicates.
+*/
+
+static int
+hasVectorFunction(DECL_LD Word p)
+{ deRef(p);
+
+  if ( isTerm(*p) )
+  { functor_t f = functorTerm(*p);
+    size_t arity = arityFunctor(f);
+    Word a = argTermP(*p, 0);
+
+    if ( isVectorFunction(f) )
+      return TRUE;
+    for(; arity-- > 0; a++)
+    { if ( hasVectorFunction(a) )
+	return TRUE;
+    }
+  }
+
+  return FALSE;
+}
+
+
 #define arithVarOffset(arg, ci, offp) LDFUNC(arithVarOffset, arg, ci, offp)
 static int
 arithVarOffset(DECL_LD Word arg, compileInfo *ci, int *offp)
@@ -774,13 +774,104 @@ again:
 }
 
 
+/* - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+quick_ground() tests whether a term is ground. This is a fast path for
+copy_term/2 on ground terms, where marking and unmarking the term for
+copying takes two passes that write to each compound.
+
+The first QUICK_GROUND_BUDGET argument cells are visited without marking.
+This is enough for most terms, but we cannot detect cycles or shared
+subterms and visit shared subterms as often as they are referenced. If
+the budget is exhausted we continue with the same agenda, now marking
+the compounds we visit such that each is visited only once, and push
+them on `marked` to clear the marks afterwards. The work done is thus
+linear in the size of the term, also for cyclic terms and ground terms
+with a lot of sharing, and the cells visited before the budget ran out
+are not visited again. We return TRUE if the term is ground, FALSE if we
+found a variable and -1 if we ran out of memory.
+- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
+#define QUICK_GROUND_BUDGET 4096
+
+#define quick_ground(p) LDFUNC(quick_ground, p)
+
+static int
+quick_ground(DECL_LD Word p)
+{ term_agenda agenda;
+  size_t budget = QUICK_GROUND_BUDGET;
+  int marking = FALSE;
+  int rc = TRUE;
+  Functor buf[256];
+  segstack marked;
+  Functor f;
+
+  initTermAgenda(&agenda, 1, p);
+  while((p=nextTermAgenda(&agenda)))
+  { if ( canBind(*p) )
+    { rc = FALSE;
+      break;
+    }
+    if ( isTerm(*p) )
+    { size_t i, arity;
+
+      f = valueTerm(*p);
+      arity = arityFunctor(f->definition);
+      if ( marking )
+      { if ( is_marked(&f->definition) )
+	  continue;
+	if ( !pushSegStack(&marked, f, Functor) )
+	{ rc = -1;
+	  break;
+	}
+	set_marked(&f->definition);
+      }
+
+      for(i=0; i<arity; i++)		/* find shallow variables early */
+      { Word a = &f->arguments[i];
+
+	deRef(a);
+	if ( canBind(*a) )
+	{ rc = FALSE;
+	  goto out;
+	}
+      }
+      if ( !marking )
+      { if ( arity > budget )
+	{ initSegStack(&marked, sizeof(Functor), sizeof(buf), buf);
+	  marking = TRUE;
+	} else
+	  budget -= arity;
+      }
+      if ( !pushWorkAgenda(&agenda, arity, f->arguments) )
+      { rc = -1;
+	break;
+      }
+    }
+  }
+
+out:
+  clearTermAgenda(&agenda);
+  if ( marking )
+  { while( popSegStack(&marked, &f, Functor) )
+      clear_marked(&f->definition);
+    clearSegStack(&marked);
+  }
+
+  return rc;
+}
+
+
 #define copy_term_refs(from, to, vars, abstract, flags) \
 	LDFUNC(copy_term_refs, from, to, vars, abstract, flags)
 
 static int
 copy_term_refs(DECL_LD term_t from, term_t to, term_t vars,
 	       size_t abstract, int flags)
-{ for(;;)
+{ if ( (flags&COPY_SHARE) && !vars &&
+       quick_ground(valTermRef(from)) == TRUE )
+    return PL_put_term(to, from);	/* ground terms are shared */
+
+  for(;;)
   { fid_t fid;
     int rc;
     Word dest, src;
@@ -0,0 +1,676 @@
+/*  Part of SWI-Prolog
+
+    Author:        agent
+    E-mail:        agent@local
+    WWW:           http://www.swi-prolog.org
+    Copyright (c)  2026, agent
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in
+       the documentation and/or other materials provided with the
+       distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "pl-counters.h"
+#include "pl-proc.h"
+#include "pl-comp.h"
+#include "pl-fli.h"
+#include "pl-alloc.h"
+#include <time.h>
+
+/* - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Lightweight port counters for selected predicates.  Counting is enabled
+using the `counted` and `count_latency` predicate attributes, which set
+P_COUNTED and P_COUNT_LATENCY.  The VM calls CountPort() on the call,
+redo, exit and exception ports.  For predicates that are not counted,
+this is a flag test on the running definition.
+
+Counters  are  kept  in  COUNTER_SHARDS  cache-line  sized  shards  per
+predicate.  Threads are mapped to a shard using their Prolog thread id,
+so threads normally update their own cache line.   The shards are added
+when the counters are read.
+
+As the tracer, we use FR_INBOX to distinguish a redo from trying the
+next clause after the previous one failed.  It is set on the call and
+redo ports and cleared by a non-deterministic exit (I_EXIT).
+
+Latency is the time between the call port and the exit port. It is only
+recorded if P_COUNT_LATENCY is set. On the call port we push the offset
+of the frame and the time on LD->counters.frames.  Entries for frames
+that are no longer alive (failed  or  unwound  by  an  exception)  are
+removed lazily: a new frame at offset  N  implies  that  all  frames  at
+offsets >= N are gone, and a deterministic  exit implies the same for
+all frames above the exiting one.  The  latency  is  recorded  in  an
+HDR-style log-linear histogram with LATENCY_SUB  sub-buckets  for  each
+power of two, i.e., with a relative error below 25%.
+
+Last-call optimization reuses the frame  for   the  last call, so the
+frame of the counted predicate never reaches I_EXIT. If the frame is
+reused (I_DEPART, I_LCALL and I_TCALL), count_lco() pushes the predicate
+on LD->counters.exits and sets FR_COUNTED_LCO on the frame.  When the
+reused frame exits or is unwound by an exception, count_lco_port()
+counts the same port for the predicates pushed for this frame.  If the
+frame fails, the entries are removed lazily as above.  A
+non-deterministic exit keeps the entries, so the exit is counted again
+if the frame exits after backtracking.  Repeated last calls to the same
+predicate in one frame, as in a tail-recursive loop, share an entry that
+counts them.  The latency of a call that ends in a last call is recorded
+when the last call starts and thus excludes the last call.
+
+Each shard is aligned to a cache line, so counting costs an uncontended
+atomic increment.  Counting all ports of a predicate that does little
+work still costs several percent (see the manual).
+- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
+#define COUNTER_SHARDS	  16		/* Must be a power of 2 */
+#define LATENCY_SUB_BITS  2
+#define LATENCY_SUB	  (1<<LATENCY_SUB_BITS)
+#define LATENCY_MAX_BITS  42		/* 2^42 ns is about 73 minutes */
+#define LATENCY_BUCKETS	  ((LATENCY_MAX_BITS-LATENCY_SUB_BITS+1)*LATENCY_SUB)
+#define MAX_COUNTED_FRAMES 1000000
+
+#define COUNT_CALL	0
+#define COUNT_REDO	1
+#define COUNT_EXIT	2
+#define COUNT_EXCEPTION	3
+#define COUNT_PORTS	4
+
+#define COUNTER_CACHE_LINE 64
+
+typedef struct counter_shard
+{ uint64_t	ports[COUNT_PORTS];	/* COUNT_* */
+  uint64_t	latency_sum;		/* Sum of recorded latencies (ns) */
+  uint64_t	padding[3];		/* Fill the cache line */
+} counter_shard;
+
+typedef struct pred_counters
+{ Definition	predicate;		/* Predicate we count */
+  struct pred_counters *next;		/* Next in GD->counters.list */
+  uint64_t     *latency;		/* [COUNTER_SHARDS][LATENCY_BUCKETS] */
+  counter_shard *shards;		/* [COUNTER_SHARDS], aligned */
+  void	       *shards_mem;		/* Allocated memory for shards */
+} pred_counters;
+
+typedef struct counted_frame
+{ size_t	frame;			/* Offset of the frame */
+  int64_t	start;			/* Time of the call port (ns) */
+} counted_frame;
+
+typedef struct counted_exit
+{ size_t	frame;			/* Offset of the reused frame */
+  Definition	predicate;		/* Predicate that made the last call */
+  uint64_t	count;			/* Number of last calls */
+} counted_exit;
+
+
+static int64_t
+counter_nanos(void)
+{
+#ifdef HAVE_CLOCK_GETTIME
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (int64_t)ts.tv_sec*1000000000 + ts.tv_nsec;
+#else
+  return (int64_t)(WallTime()*1e9);
+#endif
+}
+
+
+static unsigned int
+latency_bucket(uint64_t ns)
+{ int msb;
+
+  if ( ns < LATENCY_SUB )
+    return (unsigned int)ns;
+#ifdef HAVE_MSB64
+  msb = MSB64(ns);
+#else
+  for(msb=LATENCY_SUB_BITS; ns>>(msb+1); msb++)
+    ;
+#endif
+  if ( msb >= LATENCY_MAX_BITS )
+    return LATENCY_BUCKETS-1;
+
+  return ( (msb-LATENCY_SUB_BITS+1)*LATENCY_SUB +
+	   ((ns>>(msb-LATENCY_SUB_BITS))&(LATENCY_SUB-1)) );
+}
+
+/* Inclusive upper bound of a bucket in nanoseconds */
+
+static uint64_t
+latency_bucket_max(unsigned int i)
+{ unsigned int msb, sub;
+
+  if ( i < LATENCY_SUB )
+    return i;
+  msb = i/LATENCY_SUB + LATENCY_SUB_BITS - 1;
+  sub = i%LATENCY_SUB;
+
+  return ((uint64_t)(LATENCY_SUB+sub+1) << (msb-LATENCY_SUB_BITS)) - 1;
+}
+
+
+#define shard_index(_) LDFUNC(shard_index, _)
+static inline unsigned int
+shard_index(DECL_LD)
+{
+#ifdef O_PLMT
+  return LD->thread.info->pl_tid & (COUNTER_SHARDS-1);
+#else
+  return 0;
+#endif
+}
+
+
+		 /*******************************
+		 *	   LATENCY FRAMES	*
+		 *******************************/
+
+#define push_counted_frame(fr) LDFUNC(push_counted_frame, fr)
+static void
+push_counted_frame(DECL_LD LocalFrame fr)
+{ size_t off = (size_t)consTermRef(fr);
+  counted_frame *cf;
+
+  while ( LD->counters.top > 0 &&
+	  LD->counters.frames[LD->counters.top-1].frame >= off )
+    LD->counters.top--;
+
+  if ( LD->counters.top == LD->counters.size )
+  { size_t size = LD->counters.size ? LD->counters.size*2 : 64;
+    counted_frame *frames;
+
+    if ( size > MAX_COUNTED_FRAMES ||
+	 !(frames = realloc(LD->counters.frames, size*sizeof(*frames))) )
+      return;				/* do not time this call */
+    LD->counters.frames = frames;
+    LD->counters.size   = size;
+  }
+
+  cf = &LD->counters.frames[LD->counters.top++];
+  cf->frame = off;
+  cf->start = counter_nanos();
+}
+
+/* Find the start time of fr.  If the exit is deterministic, fr and all
+   frames above it are gone.
+*/
+
+#define pop_counted_frame(fr, det, start) \
+	LDFUNC(pop_counted_frame, fr, det, start)
+static int
+pop_counted_frame(DECL_LD LocalFrame fr, int det, int64_t *start)
+{ size_t off = (size_t)consTermRef(fr);
+  size_t top = LD->counters.top;
+  int found = FALSE;
+
+  while ( top > 0 && LD->counters.frames[top-1].frame > off )
+    top--;
+  if ( top > 0 && LD->counters.frames[top-1].frame == off )
+  { *start = LD->counters.frames[top-1].start;
+    found = TRUE;
+    if ( det )
+      top--;
+  }
+  if ( det )
+    LD->counters.top = top;
+
+  return found;
+}
+
+
+		 /*******************************
+		 *	      COUNTING		*
+		 *******************************/
+
+#define count_exit_latency(fr, pc, s, si) \
+	LDFUNC(count_exit_latency, fr, pc, s, si)
+static void
+count_exit_latency(DECL_LD LocalFrame fr, pred_counters *pc,
+		   counter_shard *s, unsigned int si)
+{ int64_t start;
+
+  if ( pc->latency &&
+       pop_counted_frame(fr, (void*)LD->choicepoints <= (void*)fr, &start) )
+  { int64_t ns = counter_nanos() - start;
+
+    if ( ns < 0 )
+      ns = 0;
+    ATOMIC_ADD(&s->latency_sum, ns);
+    ATOMIC_INC(&pc->latency[si*LATENCY_BUCKETS+latency_bucket(ns)]);
+  }
+}
+
+
+void
+count_port(DECL_LD LocalFrame fr, int port)
+{ Definition def = fr->predicate;
+  pred_counters *pc = def->counters;
+  counter_shard *s;
+  unsigned int si;
+
+  if ( !pc )
+    return;
+  si = shard_index();
+  s  = &pc->shards[si];
+
+  switch(port)
+  { case CALL_PORT:
+      ATOMIC_INC(&s->ports[COUNT_CALL]);
+      set(fr, FR_INBOX);
+      if ( true(def, P_COUNT_LATENCY) )
+	push_counted_frame(fr);
+      break;
+    case REDO_PORT:
+      if ( true(fr, FR_INBOX) )		/* next clause after a failure */
+	break;
+      set(fr, FR_INBOX);
+      ATOMIC_INC(&s->ports[COUNT_REDO]);
+      break;
+    case EXIT_PORT:
+      ATOMIC_INC(&s->ports[COUNT_EXIT]);
+      if ( true(def, P_COUNT_LATENCY) )
+	count_exit_latency(fr, pc, s, si);
+      break;
+    case EXCEPTION_PORT:
+      ATOMIC_INC(&s->ports[COUNT_EXCEPTION]);
+      break;
+    default:
+      ;
+  }
+}
+
+
+/* count_lco() is called if fr, running a counted predicate, is reused
+   for its last call.  Entries above fr are gone as LCO implies there are
+   no choicepoints.  If fr does not have FR_COUNTED_LCO, entries for fr
+   are left from a frame at the same offset that failed.
+*/
+
+void
+count_lco(DECL_LD LocalFrame fr)
+{ Definition def = fr->predicate;
+  pred_counters *pc = def->counters;
+  size_t off = (size_t)consTermRef(fr);
+  size_t top = LD->counters.exits_top;
+  counted_exit *ce;
+
+  if ( !pc )
+    return;
+  if ( true(def, P_COUNT_LATENCY) )
+  { unsigned int si = shard_index();
+
+    count_exit_latency(fr, pc, &pc->shards[si], si);
+  }
+
+  if ( true(fr, FR_COUNTED_LCO) )
+  { while ( top > 0 && LD->counters.exits[top-1].frame > off )
+      top--;
+    for(size_t i=top; i > 0 && LD->counters.exits[i-1].frame == off; i--)
+    { ce = &LD->counters.exits[i-1];
+      if ( ce->predicate == def )
+      { ce->count++;
+	LD->counters.exits_top = top;
+	return;
+      }
+    }
+  } else
+  { while ( top > 0 && LD->counters.exits[top-1].frame >= off )
+      top--;
+  }
+  LD->counters.exits_top = top;
+
+  if ( top == LD->counters.exits_size )
+  { size_t size = LD->counters.exits_size ? LD->counters.exits_size*2 : 16;
+    counted_exit *exits;
+
+    if ( size > MAX_COUNTED_FRAMES ||
+	 !(exits = realloc(LD->counters.exits, size*sizeof(*exits))) )
+    { ATOMIC_INC(&pc->shards[shard_index()].ports[COUNT_EXIT]);
+      return;				/* count the exit now */
+    }
+    LD->counters.exits      = exits;
+    LD->counters.exits_size = size;
+  }
+
+  ce = &LD->counters.exits[LD->counters.exits_top++];
+  ce->frame     = off;
+  ce->predicate = def;
+  ce->count     = 1;
+  set(fr, FR_COUNTED_LCO);
+}
+
+
+/* count_lco_port() is called on the exit and exception ports of a frame
+   with FR_COUNTED_LCO and counts the port for the predicates that made
+   a last call in this frame.  The entries are discarded if the frame
+   is gone.
+*/
+
+void
+count_lco_port(DECL_LD LocalFrame fr, int port)
+{ size_t off = (size_t)consTermRef(fr);
+  size_t top = LD->counters.exits_top;
+  int cport = (port == EXIT_PORT ? COUNT_EXIT : COUNT_EXCEPTION);
+  unsigned int si = shard_index();
+
+  while ( top > 0 && LD->counters.exits[top-1].frame > off )
+    top--;
+  for( ; top > 0 && LD->counters.exits[top-1].frame == off; top--)
+  { counted_exit *ce = &LD->counters.exits[top-1];
+    Definition def = ce->predicate;
+    pred_counters *pc;
+
+    if ( true(def, P_COUNTED) && (pc=def->counters) )
+      ATOMIC_ADD(&pc->shards[si].ports[cport], ce->count);
+  }
+
+  if ( port != EXIT_PORT || (void*)LD->choicepoints <= (void*)fr )
+  { LD->counters.exits_top = top;
+    clear(fr, FR_COUNTED_LCO);
+  }
+}
+
+
+		 /*******************************
+		 *	  (UN)REGISTRATION	*
+		 *******************************/
+
+#define SHARDS_ALLOC_SIZE \
+	(sizeof(counter_shard)*COUNTER_SHARDS + COUNTER_CACHE_LINE-1)
+
+static void
+free_counters(void *ptr)
+{ pred_counters *pc = ptr;
+
+  if ( pc->latency )
+    freeHeap(pc->latency, sizeof(uint64_t)*COUNTER_SHARDS*LATENCY_BUCKETS);
+  freeHeap(pc->shards_mem, SHARDS_ALLOC_SIZE);
+  freeHeap(pc, sizeof(*pc));
+}
+
+
+static void
+unregister_counters(pred_counters *pc)
+{ pred_counters **p;
+
+  PL_LOCK(L_MISC);
+  for(p = &GD->counters.list; *p; p = &(*p)->next)
+  { if ( *p == pc )
+    { *p = pc->next;
+      break;
+    }
+  }
+  PL_UNLOCK(L_MISC);
+}
+
+
+static pred_counters *
+def_counters(Definition def)
+{ pred_counters *pc;
+
+  if ( !(pc = def->counters) )
+  { uintptr_t a;
+
+    pc = allocHeapOrHalt(sizeof(*pc));
+    memset(pc, 0, sizeof(*pc));
+    pc->predicate  = def;
+    pc->shards_mem = allocHeapOrHalt(SHARDS_ALLOC_SIZE);
+    memset(pc->shards_mem, 0, SHARDS_ALLOC_SIZE);
+    a = ((uintptr_t)pc->shards_mem + COUNTER_CACHE_LINE-1) &
+	~(uintptr_t)(COUNTER_CACHE_LINE-1);
+    pc->shards = (counter_shard*)a;
+    PL_LOCK(L_MISC);
+    pc->next = GD->counters.list;
+    GD->counters.list = pc;
+    PL_UNLOCK(L_MISC);
+    MEMORY_RELEASE();
+    def->counters = pc;
+  }
+
+  return pc;
+}
+
+
+/* Called from setAttrDefinition() for P_COUNTED and P_COUNT_LATENCY.
+   Clearing P_COUNTED discards the counters.  Clearing P_COUNT_LATENCY
+   stops recording latency, but keeps the histogram.
+*/
+
+int
+setCountedDefinition(Definition def, uint64_t attr, int val)
+{ if ( val && true(def, P_FOREIGN) )
+  { GET_LD
+    term_t pi;
+
+    return ( (pi=PL_new_term_ref()) &&
+	     unify_definition(MODULE_user, pi, def, 0,
+			      GP_NAMEARITY|GP_HIDESYSTEM) &&
+	     PL_error(NULL, 0, "foreign predicates cannot be counted",
+		      ERR_PERMISSION, ATOM_count, ATOM_procedure, pi) );
+  }
+
+  LOCKDEF(def);
+  if ( val )
+  { pred_counters *pc = def_counters(def);
+
+    if ( attr == P_COUNT_LATENCY && !pc->latency )
+    { size_t bytes = sizeof(uint64_t)*COUNTER_SHARDS*LATENCY_BUCKETS;
+      uint64_t *latency = allocHeapOrHalt(bytes);
+
+      memset(latency, 0, bytes);
+      MEMORY_RELEASE();
+      pc->latency = latency;
+    }
+    set(def, P_COUNTED|attr);
+  } else if ( attr == P_COUNT_LATENCY )
+  { clear(def, P_COUNT_LATENCY);
+  } else
+  { pred_counters *pc = def->counters;
+
+    clear(def, P_COUNTED|P_COUNT_LATENCY);
+    if ( pc )
+    { def->counters = NULL;
+      unregister_counters(pc);
+      linger(&def->lingering, free_counters, pc);
+    }
+  }
+  UNLOCKDEF(def);
+
+  return TRUE;
+}
+
+
+void
+freeDefinitionCounters(Definition def)
+{ pred_counters *pc = def->counters;
+
+  if ( pc )
+  { def->counters = NULL;
+    unregister_counters(pc);
+    free_counters(pc);
+  }
+}
+
+
+void
+freeCountersLocalData(PL_local_data_t *ld)
+{ if ( ld->counters.frames )
+  { free(ld->counters.frames);
+    ld->counters.frames = NULL;
+    ld->counters.top = ld->counters.size = 0;
+  }
+  if ( ld->counters.exits )
+  { free(ld->counters.exits);
+    ld->counters.exits = NULL;
+    ld->counters.exits_top = ld->counters.exits_size = 0;
+  }
+}
+
+
+		 /*******************************
+		 *	  PROLOG BINDING	*
+		 *******************************/
+
+static int
+unify_call_counts(pred_counters *pc, term_t value)
+{ uint64_t c[COUNT_PORTS] = {0};
+
+  for(int i=0; i<COUNTER_SHARDS; i++)
+  { for(int p=0; p<COUNT_PORTS; p++)
+      c[p] += pc->shards[i].ports[p];
+  }
+
+  return PL_unify_term(value,
+		       PL_FUNCTOR, FUNCTOR_call_counts4,
+			 PL_INT64, (int64_t)c[COUNT_CALL],
+			 PL_INT64, (int64_t)c[COUNT_REDO],
+			 PL_INT64, (int64_t)c[COUNT_EXIT],
+			 PL_INT64, (int64_t)c[COUNT_EXCEPTION]);
+}
+
+
+static int
+unify_call_latency(pred_counters *pc, term_t value)
+{ GET_LD
+  uint64_t count = 0, sum = 0;
+  term_t tail, head, buckets;
+
+  if ( !pc->latency )
+    return FALSE;
+
+  if ( !(buckets = PL_new_term_refs(2)) )
+    return FALSE;
+  head = buckets+1;
+  tail = PL_copy_term_ref(buckets);
+
+  for(int i=0; i<COUNTER_SHARDS; i++)
+    sum += pc->shards[i].latency_sum;
+  for(int b=0; b<LATENCY_BUCKETS; b++)
+  { uint64_t n = 0;
+
+    for(int i=0; i<COUNTER_SHARDS; i++)
+      n += pc->latency[i*LATENCY_BUCKETS+b];
+    if ( n )
+    { count += n;
+      if ( !PL_unify_list(tail, head, tail) ||
+	   !PL_unify_term(head,
+			  PL_FUNCTOR, FUNCTOR_minus2,
+			    PL_INT64, (int64_t)latency_bucket_max(b),
+			    PL_INT64, (int64_t)n) )
+	return FALSE;
+    }
+  }
+
+  return ( PL_unify_nil(tail) &&
+	   PL_unify_term(value,
+			 PL_FUNCTOR, FUNCTOR_call_latency3,
+			   PL_INT64, (int64_t)count,
+			   PL_INT64, (int64_t)sum,
+			   PL_TERM,  buckets) );
+}
+
+
+/* Called from '$get_predicate_attribute'/3 for the keys `call_counts`
+   and `call_latency`.
+*/
+
+int
+get_counters_attribute(Definition def, atom_t key, term_t value)
+{ pred_counters *pc = def->counters;
+
+  if ( !pc || false(def, P_COUNTED) )
+    return FALSE;
+
+  if ( key == ATOM_call_counts )
+    return unify_call_counts(pc, value);
+  else
+    return unify_call_latency(pc, value);
+}
+
+
+/** '$counted_predicates'(-List) is det.
+ *
+ * List holds the qualified predicate indicators of all predicates
+ * for which counting is enabled.  The predicates may be destroyed as
+ * soon as we release L_MISC, so we collect the module name and functor
+ * while holding the lock.  The module name is registered to keep it
+ * from being garbage collected.
+ */
+
+typedef struct counted_pi
+{ atom_t	module;
+  functor_t	functor;
+} counted_pi;
+
+static
+PRED_IMPL("$counted_predicates", 1, counted_predicates, 0)
+{ PRED_LD
+  tmp_buffer b;
+  pred_counters *pc;
+  term_t tail = PL_copy_term_ref(A1);
+  term_t head = PL_new_term_ref();
+  size_t i, n;
+  int rc = TRUE;
+
+  initBuffer(&b);
+  PL_LOCK(L_MISC);
+  for(pc = GD->counters.list; pc; pc = pc->next)
+  { counted_pi pi;
+
+    pi.module  = pc->predicate->module->name;
+    pi.functor = pc->predicate->functor->functor;
+    PL_register_atom(pi.module);
+    addBuffer(&b, pi, counted_pi);
+  }
+  PL_UNLOCK(L_MISC);
+
+  n = entriesBuffer(&b, counted_pi);
+  for(i=0; rc && i<n; i++)
+  { counted_pi *pi = &fetchBuffer(&b, i, counted_pi);
+
+    rc = ( PL_unify_list(tail, head, tail) &&
+	   PL_unify_term(head,
+			 PL_FUNCTOR, FUNCTOR_colon2,
+			   PL_ATOM, pi->module,
+			   PL_FUNCTOR, FUNCTOR_divide2,
+			     PL_ATOM, nameFunctor(pi->functor),
+			     PL_INT64, (int64_t)arityFunctor(pi->functor)) );
+  }
+  for(i=0; i<n; i++)
+    PL_unregister_atom(fetchBuffer(&b, i, counted_pi).module);
+  discardBuffer(&b);
+
+  return rc && PL_unify_nil(tail);
+}
+
+
+		 /*******************************
+		 *      PUBLISH PREDICATES	*
+		 *******************************/
+
+BeginPredDefs(counters)
+  PRED_DEF("$counted_predicates", 1, counted_predicates, 0)
+EndPredDefs
@@ -0,0 +1,82 @@
+/*  Part of SWI-Prolog
+
+    Author:        agent
+    E-mail:        agent@local
+    WWW:           http://www.swi-prolog.org
+    Copyright (c)  2026, agent
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in
+       the documentation and/or other materials provided with the
+       distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "pl-incl.h"
+
+#ifndef _PL_COUNTERS_H
+#define _PL_COUNTERS_H
+
+#if USE_LD_MACROS
+#define	count_port(fr, port)		LDFUNC(count_port, fr, port)
+#define	count_lco(fr)			LDFUNC(count_lco, fr)
+#define	count_lco_port(fr, port)	LDFUNC(count_lco_port, fr, port)
+#endif /*USE_LD_MACROS*/
+
+#define LDFUNC_DECLARATIONS
+
+void	count_port(LocalFrame fr, int port);
+void	count_lco(LocalFrame fr);
+void	count_lco_port(LocalFrame fr, int port);
+int	setCountedDefinition(Definition def, uint64_t attr, int val);
+int	get_counters_attribute(Definition def, atom_t key, term_t value);
+void	freeDefinitionCounters(Definition def);
+void	freeCountersLocalData(PL_local_data_t *ld);
+
+#undef LDFUNC_DECLARATIONS
+
+/* CountPort() is called from the VM on the call, redo, exit and
+   exception ports.  It only costs a flag test for predicates that
+   are not counted.
+*/
+
+static inline void
+CountPort(LocalFrame fr, int port)
+{ if ( unlikely(true(fr->predicate, P_COUNTED)) )
+    count_port(fr, port);
+  if ( unlikely(true(fr, FR_COUNTED_LCO)) && port != CALL_PORT &&
+       port != REDO_PORT )
+    count_lco_port(fr, port);
+}
+
+/* CountLCO() is called if fr is reused for its last call.  The exit of
+   a counted predicate is counted when fr finishes.
+*/
+
+static inline void
+CountLCO(LocalFrame fr)
+{ if ( unlikely(true(fr->predicate, P_COUNTED)) )
+    count_lco(fr);
+}
+
+#endif /*_PL_COUNTERS_H*/
@@ -45,6 +45,7 @@
 #include "pl-attvar.h"
 #include "pl-fli.h"
 #include "pl-trace.h"
+#include "pl-gc.h"
 
 /* - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 Event interface
@@ -83,6 +84,7 @@ const event_type PL_events[] =
   GEVENT(PLEV_RETRACTNOBREAK,   ATOM_break,            3, onbreak),
   GEVENT(PLEV_FRAMEFINISHED,    ATOM_frame_finished,   1, onframefinish),
   GEVENT(PLEV_UNTABLE,		ATOM_untable,          1, onuntable),
+  GEVENT(PLEV_GC,		ATOM_gc,               1, ongc),
 #ifdef O_PLMT
   GEVENT(PLEV_THREAD_START,     ATOM_thread_start,     1, onthreadstart),
   GEVENT(PLEV_THREAD_EXIT,      ATOM_thread_exit,      1, onthreadexit),
@@ -660,6 +662,12 @@ PL_call_event_hook_va(pl_event_type ev, va_list args)
 			    0, GP_QUALIFY|GP_NAMEARITY);
       break;
     }
+    case PLEV_GC:
+    { gc_stat *stat = va_arg(args, gc_stat*);
+
+      rc = put_gc_event(av+1, stat);
+      break;
+    }
     default:
       rc = warning("callEventHook(): unknown event: %d", ev);
       goto out;
@@ -47,6 +47,7 @@ typedef enum pl_event_type
   PLEV_RETRACTNOBREAK,			/* cleared due to clause GC */
   PLEV_FRAMEFINISHED,			/* A watched frame was discarded */
   PLEV_UNTABLE,				/* Stop tabling some predicate */
+  PLEV_GC,				/* Garbage collection completed */
 					/* Keep these two at the end */
   PLEV_THREAD_START,			/* A thread started */
   PLEV_THREAD_EXIT,			/* A thread has finished */
@@ -403,6 +403,7 @@ DECL_PLIST(gc);
 DECL_PLIST(proc);
 DECL_PLIST(srcfile);
 DECL_PLIST(write);
+DECL_PLIST(format);
 DECL_PLIST(dlopen);
 DECL_PLIST(system);
 DECL_PLIST(op);
@@ -425,6 +426,8 @@ DECL_PLIST(transaction);
 DECL_PLIST(undo);
 DECL_PLIST(error);
 DECL_PLIST(coverage);
+DECL_PLIST(counters);
+DECL_PLIST(vector);
 #ifdef __EMSCRIPTEN__
 DECL_PLIST(wasm);
 #endif
@@ -469,6 +472,7 @@ initBuildIns(void)
   REG_PLIST(proc);
   REG_PLIST(srcfile);
   REG_PLIST(write);
+  REG_PLIST(format);
   REG_PLIST(dlopen);
   REG_PLIST(system);
   REG_PLIST(op);
@@ -504,6 +508,8 @@ initBuildIns(void)
   REG_PLIST(transaction);
   REG_PLIST(undo);
   REG_PLIST(error);
+  REG_PLIST(counters);
+  REG_PLIST(vector);
 #ifdef O_COVERAGE
   REG_PLIST(coverage);
 #endif
@@ -73,6 +73,7 @@ See pl-atom.c for many useful comments on the representation.
 
 static void	  allocFunctorTable(void);
 static void	  rehashFunctors(void);
+static void	  growFunctorTable(void);
 
 static void
 allocateFunctorBlock(int idx)
@@ -127,8 +128,12 @@ lookupFunctorDef(DECL_LD atom_t atom, size_t arity)
   FunctorDef *table;
   int buckets;
   FunctorDef f, head;
+  int retry = FALSE;
 
 redo:
+  if ( retry )
+    ATOMIC_INC(&GD->functors.retries);
+  retry = TRUE;
   acquire_functor_table(table, buckets);
 
   v = (int)pointerHashValue(atom, buckets);
@@ -147,9 +152,9 @@ redo:
   }
 
   if ( functorDefTable->buckets * 2 < GD->statistics.functors )
-  { PL_LOCK(L_FUNCTOR);
-    rehashFunctors();
-    PL_UNLOCK(L_FUNCTOR);
+  { release_functor_table();
+    growFunctorTable();
+    goto redo;
   }
 
   if ( !( table == functorDefTable->table && head == table[v] ) )
@@ -196,11 +201,64 @@ maybe_free_functor_tables(void)
 }
 
 
+/* - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Resizing the functor table. As with  the   atom  table (see pl-atom.c),
+threads that need the table to grow   while  it is being rehashed help
+moving functors to the new table  rather   than  blocking  until a single
+thread has moved all of them. The work   is  claimed in chunks of
+FUNCTOR_MIGRATE_CHUNK functors.
+
+Functors get their index after  they  are   linked  into  the hash table.
+Therefore rehashFunctors() migrates functors created  while it waited for
+the helpers itself.
+- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
+#define FUNCTOR_MIGRATE_CHUNK 1024
+
+static void
+migrateFunctorRange(FunctorTable newtab, size_t index, size_t upto)
+{ for(; index<upto; index++)
+  { FunctorDef *b = GD->functors.array.blocks[MSB(index)];
+    FunctorDef f;
+
+    if ( b && (f=b[index]) && FUNCTOR_IS_VALID(f->flags) )
+    { FunctorDef *bp = &newtab->table[pointerHashValue(f->name,
+							newtab->buckets)];
+      FunctorDef head;
+
+      do
+      { head = *bp;
+	f->next = head;
+      } while ( !COMPARE_AND_SWAP_PTR(bp, head, f) );
+    }
+  }
+}
+
+
+static void
+migrateFunctors(FunctorTable newtab)
+{ size_t high = newtab->migrate_high;
+
+  for(;;)
+  { size_t index = ATOMIC_ADD(&newtab->migrate_next, FUNCTOR_MIGRATE_CHUNK) -
+		   FUNCTOR_MIGRATE_CHUNK;
+    size_t upto = index + FUNCTOR_MIGRATE_CHUNK;
+
+    if ( index >= high )
+      break;
+    if ( upto > high )
+      upto = high;
+
+    migrateFunctorRange(newtab, index, upto);
+    ATOMIC_ADD(&newtab->migrated, upto-index);
+  }
+}
+
+
 static void
 rehashFunctors(void)
 { FunctorTable newtab;
-  size_t index;
-  int i, last = FALSE;
+  size_t high;
 
   if ( functorDefTable->buckets * 2 >= GD->statistics.functors )
     return;
@@ -216,34 +274,55 @@ rehashFunctors(void)
 		 functorDefTable->buckets, newtab->buckets));
 
   GD->functors.rehashing = TRUE;
-  for(index=1, i=0; !last; i++)
-  { size_t upto = (size_t)2<<i;
-    FunctorDef *b;
+  MEMORY_BARRIER();
+  newtab->migrate_high = GD->functors.highest;
+  newtab->migrate_next = 1;
+  newtab->migrated     = 1;
+  MEMORY_BARRIER();
+  GD->functors.migrating = newtab;
+
+  migrateFunctors(newtab);
+  for(unsigned int spins=0; newtab->migrated < newtab->migrate_high; )
+    spin_wait(&spins);			/* wait for helpers */
+  GD->functors.migrating = NULL;
+  if ( (high=GD->functors.highest) > newtab->migrate_high )
+    migrateFunctorRange(newtab, newtab->migrate_high, high);
 
-    if ( (b=GD->functors.array.blocks[i]) )
-    { size_t high = GD->functors.highest;
+  functorDefTable = newtab;
+  GD->functors.rehashing = FALSE;
+  GD->functors.rehashes++;
+  maybe_free_functor_tables();
+}
 
-      if ( upto >= high )
-      { upto = high;
-	last = TRUE;
-      }
 
-      for(; index<upto; index++)
-      { FunctorDef f = b[index];
+/* Must be called without holding the functor table.  See growAtomTable()
+   in pl-atom.c
+*/
 
-	if ( f && FUNCTOR_IS_VALID(f->flags) )
-	{ size_t v = pointerHashValue(f->name, newtab->buckets);
+static void
+growFunctorTable(void)
+{ FunctorTable newtab;
 
-	  f->next = newtab->table[v];
-	  newtab->table[v] = f;
-	}
-      }
-    }
+  if ( (newtab=GD->functors.migrating) )
+  {
+#ifdef O_PLMT
+    GET_LD
+    LD->thread.info->access.functor_table = newtab;
+    MEMORY_BARRIER();
+    if ( GD->functors.migrating == newtab )
+      migrateFunctors(newtab);
+    LD->thread.info->access.functor_table = NULL;
+#else
+    migrateFunctors(newtab);
+#endif
+    for(unsigned int spins=0; GD->functors.migrating == newtab; )
+      spin_wait(&spins);
+    return;
   }
 
-  functorDefTable = newtab;
-  GD->functors.rehashing = FALSE;
-  maybe_free_functor_tables();
+  PL_LOCK(L_FUNCTOR);
+  rehashFunctors();
+  PL_UNLOCK(L_FUNCTOR);
 }
 
 /* - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -275,10 +354,7 @@ redo:
   release_functor_table();
 
   if ( !rc && functorDefTable->buckets * 2 < GD->statistics.functors )
-  { PL_LOCK(L_FUNCTOR);
-    rehashFunctors();
-    PL_UNLOCK(L_FUNCTOR);
-  }
+    growFunctorTable();
   if ( table != functorDefTable->table )
     goto redo;
 
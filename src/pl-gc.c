@@ -52,6 +52,7 @@
 #include "pl-bag.h"
 #include "pl-wam.h"
 #include "pl-write.h"
+#include "pl-event.h"
 
 /* - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 This module is based on
@@ -561,7 +562,7 @@ gc_stat_aggregate(gc_stats *stats)
 
 #define gc_stat_start(stats, reason) LDFUNC(gc_stat_start, stats, reason)
 static void
-gc_stat_start(DECL_LD gc_stats *stats, unsigned int reason)
+gc_stat_start(DECL_LD gc_stats *stats, gc_reason_t reason)
 { gc_stat *this = &stats->last[stats->last_index];
   double cpu = ThreadCPUTime(CPU_USER);
 
@@ -580,6 +581,72 @@ gc_stat_start(DECL_LD gc_stats *stats, unsigned int reason)
   stats->thread_cpu   = cpu;
 }
 
+/* - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+adapt_gc_policy() implements the  Prolog  flags gc_target_pause and
+gc_target_fraction.  It adjusts the `factor` of the global stack that
+considerGarbageCollect() uses to schedule the next GC.  A higher factor
+lets more garbage accumulate, leading to fewer but longer collections,
+i.e., it trades pause time and memory for throughput.  The trail factor
+is left alone: the GC time and pause are dominated by the global stack
+and the trail has its own usage pattern.
+
+  - If the last pause exceeded the pause target, collect sooner.
+  - Else, if the GC time fraction over the recent window exceeds the
+    fraction target, collect later.
+  - Else, if we are well within the targets, move slowly towards the
+    other end, i.e., use less memory if only the fraction is bounded
+    and spend less time in GC if only the pause is bounded.
+- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
+#define GC_FACTOR_MIN 2
+#define GC_FACTOR_MAX 64
+
+static double
+gc_window_percentage(gc_stats *stats)
+{ double gc = 0.0, prolog = 0.0;
+  int i;
+
+  for(i=0; i<GC_STAT_WINDOW_SIZE; i++)
+  { if ( stats->last[i].global_before )
+    { gc     += stats->last[i].gc_time;
+      prolog += stats->last[i].prolog_time;
+    }
+  }
+
+  return gc == 0.0 ? 0.0 : gc/(gc+prolog);
+}
+
+#define adapt_gc_policy(stats, last) LDFUNC(adapt_gc_policy, stats, last)
+static void
+adapt_gc_policy(DECL_LD gc_stats *stats, gc_stat *last)
+{ double pause    = GD->gc.target_pause;
+  double fraction = GD->gc.target_fraction;
+  double recent   = gc_window_percentage(stats);
+  int factor      = LD->stacks.global.factor;
+  int old	  = factor;
+
+  if ( pause > 0.0 && last->gc_time > pause )
+    factor -= (factor >= 8 ? factor/4 : 1);
+  else if ( fraction > 0.0 && recent > fraction )
+    factor += (factor >= 4 ? factor/2 : 1);
+  else if ( fraction > 0.0 && recent < fraction/2 )
+    factor--;
+  else if ( fraction == 0.0 && last->gc_time < pause/2 )
+    factor++;
+
+  if ( factor < GC_FACTOR_MIN )
+    factor = GC_FACTOR_MIN;
+  else if ( factor > GC_FACTOR_MAX )
+    factor = GC_FACTOR_MAX;
+
+  if ( factor != old )
+  { DEBUG(MSG_GC_SCHEDULE,
+	  Sdprintf("GC: factor %d -> %d (pause=%.6f, fraction=%.3f)\n",
+		   old, factor, last->gc_time, recent));
+    LD->stacks.global.factor = factor;
+  }
+}
+
 #define gc_stat_end(stats) LDFUNC(gc_stat_end, stats)
 static gc_stat *
 gc_stat_end(DECL_LD gc_stats *stats)
@@ -592,6 +659,9 @@ gc_stat_end(DECL_LD gc_stats *stats)
   stats->thread_cpu   = cpu;
   stats->last_index   = STAT_NEXT_INDEX(stats->last_index);
 
+  this->global_size   = sizeStack(global);
+  this->trail_size    = sizeStack(trail);
+
   LD->stacks.global.gced_size = this->global_after;
   LD->stacks.trail.gced_size  = this->trail_after;
 
@@ -600,8 +670,14 @@ gc_stat_end(DECL_LD gc_stats *stats)
   stats->totals.time	      += this->gc_time;
   stats->totals.collections++;
 
+  if ( GD->gc.target_pause > 0.0 || GD->gc.target_fraction > 0.0 )
+    adapt_gc_policy(stats, this);
   if ( gc_percentage(this) > 0.2 )
     PL_raise(SIG_TUNE_GC);
+  if ( GD->event.hook.ongc )
+    PL_raise(SIG_GC_EVENT);
+  else
+    stats->reported = stats->totals.collections;
 
   return this;
 }
@@ -637,7 +713,7 @@ unify_gc_reason(DECL_LD term_t t, gc_stat *stat)
   int to = (stat->reason>>16)&0xff;
   int tr = (stat->reason>>24)&0xff;
   int ex = (stat->reason>>32)&0xff;
-  int ur = (stat->reason>>36)&0xff;
+  int ur = (stat->reason>>40)&0xff;
 
   return PL_unify_term(t, PL_FUNCTOR, FUNCTOR_gc6,
 			    PL_INT, go,
@@ -701,6 +777,94 @@ PRED_IMPL("$gc_statistics", 5, gc_statistics, 0)
 }
 
 
+		 /*******************************
+		 *	     GC EVENTS		*
+		 *******************************/
+
+/* - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+If there are listeners  on  the  `gc`  channel  (see prolog_listen/2),
+gc_stat_end() raises SIG_GC_EVENT. We  cannot  call  Prolog  from  the
+collector, so the  event  is  delivered  from  the  signal  handler at
+the next safe point.  As multiple collections may happen before that,
+we send all collections that are still in the stats window and have not
+yet been reported.
+- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
+static atom_t
+gc_reason_name(gc_reason_t reason)
+{ if ( reason & GC_GLOBAL_OVERFLOW ) return ATOM_global_overflow;
+  if ( reason & GC_GLOBAL_REQUEST )  return ATOM_global;
+  if ( reason & GC_TRAIL_OVERFLOW )  return ATOM_trail_overflow;
+  if ( reason & GC_TRAIL_REQUEST )   return ATOM_trail;
+  if ( reason & GC_EXCEPTION )	     return ATOM_exception;
+  if ( reason & GC_USER )	     return ATOM_user;
+
+  return ATOM_unknown;
+}
+
+#define GC_EVENT_KEYS 12
+
+int
+put_gc_event(term_t t, gc_stat *stat)
+{ GET_LD
+  static const atom_t keys[GC_EVENT_KEYS] =
+  { ATOM_reason, ATOM_time, ATOM_fraction,
+    ATOM_global_before, ATOM_global_after, ATOM_global_size,
+    ATOM_trail_before, ATOM_trail_after, ATOM_trail_size,
+    ATOM_local, ATOM_factor, ATOM_collections
+  };
+  term_t av;
+
+  return ( (av=PL_new_term_refs(GC_EVENT_KEYS)) &&
+	   PL_put_atom(av+0, gc_reason_name(stat->reason)) &&
+	   PL_put_float(av+1, stat->gc_time) &&
+	   PL_put_float(av+2, gc_percentage(stat)) &&
+	   PL_put_int64(av+3, stat->global_before) &&
+	   PL_put_int64(av+4, stat->global_after) &&
+	   PL_put_int64(av+5, stat->global_size) &&
+	   PL_put_int64(av+6, stat->trail_before) &&
+	   PL_put_int64(av+7, stat->trail_after) &&
+	   PL_put_int64(av+8, stat->trail_size) &&
+	   PL_put_int64(av+9, stat->local) &&
+	   PL_put_integer(av+10, LD->stacks.global.factor) &&
+	   PL_put_int64(av+11, LD->gc.stats.reported) &&
+	   PL_put_dict(t, ATOM_gc, GC_EVENT_KEYS, keys, av) );
+}
+
+
+void
+send_gc_events(void)
+{ GET_LD
+  gc_stats *stats = &LD->gc.stats;
+  int64_t pending = stats->totals.collections - stats->reported;
+  gc_stat window[GC_STAT_WINDOW_SIZE];
+  int i, n;
+
+  if ( pending <= 0 )
+    return;
+  if ( pending > GC_STAT_WINDOW_SIZE )
+  { stats->reported += pending - GC_STAT_WINDOW_SIZE;
+    pending = GC_STAT_WINDOW_SIZE;
+  }
+
+  n = (int)pending;			/* copy: hooks may run GC */
+  for(i=0; i<n; i++)
+  { int index = stats->last_index;
+    int back  = n-i;
+
+    while(back-- > 0)
+      index = STAT_PREV_INDEX(index);
+    window[i] = stats->last[index];
+  }
+
+  for(i=0; i<n; i++)
+  { stats->reported++;
+    if ( !callEventHook(PLEV_GC, &window[i]) )
+      break;
+  }
+}
+
+
 		/********************************
 		*          UTILITIES            *
 		*********************************/
@@ -4443,6 +4607,10 @@ garbageCollect(gc_reason_t reason)
   DEBUG(CHK_SECURE, check_foreign());
   tag_trail();
   mark_phase(&state);
+#ifdef O_PROFILE
+  if ( LD->profile.alloc )
+    allocProfileMarked();
+#endif
 
   DEBUG(MSG_GC_PROGRESS, Sdprintf("Compacting trail\n"));
   compact_trail();
@@ -5166,6 +5334,22 @@ needStack(DECL_LD Stack s)
 }
 
 
+/* - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+If the Prolog flag stack_reserve is true, stacks are reallocated inside
+a reserved address range that is as large  as the stack limit. After the
+first shift, the trail and global stack never move and update_stacks()
+only needs to relocate the local stack if the global stack changes size.
+- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
+#define realloc_stack_area(mem, size) LDFUNC(realloc_stack_area, mem, size)
+static void *
+realloc_stack_area(DECL_LD void *mem, size_t size)
+{ if ( truePrologFlag(PLFLAG_STACK_RESERVE) )
+    return stack_realloc_reserved(mem, size, LD->stacks.limit);
+
+  return stack_realloc(mem, size);
+}
+
 #define grow_stacks(l, g, t) LDFUNC(grow_stacks, l, g, t)
 static int
 grow_stacks(DECL_LD size_t l, size_t g, size_t t)
@@ -5282,8 +5466,10 @@ grow_stacks(DECL_LD size_t l, size_t g, size_t t)
     { void *nw;
 
       tsize = stack_nrealloc(tb, tsize);
-      if ( (nw = stack_realloc(tb, tsize)) )
+      if ( (nw = realloc_stack_area(tb, tsize)) )
       { LD->shift_status.trail_shifts++;
+	if ( nw == tb )
+	  LD->shift_status.inplace_shifts++;
 	tb = nw;
       } else
       { fatal = (Stack)&LD->stacks.trail;
@@ -5306,11 +5492,13 @@ grow_stacks(DECL_LD size_t l, size_t g, size_t t)
       if ( gsize < ogsize )		/* TBD: Only copy life-part */
 	memmove(addPointer(gb, gsize), lb, olsize);
 
-      if ( (nw = stack_realloc(gb, lsize + gsize)) )
+      if ( (nw = realloc_stack_area(gb, lsize + gsize)) )
       { if ( g )
 	  LD->shift_status.global_shifts++;
 	if ( l )
 	  LD->shift_status.local_shifts++;
+	if ( nw == gb )			/* global, or if only the local */
+	  LD->shift_status.inplace_shifts++; /* changed, local did not move */
 
 	gb = nw;
 	lb = addPointer(gb, gsize);
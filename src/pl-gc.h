@@ -56,6 +56,8 @@
 
 int		considerGarbageCollect(Stack s);
 void		call_tune_gc_hook(void);
+void		send_gc_events(void);
+int		put_gc_event(term_t t, gc_stat *stat);
 int		garbageCollect(gc_reason_t reason);
 word		pl_garbage_collect(term_t d);
 gc_stat *	last_gc_stats(gc_stats *stats);
@@ -163,14 +163,22 @@ struct PL_global_data
 #endif
     int		errors;			/* Printed error messages */
     int		warnings;		/* Printed warning messages */
+    int64_t	idle_trims;		/* # idleTrimStacks() calls */
+    int64_t	idle_trim_gained;	/* Stack bytes released by them */
   } statistics;
 
 #ifdef O_PROFILE
   struct
   { struct PL_local_data *thread;	/* Thread being profiled */
+    int		samplers;		/* # threads running the sampler */
+    int		alloc_samplers;		/* # threads sampling allocHeap() */
   } profile;
 #endif
 
+  struct
+  { struct pred_counters *list;		/* Counted predicates */
+  } counters;
+
   struct
   { Module	user;			/* user module */
     Module	system;			/* system predicate module */
@@ -194,6 +202,14 @@ struct PL_global_data
   } tabling;
 #endif
 
+  struct
+  { struct trie *trie;			/* term_intern/2 store */
+    Table	 pending;		/* trie_node -> # term_intern/2 busy */
+#ifdef O_PLMT
+    simpleMutex	 mutex;			/* Serialize updates */
+#endif
+  } intern;
+
   struct
   { Table	record_lists;		/* Available record lists */
   } recorded_db;
@@ -209,11 +225,15 @@ struct PL_global_data
     AtomTable	table;			/* hash-table */
     int		lookups;		/* # atom lookups */
     int		cmps;			/* # string compares for lookup */
+    int		cache_hits;		/* # lookups from thread cache */
     int		initialised;		/* atoms have been initialised */
 #ifdef O_ATOMGC
     int		gc;			/* # atom garbage collections */
     int		gc_active;		/* Atom-GC is in progress */
     int		rehashing;		/* Atom-rehash in progress */
+    AtomTable	migrating;		/* Table being filled by rehash */
+    size_t	rehashes;		/* # times the table was resized */
+    size_t	retries;		/* # lookups that had to restart */
     size_t	builtin;		/* Locked atoms (atom-gc) */
     size_t	no_hole_before;		/* You won't find a hole before here */
     size_t	margin;			/* # atoms to grow before collect */
@@ -268,13 +288,26 @@ struct PL_global_data
   { size_t	highest;		/* Next index to handout */
     functor_array array;		/* index --> functor */
     FunctorTable table;			/* hash-table */
+    FunctorTable migrating;		/* Table being filled by rehash */
     int		 rehashing;		/* Table is being rehashed */
+    size_t	 rehashes;		/* # times the table was resized */
+    size_t	 retries;		/* # lookups that had to restart */
   } functors;
 
   struct
   { Code	catch_exit_address;	/* See findCatchExit() */
   } exceptions;
 
+  struct				/* see idleTrimStacks() */
+  { double	time;			/* Trim if idle for (sec.); 0: never */
+    size_t	floor;			/* Leave smaller stacks alone */
+  } idle_trim;
+
+  struct				/* see adapt_gc_policy() */
+  { double	target_pause;		/* Max GC pause (sec.); 0: none */
+    double	target_fraction;	/* Max GC time fraction; 0: none */
+  } gc;
+
   struct
   { struct
     { struct event_list *onabort;	/* Thread aborted */
@@ -286,6 +319,7 @@ struct PL_global_data
       struct event_list *onthreadexit;	/* thread exit hook */
 #endif
       struct event_list *onuntable;	/* Untable after reload */
+      struct event_list *ongc;		/* Garbage collection completed */
     } hook;
   } event;
 
@@ -521,6 +555,10 @@ struct PL_local_data
     int		next;			/* prompt on next read operation */
   } prompt;
 
+  struct
+  { struct format_cache *cache;		/* compiled format/2 atoms */
+  } format;
+
   source_location read_source;		/* file, line, char of last term */
 
   struct
@@ -586,6 +624,9 @@ struct PL_local_data
     ar_context *context;		/* current allocation context */
     mp_mem_header *head;		/* linked list of allocated chunks */
     mp_mem_header *tail;
+#if O_BF
+    struct radix_cache *radix;		/* cached powers for mpz_set_digits() */
+#endif
   } gmp;
 #endif
 
@@ -603,6 +644,8 @@ struct PL_local_data
     double	time_at_last_tick;	/* Time at last statistics tick */
     double	time_at_start;		/* Time at last start */
     double	time;			/* recorded CPU time */
+    struct prof_sampler *sampler;	/* sampling profiler (pl-prof.c) */
+    struct alloc_sampler *alloc;	/* allocation profiler (pl-prof.c) */
   } profile;
 #endif /* O_PROFILE */
 
@@ -614,6 +657,9 @@ struct PL_local_data
   struct
   { intptr_t	generator;		/* See PL_atom_generator() */
     atom_t	unregistering;		/* See PL_unregister_atom() */
+#ifdef O_ATOMGC
+    Atom	cache[ATOM_CACHE_SIZE];	/* Owned references (pl-atom.c) */
+#endif
   } atoms;
 
   struct
@@ -639,11 +685,14 @@ struct PL_local_data
       Number	top;
       Number	max;
     } stack;
-#ifdef O_BIGNUM
     struct
-    { gmp_randstate_t state;
-      int initialised;
+    { uint64_t	s[4];			/* xoshiro256** state */
+#ifdef O_BIGNUM
+      gmp_randstate_t state;		/* GMP state for bignum bounds */
+#endif
+      int	initialised;
     } random;
+#ifdef O_BIGNUM
     struct
     { size_t max_rational_size;
       atom_t max_rational_size_action;
@@ -698,6 +747,7 @@ struct PL_local_data
     int		  write_attributes;	/* how to write attvars? */
     occurs_check_t occurs_check;	/* Unify and occurs check */
     access_level_t access_level;	/* Current access level */
+    size_t	  cycle_threshold;	/* Compounds walked before cycle check */
   } prolog_flag;
 
   struct
@@ -769,6 +819,8 @@ struct PL_local_data
     simpleMutex scan_lock;		/* Hold for asynchronous scans */
     thread_wait_for *waiting_for;	/* thread_wait/2 info */
     alert_channel alert;		/* How to alert the thread */
+    uint64_t idle_inferences;		/* Inferences at last idle trim */
+    uint64_t idle_seen;			/* Inferences at last engine sweep */
   } thread;
 #endif
 
@@ -804,6 +856,15 @@ struct PL_local_data
   } coverage;
 #endif
 
+  struct
+  { struct counted_frame *frames;	/* Frames with exit latency timing */
+    size_t	top;			/* Top of frames */
+    size_t	size;			/* Allocated entries */
+    struct counted_exit *exits;		/* Exits pending after LCO */
+    size_t	exits_top;		/* Top of exits */
+    size_t	exits_size;		/* Allocated entries */
+  } counters;
+
   struct
   { gen_t	generation;		/* reload generation */
     int		nesting;		/* reload nesting */
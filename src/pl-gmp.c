@@ -583,8 +583,15 @@ get_mpq_from_code(Code pc, mpq_t mpq)
 { Word p = pc;
   size_t wsize = wsizeofInd(*p);
   p++;
+#if O_GMP
+  int num_size = mpz_stack_size(*p++);
+  int den_size = mpz_stack_size(*p++);
+#elif O_BF
   int num_size = mpz_stack_size(*p++);
+  slimb_t num_expn = (slimb_t)*p++;
   int den_size = mpz_stack_size(*p++);
+  slimb_t den_expn = (slimb_t)*p++;
+#endif
   size_t limpsize = sizeof(mp_limb_t) * abs(num_size);
   mpz_t num, den;
 
@@ -598,9 +605,9 @@ get_mpq_from_code(Code pc, mpq_t mpq)
   den->_mp_d = (mp_limb_t*)p;
 #elif O_BF
   num->ctx = NULL;
-  num->expn = *p++;
+  num->expn = num_expn;
   den->ctx = NULL;
-  den->expn = *p++;
+  den->expn = den_expn;
   num->sign = num_size < 0;
   num->len  = abs(num_size);
   den->sign = den_size < 0;
@@ -903,6 +910,53 @@ mpz_init_set_si64(mpz_t mpz, int64_t i)
 #endif
 }
 
+#ifdef O_INT128
+/* - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Conversion between GMP integers  and  __int128.   mpz_to_int128()  only
+accepts numbers whose magnitude is below  2^127, such that negation and
+addition of two such numbers cannot overflow.
+- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
+int
+mpz_to_int128(const mpz_t mpz, __int128 *i)
+{ int size = mpz->_mp_size;
+  unsigned __int128 v;
+
+  switch(size < 0 ? -size : size)
+  { case 0:
+      *i = 0;
+      return TRUE;
+    case 1:
+      v = mpz->_mp_d[0];
+      break;
+    case 2:
+      if ( (mpz->_mp_d[1] >> 63) )
+	return FALSE;
+      v = (unsigned __int128)mpz->_mp_d[1] << 64 | mpz->_mp_d[0];
+      break;
+    default:
+      return FALSE;
+  }
+
+  *i = size < 0 ? -(__int128)v : (__int128)v;
+  return TRUE;
+}
+
+void
+mpz_init_set_int128(mpz_t mpz, __int128 i)
+{ unsigned __int128 v = i < 0 ? -(unsigned __int128)i : (unsigned __int128)i;
+  mp_limb_t *d;
+  int size;
+
+  mpz_init2(mpz, 128);
+  d = mpz->_mp_d;
+  d[0] = (mp_limb_t)v;
+  d[1] = (mp_limb_t)(v >> 64);
+  size = d[1] ? 2 : d[0] ? 1 : 0;
+  mpz->_mp_size = i < 0 ? -size : size;
+}
+#endif /*O_INT128*/
+
 #endif /*O_GMP*/
 
 static void
@@ -1255,6 +1309,237 @@ mpz_to_uint64(mpz_t mpz, uint64_t *i)
 #endif
 
 
+		 /*******************************
+		 *	  RADIX CONVERSION	*
+		 *******************************/
+
+/* - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+int mpz_set_digits(mpz_t r, const char *s, int base)
+    Set r to the value of  the   0-terminated  digit  string s in base
+    2..36.  The digits are ASCII 0-9, a-z or A-Z. Returns FALSE if a
+    digit is out of range.
+
+GMP's mpz_set_str() is subquadratic. LibBF has no  equivalent, so for
+LibBF we use divide and conquer: a  string   of  n  digits is split at
+P = B^(k*2^i), the largest such power below n digits, where B^k is the
+largest power of the base that fits in 32 bits. Both halves are
+converted recursively and combined as  high*P+low.  Below
+RADIX_LEAF_WORDS words the digits are accumulated in a uint32_t array.
+
+The powers P are cached per thread in   LD->gmp.radix for the last base
+used.  They are allocated persistent, so they survive the arithmetic
+allocation context and are freed by freeRadixCache() when the thread
+terminates.
+- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
+#if O_GMP
+
+int
+mpz_set_digits(mpz_t r, const char *s, int base)
+{ return *s && mpz_set_str(r, s, base) == 0;
+}
+
+#elif O_BF
+
+#define RADIX_LEAF_WORDS 32		/* schoolbook below this many words */
+#define RADIX_MAX_LEVELS 48
+
+typedef struct radix_cache
+{ int		base;			/* base of the cached powers */
+  int		chunk;			/* digits per 32-bit word */
+  uint32_t	chunk_value;		/* base^chunk */
+  int		levels;			/* filled entries of pow[] */
+  mpz_t		pow[RADIX_MAX_LEVELS];	/* pow[i] = base^(chunk*2^i) */
+} radix_cache;
+
+static void
+clear_radix_powers(PL_local_data_t *ld, radix_cache *rc)
+{ ld->gmp.persistent++;
+  for(int i=0; i<rc->levels; i++)
+    mpz_clear(rc->pow[i]);
+  ld->gmp.persistent--;
+  rc->levels = 0;
+}
+
+
+static radix_cache *
+get_radix_cache(int base)
+{ GET_LD
+  radix_cache *rc = LD->gmp.radix;
+
+  if ( !rc )
+  { rc = allocHeapOrHalt(sizeof(*rc));
+    rc->base = 0;
+    rc->levels = 0;
+    LD->gmp.radix = rc;
+  }
+
+  if ( rc->base != base )
+  { uint64_t v = base;
+    int k = 1;
+
+    clear_radix_powers(LD, rc);
+    while ( v*base <= UINT32_MAX )
+    { v *= base;
+      k++;
+    }
+    rc->base	    = base;
+    rc->chunk	    = k;
+    rc->chunk_value = (uint32_t)v;
+  }
+
+  return rc;
+}
+
+
+/* Return base^(chunk*2^i), computing missing powers by squaring */
+
+static mpz_t *
+radix_power(radix_cache *rc, int i)
+{ assert(i < RADIX_MAX_LEVELS);
+
+  if ( i >= rc->levels )
+  { GET_LD
+
+    LD->gmp.persistent++;
+    while( rc->levels <= i )
+    { int l = rc->levels;
+
+      mpz_init(rc->pow[l]);
+      if ( l == 0 )
+	mpz_set_ui(rc->pow[l], rc->chunk_value);
+      else
+	mpz_mul(rc->pow[l], rc->pow[l-1], rc->pow[l-1]);
+      rc->levels++;
+    }
+    LD->gmp.persistent--;
+  }
+
+  return &rc->pow[i];
+}
+
+
+static int
+radix_digit_value(int c)
+{ if ( c >= '0' && c <= '9' )
+    return c - '0';
+  if ( c >= 'a' && c <= 'z' )
+    return c - 'a' + 10;
+  if ( c >= 'A' && c <= 'Z' )
+    return c - 'A' + 10;
+  return 99;
+}
+
+
+static int
+radix_set_leaf(mpz_t r, const char *s, size_t n, const radix_cache *rc)
+{ uint32_t w[RADIX_LEAF_WORDS+1];
+  unsigned char bytes[sizeof(w)];
+  size_t nw = 0;
+  size_t take = n % rc->chunk;
+  const int base = rc->base;
+
+  if ( take == 0 )
+    take = rc->chunk;
+
+  while( n > 0 )
+  { uint32_t v = 0, m = 1;
+    uint64_t carry;
+
+    n -= take;
+    while(take-- > 0)
+    { int d = radix_digit_value(*s++);
+
+      if ( d >= base )
+	return FALSE;
+      v = v*base + d;
+      m *= base;
+    }
+
+    carry = v;
+    for(size_t k=0; k<nw; k++)
+    { uint64_t t = (uint64_t)w[k]*m + carry;
+      w[k]  = (uint32_t)t;
+      carry = t>>32;
+    }
+    if ( carry )
+      w[nw++] = (uint32_t)carry;
+    take = rc->chunk;
+  }
+
+  if ( nw == 0 )
+  { mpz_set_ui(r, 0);
+  } else		/* mpz_import() wants big endian without leading 0 */
+  { unsigned char *o = bytes;
+    int skip = TRUE;
+
+    for(size_t k=nw; k-- > 0; )
+    { for(int b=3; b>=0; b--)
+      { unsigned char c = (w[k]>>(b*8))&0xff;
+
+	if ( skip && c == 0 )
+	  continue;
+	skip = FALSE;
+	*o++ = c;
+      }
+    }
+    mpz_import(r, o-bytes, 1, 1, 0, 0, bytes);
+  }
+
+  return TRUE;
+}
+
+
+static int
+radix_set_rec(mpz_t r, const char *s, size_t n, radix_cache *rc)
+{ if ( n <= (size_t)rc->chunk*RADIX_LEAF_WORDS )
+  { return radix_set_leaf(r, s, n, rc);
+  } else
+  { int i = 0;
+    size_t low;
+    mpz_t high;
+    int ok;
+
+    while( ((size_t)rc->chunk<<(i+1)) < n )
+      i++;
+    low = (size_t)rc->chunk<<i;
+
+    mpz_init(high);
+    if ( (ok = ( radix_set_rec(high, s, n-low, rc) &&
+		 radix_set_rec(r, s+n-low, low, rc) )) )
+      mpz_addmul(r, high, *radix_power(rc, i));
+    mpz_clear(high);
+
+    return ok;
+  }
+}
+
+
+int
+mpz_set_digits(mpz_t r, const char *s, int base)
+{ size_t len = strlen(s);
+
+  if ( len == 0 )
+    return FALSE;
+
+  return radix_set_rec(r, s, len, get_radix_cache(base));
+}
+
+
+void
+freeRadixCache(PL_local_data_t *ld)
+{ radix_cache *rc;
+
+  if ( (rc = ld->gmp.radix) )
+  { ld->gmp.radix = NULL;
+    clear_radix_powers(ld, rc);
+    freeHeap(rc, sizeof(*rc));
+  }
+}
+
+#endif /*O_GMP*/
+
+
 /* - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 put_number() transforms a number into a Prolog  term. Note that this may
 allocate on the global stack. Please note   that  this function uses the
@@ -82,6 +82,10 @@ void	get_rational(word w, number *n);
 #define MPZ_LIMB_SIZE(n)	((n)->_mp_size)
 #define MPZ_LIMBS(n)		((n)->_mp_d)
 #define MPZ_STACK_EXTRA		(1)
+#if defined(HAVE_INT128) && HAVE___BUILTIN_MUL_OVERFLOW && \
+    GMP_NUMB_BITS == 64 && GMP_NAIL_BITS == 0
+#define O_INT128 1			/* __int128 fast path in pl-arith.c */
+#endif
 #elif O_BF
 #include "libbf/bf_gmp.h"
 #include "pl-bf.h"
@@ -114,6 +118,16 @@ char *	skipMPQOnCharp(const char *data);
 int	mpz_to_int64(mpz_t mpz, int64_t *i);
 int	mpz_to_uint64(mpz_t mpz, uint64_t *i);
 void	mpz_init_set_si64(mpz_t mpz, int64_t i);
+#ifdef O_INT128
+int	mpz_to_int128(const mpz_t mpz, __int128 *i);
+void	mpz_init_set_int128(mpz_t mpz, __int128 i);
+#endif
+int	mpz_set_digits(mpz_t r, const char *s, int base);
+#if O_BF
+void	freeRadixCache(PL_local_data_t *ld);
+#else
+#define freeRadixCache(ld) (void)0
+#endif
 double	mpz_to_double(mpz_t n);
 double	mpq_to_double(mpq_t q);
 void	mpq_set_double(mpq_t q, double f);
@@ -7,6 +7,7 @@
 
 #ifdef NO_SWIPL
 #include <stdint.h>
+#include <string.h>
 #define DEBUG(l,g) (void)0
 #else
 #include "pl-incl.h"
@@ -214,3 +215,150 @@ MurmurHashIntptr(intptr_t v, unsigned int seed)
 
   return h;
 }
+
+
+		 /*******************************
+		 *	   64-BIT WYHASH	*
+		 *******************************/
+
+/* - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+WyHash64() is a 64-bit hash  in  the   style  of  wyhash  by Wang Yi
+(public domain, https://github.com/wangyi-fudan/wyhash).  It processes 8
+bytes per load and  uses  three   independent  multiply  lanes for long
+keys, which allows the CPU to overlap the 64x64->128 multiplications.
+For the short keys that dominate index  lookup  it needs only two or
+three loads and two multiplications.
+
+Unlike MurmurHashAligned2(), input is always read as little endian and
+the result does not depend on alignment, so   the output is stable over
+platforms.  MurmurHashAligned2() must remain in  use wherever hashes are
+visible to the user and may have   been stored (term_hash/2 and friends,
+see atom_term_hash()).  This includes  the  hash  of atoms, which is also
+used for the atom table.
+- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
+static const uint64_t wyp[4] =
+{ 0xa0761d6478bd642fULL, 0xe7037ed1a0b428dbULL,
+  0x8ebc6af09c88c6e3ULL, 0x589965cc75374cc3ULL
+};
+
+static inline void
+wymum(uint64_t *a, uint64_t *b)
+{
+#ifdef HAVE_INT128
+  unsigned __int128 r = (unsigned __int128)*a * *b;
+
+  *a = (uint64_t)r;
+  *b = (uint64_t)(r>>64);
+#else
+  uint64_t ha = *a>>32, hb = *b>>32, la = (uint32_t)*a, lb = (uint32_t)*b;
+  uint64_t rh = ha*hb, rm0 = ha*lb, rm1 = hb*la, rl = la*lb;
+  uint64_t t = rl+(rm0<<32), c = t<rl;
+  uint64_t lo = t+(rm1<<32);
+
+  c += lo<t;
+  *a = lo;
+  *b = rh+(rm0>>32)+(rm1>>32)+c;
+#endif
+}
+
+static inline uint64_t
+wymix(uint64_t a, uint64_t b)
+{ wymum(&a, &b);
+  return a^b;
+}
+
+static inline uint64_t
+wyr8(const unsigned char *p)
+{ uint64_t v;
+
+  memcpy(&v, p, 8);
+#if WORDS_BIGENDIAN
+  v = ( ((v>>56)&0xff)       | ((v>>40)&0xff00)      |
+	((v>>24)&0xff0000)   | ((v>> 8)&0xff000000)  |
+	((v<< 8)&0xff00000000ULL)     | ((v<<24)&0xff0000000000ULL) |
+	((v<<40)&0xff000000000000ULL) | (v<<56) );
+#endif
+  return v;
+}
+
+static inline uint64_t
+wyr4(const unsigned char *p)
+{ uint32_t v;
+
+  memcpy(&v, p, 4);
+#if WORDS_BIGENDIAN
+  v = ( (v>>24) | ((v>>8)&0xff00) | ((v<<8)&0xff0000) | (v<<24) );
+#endif
+  return v;
+}
+
+static inline uint64_t
+wyr3(const unsigned char *p, size_t k)
+{ return ((uint64_t)p[0])<<16 | ((uint64_t)p[k>>1])<<8 | p[k-1];
+}
+
+uint64_t
+WyHash64(const void *key, size_t len, uint64_t seed)
+{ const unsigned char *p = key;
+  uint64_t a, b;
+
+  seed ^= wymix(seed^wyp[0], wyp[1]);
+
+  if ( len <= 16 )
+  { if ( len >= 4 )
+    { size_t o = (len>>3)<<2;
+
+      a = (wyr4(p)<<32)     | wyr4(p+o);
+      b = (wyr4(p+len-4)<<32) | wyr4(p+len-4-o);
+    } else if ( len > 0 )
+    { a = wyr3(p, len);
+      b = 0;
+    } else
+    { a = b = 0;
+    }
+  } else
+  { size_t i = len;
+
+    if ( i > 48 )
+    { uint64_t see1 = seed, see2 = seed;
+
+      do
+      { seed = wymix(wyr8(p)   ^wyp[1], wyr8(p+8) ^seed);
+	see1 = wymix(wyr8(p+16)^wyp[2], wyr8(p+24)^see1);
+	see2 = wymix(wyr8(p+32)^wyp[3], wyr8(p+40)^see2);
+	p += 48;
+	i -= 48;
+      } while ( i > 48 );
+      seed ^= see1^see2;
+    }
+    while ( i > 16 )
+    { seed = wymix(wyr8(p)^wyp[1], wyr8(p+8)^seed);
+      i -= 16;
+      p += 16;
+    }
+    a = wyr8(p+i-16);
+    b = wyr8(p+i-8);
+  }
+
+  a ^= wyp[1];
+  b ^= seed;
+  wymum(&a, &b);
+
+  return wymix(a^wyp[0]^len, b^wyp[1]);
+}
+
+
+/* - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Hash a single machine word.  This  replaces MurmurHashIntptr() for hash
+tables that are never visible outside the process.
+- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
+uint64_t
+WyHashIntptr(intptr_t v, uint64_t seed)
+{ uint64_t a = (uint64_t)v^wyp[0];
+  uint64_t b = seed^wyp[1];
+
+  wymum(&a, &b);
+  return wymix(a^wyp[0], b^wyp[1]);
+}
@@ -11,9 +11,15 @@
 #define PL_HASH_H_INCLUDED
 
 #define MURMUR_SEED	(0x1a3be34a)
+#define WYHASH_SEED	(0x1a3be34a5ae78d4bULL)
 
 COMMON(unsigned int)
 	MurmurHashAligned2(const void *key, size_t len, unsigned int seed);
 COMMON(unsigned int) MurmurHashIntptr(intptr_t v, unsigned int seed);
+COMMON(uint64_t) WyHash64(const void *key, size_t len, uint64_t seed);
+COMMON(uint64_t) WyHashIntptr(intptr_t v, uint64_t seed);
+
+/* 32-bit versions for hash tables that store an unsigned int key */
+#define WyHash32(key, len, seed) ((unsigned int)WyHash64(key, len, seed))
 
 #endif /*PL_HASH_H_INCLUDED*/
@@ -578,6 +578,7 @@ them.  Descriptions:
 #define OP_MAXPRIORITY		1200	/* maximum operator priority */
 #define SMALLSTACK		32 * 1024 /* GC policy */
 #define MAX_PORTRAY_NESTING	100	/* Max recursion in portray */
+#define CYCLE_CHECK_THRESHOLD	10000	/* Default for cycle_check_threshold */
 
 #define LOCAL_MARGIN ((size_t)argFrameP((LocalFrame)NULL, MAXARITY) + \
 		      sizeof(struct choice))
@@ -928,6 +929,7 @@ typedef enum
 #define	ALERT_BUFFER	     0x100
 #define	ALERT_UNDO	     0x200
 #define ALERT_COVERAGE	     0x400
+#define ALERT_ALLOCPROF	     0x800
 
 
 		 /*******************************
@@ -999,6 +1001,8 @@ with one operation, it turns out to be faster as well.
 #define FILE_ASSIGNED		(0x40000000LL) /* Is assigned to a file */
 #define P_REDEFINED		(0x80000000LL) /* Overrules a definition */
 #define P_SIG_ATOMIC	      (0x0100000000LL) /* Do not call handleSignals */
+#define P_COUNTED	      (0x0200000000LL) /* Count ports (pl-counters.c) */
+#define P_COUNT_LATENCY	      (0x0400000000LL) /* Also record exit latency */
 #define PROC_DEFINED		(P_DYNAMIC|P_FOREIGN|P_MULTIFILE|\
 				 P_DISCONTIGUOUS|P_LOCKED_SUPERVISOR)
 /* flags for p_reload data (reconsult) */
@@ -1091,6 +1095,7 @@ Macros for environment frames (local stack frames)
 #define FR_DET			(0x0800) /* Declared det */
 #define FR_DETGUARD		(0x1000) /* Frame is guarded for determinism */
 #define FR_DETGUARD_SET		(0x2000) /* Flag was set on this frame */
+#define FR_COUNTED_LCO		(0x4000) /* Counted exits after LCO pending */
 #define FR_WATCHED (FR_CLEANUP|FR_DEBUG)
 
 #define FR_MAGIC_MASK		(0xffff0000)
@@ -1174,7 +1179,7 @@ typedef uint64_t lgen_t;
 			 FR_HIDE_CHILDS|FR_CLEANUP|FR_SSU_DET)
 #define FR_CLEAR_NEXT	(FR_LCO_CLEAR|FR_DET|FR_DETGUARD)
 #define FR_CLEAR_ALWAYS (FR_CONTEXT|FR_DETGUARD_SET)
-#define FR_CLEAR_FLAGS	(FR_CLEAR_NEXT|FR_CLEAR_ALWAYS)
+#define FR_CLEAR_FLAGS	(FR_CLEAR_NEXT|FR_CLEAR_ALWAYS|FR_COUNTED_LCO)
 
 #define setNextFrameFlags(next, fr) \
 	do \
@@ -1185,11 +1190,17 @@ typedef uint64_t lgen_t;
 #define lcoSetNextFrameFlags2(next, fr) \
 	do \
 	{ (next)->level = (fr)->level+1; \
-	  (next)->flags = ((fr)->flags) & ~(FR_LCO_CLEAR|FR_CLEAR_ALWAYS); \
+	  (next)->flags = ((fr)->flags) & \
+			  ~(FR_LCO_CLEAR|FR_CLEAR_ALWAYS|FR_COUNTED_LCO); \
 	} while(0)
 
+/* The frame is reused, so FR_COUNTED_LCO is preserved */
+
 #define lcoSetNextFrameFlags(fr) \
-	lcoSetNextFrameFlags2(fr,fr)
+	do \
+	{ (fr)->level = (fr)->level+1; \
+	  (fr)->flags = ((fr)->flags) & ~(FR_LCO_CLEAR|FR_CLEAR_ALWAYS); \
+	} while(0)
 
 /* For a tail call we must not clear FR_CONTEXT.  The combination
  * of FR->context and FR_CONTEXT is always correct.
@@ -1278,6 +1289,8 @@ We assume the compiler will optimise this properly.
 Structure declarations that must be shared across multiple files.
 - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
 
+#define ATOM_CACHE_SIZE 256	/* Per-thread atom cache (power of 2) */
+
 struct atom
 { Atom		next;		/* next in chain */
   word		atom;		/* as appearing on the global stack */
@@ -1298,6 +1311,7 @@ struct atom
 
 typedef struct atom_array
 { Atom blocks[8*sizeof(void*)];
+  unsigned char *write_types[8*sizeof(void*)]; /* See pl-write.c */
 } atom_array;
 
 typedef struct atom_table * AtomTable;
@@ -1306,6 +1320,9 @@ typedef struct atom_table
 { AtomTable	prev;
   int		buckets;
   Atom *	table;
+  size_t	migrate_high;	/* Migrate atoms below this index */
+  size_t	migrate_next;	/* Next atom to claim for migration */
+  size_t	migrated;	/* # atoms migrated (starts at 1) */
 } atom_table;
 
 
@@ -1362,6 +1379,9 @@ typedef struct functor_table
 { FunctorTable	prev;
   int		buckets;
   FunctorDef *	table;
+  size_t	migrate_high;	/* Migrate functors below this index */
+  size_t	migrate_next;	/* Next functor to claim for migration */
+  size_t	migrated;	/* # functors migrated (starts at 1) */
 } functor_table;
 
 #define FUNCTOR_IS_VALID(flags)		((flags) & VALID_F)
@@ -1480,6 +1500,8 @@ typedef struct gc_stat
   size_t	trail_before;
   size_t	trail_after;
   size_t	local;
+  size_t	global_size;		/* allocated global after GC */
+  size_t	trail_size;		/* allocated trail after GC */
   double	gc_time;		/* time spent on last GC */
   double	prolog_time;		/* Real work CPU before this GC */
   gc_reason_t	reason;			/* why GC was run */
@@ -1492,6 +1514,7 @@ typedef struct gc_stats
   int		aggr_index;
   double	thread_cpu;		/* Last thread CPU time */
   gc_reason_t	request;		/* Requesting stack */
+  int64_t	reported;		/* Collections sent as `gc` event */
   struct
   { int64_t	collections;
     int64_t	global_gained;		/* global stack bytes collected */
@@ -1620,6 +1643,7 @@ struct definition
   gen_t		last_modified;		/* Generation I was last modified */
   struct event_list  *events;		/* Forward update events */
   struct table_props *tabling;		/* Extended properties for tabling */
+  struct pred_counters *counters;	/* Port counters (pl-counters.c) */
 #if defined(__SANITIZE_ADDRESS__)
   char	       *name;			/* Name for debugging */
 #endif
@@ -2168,10 +2192,11 @@ typedef enum virtual_signum
   VSIG_CLAUSE_GC,
   VSIG_PLABORT,
   VSIG_TUNE_GC,
+  VSIG_GC_EVENT,
   VSIG_MAX
 } virtual_signum;
 
-#define NUM_VSIGS 6 /* Preprocessor can see this constant */
+#define NUM_VSIGS 7 /* Preprocessor can see this constant */
 static_assertion(NUM_VSIGS == VSIG_MAX); /* Make sure it matches the enum */
 static_assertion(NUM_SIGNALS >= VSIG_MAX && NUM_SIGNALS < 128); /* Sanity check, 128 is arbitrary */
 static_assertion(SIG_PROLOG_OFFSET >= MINSIGNAL && SIG_PROLOG_OFFSET + NUM_VSIGS <= MAXSIGNAL);
@@ -2187,6 +2212,7 @@ static_assertion(SIG_PROLOG_OFFSET >= MINSIGNAL && SIG_PROLOG_OFFSET + NUM_VSIGS
 #define SIG_CLAUSE_GC	  (SIG_PROLOG_OFFSET+VSIG_CLAUSE_GC)
 #define SIG_PLABORT	  (SIG_PROLOG_OFFSET+VSIG_PLABORT)
 #define SIG_TUNE_GC	  (SIG_PROLOG_OFFSET+VSIG_TUNE_GC)
+#define SIG_GC_EVENT	  (SIG_PROLOG_OFFSET+VSIG_GC_EVENT)
 
 /* The "search for a free signal" functionality of PL_sigaction starts after
  * the predefined VSIG numbers */
@@ -2529,6 +2555,7 @@ typedef struct
   int		local_shifts;		/* Shifts of the local stack */
   int		global_shifts;		/* Shifts of the global stack */
   int		trail_shifts;		/* Shifts of the trail stack */
+  int		inplace_shifts;		/* Resized without moving */
 } pl_shift_status_t;
 
 
@@ -2686,7 +2713,8 @@ typedef enum plflag
   PLFLAG_DEBUG_ON_INTERRUPT,		/* Debug on Control-C */
   PLFLAG_OPTIMISE_UNIFY,		/* Move unifications in clauses */
   PLFLAG_SHIFT_CHECK,			/* Check suspicious shifts */
-  PLFLAG_AGC_CLOSE_STREAMS		/* AGC may close open streams */
+  PLFLAG_AGC_CLOSE_STREAMS,		/* AGC may close open streams */
+  PLFLAG_STACK_RESERVE			/* Grow stacks in reserved VM */
 } plflag;
 
 typedef struct
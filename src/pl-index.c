@@ -137,7 +137,7 @@ indexing.
 
 static inline int
 hashIndex(word key, int buckets)
-{ unsigned int k = MurmurHashIntptr(key, MURMUR_SEED);
+{ unsigned int k = (unsigned int)WyHashIntptr(key, WYHASH_SEED);
 
   return k & (buckets-1);
 }
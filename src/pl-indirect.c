@@ -169,7 +169,7 @@ word
 intern_indirect(DECL_LD indirect_table *tab, word val, int create)
 { Word	 idata     = addressIndirect(val);	/* points at header */
   size_t isize     = wsizeofInd(*idata);	/* include header */
-  unsigned int key = MurmurHashAligned2(idata+1, isize*sizeof(word), MURMUR_SEED);
+  unsigned int key = WyHash32(idata+1, isize*sizeof(word), WYHASH_SEED);
   indirect_buckets *buckets;
 
   for(;;)
@@ -358,7 +358,7 @@ rehash_indirect_table(indirect_table *tab)
 	{ size_t sz = wsizeofInd(a->header);
 	  unsigned int v;
 
-	  v = MurmurHashAligned2(a->data, sz*sizeof(word), MURMUR_SEED) & mask;
+	  v = WyHash32(a->data, sz*sizeof(word), WYHASH_SEED) & mask;
 	  a->next = newtab->buckets[v];
 	  newtab->buckets[v] = a;
 	}
@@ -47,6 +47,9 @@
     #pragma intrinsic(_BitScanReverse)
   #endif
 #endif
+#ifdef HAVE_SCHED_YIELD
+#include <sched.h>
+#endif
 
 #include "pl-transaction.h"
 #include "pl-atom.h"
@@ -253,6 +256,27 @@ MSB64(int64_t i)
 #define MEMORY_RELEASE() (void)0
 #endif
 
+/* spin_wait() is called in a loop that waits for another thread to
+   complete a short task.  It spins for a while and then yields the CPU
+   such that the waiting does not starve the thread we are waiting for.
+*/
+
+static inline void
+spin_wait(unsigned int *spins)
+{ if ( ++*spins < 256 )
+  { MEMORY_BARRIER();
+  } else
+  { *spins = 0;
+#ifdef __WINDOWS__
+    SwitchToThread();
+#elif defined(HAVE_SCHED_YIELD)
+    sched_yield();
+#else
+    MEMORY_BARRIER();
+#endif
+  }
+}
+
 		 /*******************************
 		 *	 ATOMS/FUNCTORS		*
 		 *******************************/
@@ -271,6 +295,17 @@ fetchAtomArray(size_t index)
 }
 
 
+/* Cached classification of an atom for writing.  See pl-write.c */
+
+static inline unsigned char *
+atomWriteTypeP(atom_t a)
+{ size_t index = indexAtom(a);
+  int idx = MSB(index);
+
+  return &GD->atoms.array.write_types[idx][index];
+}
+
+
 static inline FunctorDef
 fetchFunctorArray(size_t index)
 { int idx = MSB(index);
@@ -397,6 +432,40 @@ same_type_numbers(Number n1, Number n2)
   return make_same_type_numbers(n1, n2);
 }
 
+/* - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+identical_prefix() returns the length  of   the  common  prefix  of two
+argument vectors that consists of  identical   cells  that are not free
+variables. Such cells are equal under   standard  order of terms. With
+`atomic`, the prefix is further restricted to  atomic cells, as needed
+if variables reachable through  a  compound   or  reference  must  be
+visited (e.g., variant checking). Blocks  of   four  cells are compared
+using a single test to keep the common case branch-free.
+- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
+#define SKIPPABLE_CELL(w, atomic) \
+	((atomic) ? (tag(w)-TAG_FLOAT) <= (TAG_ATOM-TAG_FLOAT) : !isVar(w))
+
+static inline size_t
+identical_prefix(const word *p1, const word *p2, size_t n, int atomic)
+{ size_t i = 0;
+
+  for(; i+4 <= n; i += 4)
+  { if ( ((p1[i]^p2[i]) | (p1[i+1]^p2[i+1]) |
+	  (p1[i+2]^p2[i+2]) | (p1[i+3]^p2[i+3])) != 0 ||
+	 !SKIPPABLE_CELL(p1[i],   atomic) ||
+	 !SKIPPABLE_CELL(p1[i+1], atomic) ||
+	 !SKIPPABLE_CELL(p1[i+2], atomic) ||
+	 !SKIPPABLE_CELL(p1[i+3], atomic) )
+      break;
+  }
+  for(; i < n; i++)
+  { if ( p1[i] != p2[i] || !SKIPPABLE_CELL(p1[i], atomic) )
+      break;
+  }
+
+  return i;
+}
+
 /* - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 Mark() sets LD->mark_bar, indicating  that   any  assignment  above this
 value need not be trailed.
@@ -651,7 +720,8 @@ is the size in bytes, a multiple of sizeof(word). If the indirect is too
 long we has based on the start, end and length.
 
 The hash should not conflict  with   a  functor_t  (hence the STG_GLOBAL
-mask) and may never be 0.
+mask) and may never be 0. The key  is   never  visible  outside  the
+process, so we use the faster WyHash64() rather than MurmurHashAligned2().
 - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
 
 #define KEY_INDEX_MAX 4
@@ -671,9 +741,9 @@ murmur_key(const void *ptr, size_t n)
     data[KEY_INDEX_MAX-2] = in[n/sizeof(word)-1];
     data[KEY_INDEX_MAX-1] = n;
 
-    k = MurmurHashAligned2(data, sizeof(word)*4, MURMUR_SEED);
+    k = WyHash64(data, sizeof(word)*4, WYHASH_SEED);
   } else
-  { k = MurmurHashAligned2(ptr, n, MURMUR_SEED);
+  { k = WyHash64(ptr, n, WYHASH_SEED);
   }
 
   k &= ~((word)STG_GLOBAL);
@@ -47,6 +47,7 @@
 #include "pl-read.h"
 #include "pl-util.h"
 #include "pl-funct.h"
+#include "pl-atom.h"
 #include "os/pl-ctype.h"
 #include "os/pl-utf8.h"
 #include "os/pl-cstack.h"
@@ -115,6 +116,16 @@ of approx. 30%. On the other hand,  if subterms appear multiple times in
 a term unification can be much faster. As only a small percentage of the
 unifications of a realistic program are   covered by unify() and involve
 deep unification the overall impact of performance is small (< 3%).
+
+To avoid this overhead in the  common   case,  do_unify()  and the term
+comparison first process terms as if they are acyclic, i.e., they do not
+link the functors. Only after processing LD->prolog_flag.cycle_threshold
+compound pairs (the Prolog  flag   `cycle_check_threshold`)  they start
+linking. This is safe as  linking  merely   asserts  that  two compounds
+are equal. Linking from some  point  onwards   still  guarantees  that a
+cyclic term is visited only a finite number   of  times after that. The
+threshold also bounds the work  on  acyclic  terms with massive sharing,
+for which the linking avoids repeated visits of shared subterms.
 - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
 
 #define initvisited(_) LDFUNC(initvisited, _)
@@ -268,6 +279,7 @@ do_unify(DECL_LD Word t1, Word t2)
 { term_agendaLR agenda;
   int compound = FALSE;
   int rc = FALSE;
+  size_t budget = LD->prolog_flag.cycle_threshold;
 
   do
   { word w1, w2;
@@ -395,7 +407,10 @@ do_unify(DECL_LD Word t1, Word t2)
 	  }
 	}
 
-	linkTermsCyclic(f1, f2);
+	if ( budget > 0 )
+	  budget--;
+	else
+	  linkTermsCyclic(f1, f2);
 
 	continue;
       }
@@ -1523,8 +1538,9 @@ termHashValue(DECL_LD word term, long depth, unsigned int *hval)
       case TAG_ATTVAR:
 	fail;
       case TAG_ATOM:
-      { *hval = MurmurHashAligned2(&atomValue(term)->hash_value,
-				   sizeof(unsigned int), *hval);
+      { unsigned int ah = atom_term_hash(atomValue(term));
+
+	*hval = MurmurHashAligned2(&ah, sizeof(ah), *hval);
 	succeed;
       }
       case TAG_STRING:
@@ -1568,7 +1584,7 @@ termHashValue(DECL_LD word term, long depth, unsigned int *hval)
 	fd = valueFunctor(t->definition);
 	arity = fd->arity;
 
-	atom_hashvalue = atomValue(fd->name)->hash_value + arity;
+	atom_hashvalue = atom_term_hash(atomValue(fd->name)) + arity;
 	*hval = MurmurHashAligned2(&atom_hashvalue,
 				   sizeof(atom_hashvalue),
 				   *hval);
@@ -1845,14 +1861,60 @@ compare_functors(word f1, word f2, int eq)
   }
 }
 
+/* - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+nextDifferentAgendaLR() is nextTermAgendaLR(), skipping runs of identical
+argument cells. Identical cells that are   not  free variables are equal
+under standard order, which notably  speeds   up  comparing  lists and
+compounds holding atoms and small integers.
+
+do_compare() walks the spines of lists whose heads are identical in a
+tight loop. As the heads are not  visited,   the  only  cycle such a run
+can enter is through the spine. Once   the  cycle threshold is exceeded
+it is therefore enough to link every   16th  list cell: a cyclic spine
+hits a linked cell after at most one more round and a walk that enters
+the spine again stops at the next linked cell.
+
+If the cycle threshold is 0,  do_compare()   uses  the  old algorithm: it
+neither skips identical cells nor runs along lists and it links every
+compound pair.
+- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
+static inline int
+nextDifferentAgendaLR(term_agendaLR *a, Word *lp, Word *rp)
+{ for(;;)
+  { if ( a->work.size > 0 )
+    { size_t skip = identical_prefix(a->work.left, a->work.right,
+				     a->work.size, FALSE);
+
+      if ( skip < a->work.size )
+      { a->work.size  -= skip+1;
+	*lp = a->work.left  + skip;
+	*rp = a->work.right + skip;
+	a->work.left  += skip+1;
+	a->work.right += skip+1;
+
+	return TRUE;
+      }
+    }
+
+    if ( !popSegStack(&a->stack, &a->work, aNodeLR) )
+      return FALSE;
+  }
+}
+
+
 #define do_compare(agenda, f1, f2, eq) LDFUNC(do_compare, agenda, f1, f2, eq)
 static int
 do_compare(DECL_LD term_agendaLR *agenda, Functor f1, Functor f2, int eq)
 { Word p1, p2;
+  size_t budget = LD->prolog_flag.cycle_threshold;
+  int skip = (budget > 0);		/* 0: old algorithm */
+  unsigned int run = 0;
 
   goto compound;
 
-  while( nextTermAgendaLR(agenda, &p1, &p2) )
+  while( skip ? nextDifferentAgendaLR(agenda, &p1, &p2)
+	      : nextTermAgendaLR(agenda, &p1, &p2) )
   { int rc;
 
     deRef(p1);
@@ -1879,11 +1941,42 @@ do_compare(DECL_LD term_agendaLR *agenda, Functor f1, Functor f2, int eq)
       { return compare_functors(f1->definition, f2->definition, eq);
       } else
       { int arity;
+	int list;
 
       compound:
 	arity = arityFunctor(f1->definition);
+	list  = (skip && f1->definition == FUNCTOR_dot2);
 
-	linkTermsCyclic(f1, f2);
+	if ( budget > 0 )
+	  budget--;
+	else
+	  linkTermsCyclic(f1, f2);
+					/* run along lists with identical heads */
+	while ( list &&
+		f1->arguments[0] == f2->arguments[0] &&
+		!isVar(f1->arguments[0]) )
+	{ Word t1 = &f1->arguments[1];
+	  Word t2 = &f2->arguments[1];
+	  Functor n1, n2;
+
+	  deRef(t1);
+	  deRef(t2);
+	  if ( !isTerm(*t1) || !isTerm(*t2) )
+	    break;
+	  n1 = valueTerm(*t1);
+	  n2 = valueTerm(*t2);
+	  if ( n1 == n2 ||
+	       n1->definition != FUNCTOR_dot2 ||
+	       n2->definition != FUNCTOR_dot2 )
+	    break;			/* also if linked */
+
+	  if ( budget > 0 )
+	    budget--;
+	  else if ( (++run&0xf) == 0 )	/* see nextDifferentAgendaLR() */
+	    linkTermsCyclic(n1, n2);
+	  f1 = n1;
+	  f2 = n2;
+	}
 	if ( !pushWorkAgendaLR(agenda, arity, f1->arguments, f2->arguments) )
 	{ PL_error(NULL, 0, NULL, ERR_RESOURCE, ATOM_memory);
 	  return CMP_ERROR;
@@ -4382,6 +4475,7 @@ concat(DECL_LD term_t a1, term_t a2, term_t a3,
 
   t1.text.t = t2.text.t = t3.text.t = NULL;
 
+  accept |= BUF_ALLOW_STACK;
   if ( !PL_get_text(a1, &t1, accept|inmode|CVT_EXCEPTION) ||
        !PL_get_text(a2, &t2, accept|inmode|CVT_EXCEPTION) ||
        !PL_get_text(a3, &t3, accept|CVT_EXCEPTION|CVT_VARNOFAIL) )
@@ -4452,8 +4546,12 @@ concat(DECL_LD term_t a1, term_t a2, term_t a3,
 	succeed;
     }
 
-    PL_unify_text_range(a2, &t3, at_n, L3-at_n, otype);
-    PL_unify_text_range(a1, &t3, 0,    at_n, otype);
+    if ( !PL_unify_text_range(a2, &t3, at_n, L3-at_n, otype) ||
+	 !PL_refresh_text(a3, &t3) ||
+	 !PL_unify_text_range(a1, &t3, 0, at_n, otype) )
+    { rc = FALSE;
+      goto out;
+    }
     if ( at_n < L3 )
       ForeignRedoInt(at_n+1);
 
@@ -4688,9 +4786,8 @@ PRED_IMPL("atomics_to_string", 2, atomics_to_string, 0)
 static
 PRED_IMPL("sub_atom_icasechk", 3, sub_atom_icasechk, 0)
 { PRED_LD
-  char       *needleA=NULL, *haystackA=NULL;
-  pl_wchar_t *needleW=NULL, *haystackW=NULL;
-  size_t l1, l2, offset;
+  PL_chars_t tn, th;
+  size_t offset;
   int has_offset;
 
   term_t haystack = A1;
@@ -4704,55 +4801,31 @@ PRED_IMPL("sub_atom_icasechk", 3, sub_atom_icasechk, 0)
   else
     return FALSE;
 
-  if ( PL_get_nchars(needle,   &l1, &needleA, CVT_ALL|BUF_STACK) &&
-       PL_get_nchars(haystack, &l2, &haystackA, CVT_ALL) )
-  { char *s, *q, *s2 = haystackA + offset;
-    const char *eq = (const char *)&needleA[l1];
-    const char *es = (const char *)&haystackA[l2];
+  if ( !PL_get_text(needle,   &tn, CVT_ALL|CVT_EXCEPTION|BUF_STACK) ||
+       !PL_get_text(haystack, &th, CVT_ALL|CVT_EXCEPTION|BUF_ALLOW_STACK) )
+    return FALSE;
 
-    for (; s2<=es-l1; s2++)
-    { for(q=needleA, s=s2; q<eq && s<es; q++, s++)
-      { if ( *q != *s && *q != toLower(*s) )
-	  break;
-      }
-      if ( q == eq )
-      { offset = s2-haystackA;
-	goto found;
-      }
-      if ( has_offset )
-	break;
-    }
-    fail;
-  }
+  if ( has_offset )
+  { size_t i;
 
-  if ( PL_get_wchars(needle,   &l1, &needleW, CVT_ALL|CVT_EXCEPTION|BUF_STACK) &&
-       PL_get_wchars(haystack, &l2, &haystackW, CVT_ALL|CVT_EXCEPTION) )
-  { pl_wchar_t *s, *q, *s2 = haystackW + offset;
-    pl_wchar_t *eq = &needleW[l1];
-    pl_wchar_t *es = &haystackW[l2];
+    if ( offset > th.length || tn.length > th.length-offset )
+      return FALSE;
+    for(i=0; i<tn.length; i++)
+    { int q = text_get_char(&tn, i);
+      int c = text_get_char(&th, offset+i);
 
-    for (; s2<=es-l1; s2++)
-    { for(q=needleW, s=s2; q<eq && s<es; q++, s++)
-      { if ( *q != *s && *q != (pl_wchar_t)towlower(*s) )
-	  break;
-      }
-      if ( q == eq )
-      { offset = s2-haystackW;
-	goto found;
-      }
-      if ( has_offset )
-	break;
+      if ( q != c &&
+	   q != (th.encoding == ENC_ISO_LATIN_1 ? makeLower(c)
+						: makeLowerW(c)) )
+	return FALSE;
     }
-    fail;
+    return TRUE;
   }
 
-  return FALSE;
-
-found:
-  if ( !has_offset )
+  if ( (offset=PL_search_text(&th, 0, &tn, PL_SEARCH_ICASE)) != (size_t)-1 )
     return PL_unify_integer(start, offset);
 
-  return TRUE;
+  return FALSE;
 }
 
 
@@ -4792,9 +4865,20 @@ typedef struct
   size_t n1;				/* 1-st state id */
   size_t n2;				/* 2-nd state id */
   size_t n3;
+  text_search *search;			/* SUB_SEARCH: prepared needle */
 } sub_state;
 
 
+static void
+free_sub_state(sub_state *state)
+{ if ( state->search )
+  { PL_free_text_search(state->search);
+    freeForeignState(state->search, sizeof(*state->search));
+  }
+  freeForeignState(state, sizeof(*state));
+}
+
+
 #define get_positive_integer_or_unbound(t, v) \
 	LDFUNC(get_positive_integer_or_unbound, t, v)
 
@@ -4866,11 +4950,15 @@ sub_text(DECL_LD term_t atom,
 	  }
 	  return FALSE;
 	}
+	if ( ls > la )
+	  return FALSE;
 	state = allocForeignState(sizeof(*state));
 	state->type = SUB_SEARCH;
 	state->n1   = 0;
 	state->n2   = la;
 	state->n3   = ls;
+	state->search = allocForeignState(sizeof(*state->search));
+	PL_init_text_search(state->search, &ts, 0);
 	break;
       }
 
@@ -4899,6 +4987,7 @@ sub_text(DECL_LD term_t atom,
 	}
 	state = allocForeignState(sizeof(*state));
 	state->type = SUB_SPLIT_TAIL;
+	state->search = NULL;
 	state->n1   = 0;		/* len of the split */
 	state->n2   = la;		/* length of the atom */
 	state->n3   = b;		/* length before */
@@ -4922,6 +5011,7 @@ sub_text(DECL_LD term_t atom,
 	}
 	state = allocForeignState(sizeof(*state));
 	state->type = SUB_SPLIT_LEN;
+	state->search = NULL;
 	state->n1   = 0;		/* before */
 	state->n2   = l;		/* length */
 	state->n3   = la;
@@ -4934,6 +5024,7 @@ sub_text(DECL_LD term_t atom,
 
 	state = allocForeignState(sizeof(*state));
 	state->type = SUB_SPLIT_HEAD;
+	state->search = NULL;
 	state->n1   = 0;		/* before */
 	state->n2   = la;
 	state->n3   = a;
@@ -4942,6 +5033,7 @@ sub_text(DECL_LD term_t atom,
 
       state = allocForeignState(sizeof(*state));
       state->type = SUB_ENUM;
+      state->search = NULL;
       state->n1	= 0;			/* before */
       state->n2 = 0;			/* len */
       state->n3 = la;			/* total length */
@@ -4954,7 +5046,7 @@ sub_text(DECL_LD term_t atom,
     case FRG_CUTTED:
       state = ForeignContextPtr(h);
       if ( state )
-	freeForeignState(state, sizeof(*state));
+	free_sub_state(state);
       return TRUE;
     default:
       assert(0);
@@ -4965,21 +5057,23 @@ sub_text(DECL_LD term_t atom,
 again:
   switch(state->type)
   { case SUB_SEARCH:
-    { PL_get_text(sub, &ts, CVT_ATOMIC|BUF_ALLOW_STACK);
+    { size_t at;
+
+      PL_get_text(sub, &ts, CVT_ATOMIC|BUF_ALLOW_STACK);
       lab = state->n2;
       lsb = state->n3;
 
-      for( ; state->n1+ls <= la; state->n1++ )
-      { if ( PL_cmp_text(&ta, state->n1, &ts, 0, ls) == 0 )
-	{ match = (PL_unify_integer(before, state->n1) &&
-		   PL_unify_integer(len,    ls) &&
-		   PL_unify_integer(after,  la-ls-state->n1));
+      if ( (at=PL_text_search(state->search, &ta, state->n1, &ts)) !=
+	   (size_t)-1 )
+      { state->n1 = at;
+	match = (PL_unify_integer(before, state->n1) &&
+		 PL_unify_integer(len,    ls) &&
+		 PL_unify_integer(after,  la-ls-state->n1));
 
-	  if ( ++state->n1 + ls > la )
-	    goto exit_succeed;
-	  else
-	    goto next;
-	}
+	if ( ++state->n1 + ls > la )
+	  goto exit_succeed;
+	else
+	  goto next;
       }
       goto exit_fail;
     }
@@ -5050,11 +5144,11 @@ again:
   }
 
 exit_fail:
-  freeForeignState(state, sizeof(*state));
+  free_sub_state(state);
   return FALSE;
 
 exit_succeed:
-  freeForeignState(state, sizeof(*state));
+  free_sub_state(state);
   return TRUE;
 
 next:
@@ -5726,10 +5820,18 @@ swi_statistics(DECL_LD atom_t key, Number v)
     v->value.i = GD->statistics.atoms;
   else if (key == ATOM_atom_space)			/* atom_space */
     v->value.i = atom_space();
+  else if (key == ATOM_atom_table_resizes)		/* atom_table_resizes */
+    v->value.i = GD->atoms.rehashes;
+  else if (key == ATOM_atom_table_retries)		/* atom_table_retries */
+    v->value.i = GD->atoms.retries;
   else if (key == ATOM_functors)			/* functors */
     v->value.i = GD->statistics.functors;
   else if (key == ATOM_functor_space)			/* functor_space */
     v->value.i = functor_space();
+  else if (key == ATOM_functor_table_resizes)		/* functor_table_resizes */
+    v->value.i = GD->functors.rehashes;
+  else if (key == ATOM_functor_table_retries)		/* functor_table_retries */
+    v->value.i = GD->functors.retries;
   else if (key == ATOM_predicates)			/* predicates */
     v->value.i = GD->statistics.predicates;
   else if (key == ATOM_clauses)				/* clauses */
@@ -5784,6 +5886,8 @@ swi_statistics(DECL_LD atom_t key, Number v)
     v->value.i = LD->shift_status.local_shifts;
   else if (key == ATOM_trail_shifts)
     v->value.i = LD->shift_status.trail_shifts;
+  else if (key == ATOM_inplace_shifts)
+    v->value.i = LD->shift_status.inplace_shifts;
   else if (key == ATOM_shift_time)
   { v->type = V_FLOAT;
     v->value.f = LD->shift_status.time;
@@ -5797,6 +5901,10 @@ swi_statistics(DECL_LD atom_t key, Number v)
   else if ( key == ATOM_engines )
     v->value.i = GD->statistics.engines_created -
 		 GD->statistics.engines_finished;
+  else if ( key == ATOM_idle_trims )
+    v->value.i = GD->statistics.idle_trims;
+  else if ( key == ATOM_idle_trim_gained )
+    v->value.i = GD->statistics.idle_trim_gained;
   else if ( key == ATOM_threads_created )
     v->value.i = GD->statistics.threads_created -
 		 GD->statistics.engines_created;
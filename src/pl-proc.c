@@ -41,6 +41,7 @@
 #include "pl-dbref.h"
 #include "pl-event.h"
 #include "pl-tabling.h"
+#include "pl-counters.h"
 #include "pl-transaction.h"
 #include "pl-util.h"
 #include "pl-supervisor.h"
@@ -263,6 +264,8 @@ void
 unallocDefinition(Definition def)
 { if ( def->tabling )
     freeHeap(def->tabling, sizeof(*def->tabling));
+  if ( def->counters )
+    freeDefinitionCounters(def);
   if ( def->impl.any.args )
     freeHeap(def->impl.any.args, sizeof(arg_info)*def->functor->arity);
   if ( def->events )
@@ -3456,6 +3459,8 @@ static const patt_mask patt_masks[] =
   { ATOM_ssu,		   P_SSU_DET },
   { ATOM_det,		   P_DET },
   { ATOM_sig_atomic,	   P_SIG_ATOMIC },
+  { ATOM_counted,	   P_COUNTED },
+  { ATOM_count_latency,	   P_COUNT_LATENCY },
   { (atom_t)0,		   0 }
 };
 
@@ -3643,6 +3648,8 @@ PRED_IMPL("$get_predicate_attribute", 3, get_predicate_attribute,
   } else if ( key == ATOM_size )
   { def = getProcDefinition(proc);
     return PL_unify_integer(value, sizeof_predicate(def));
+  } else if ( key == ATOM_call_counts || key == ATOM_call_latency )
+  { return get_counters_attribute(def, key, value);
   } else if ( tbl_is_predicate_attribute(key) )
   { return tbl_get_predicate_attribute(def, key, value);
   } else if ( (att = attribute_mask(key)) )
@@ -3777,6 +3784,8 @@ setAttrDefinition(Definition def, uint64_t attr, int val)
   { rc = setClausableDefinition(def, val);
   } else if ( attr == P_DET )
   { rc = setDetDefinition(def, val);
+  } else if ( attr == P_COUNTED || attr == P_COUNT_LATENCY )
+  { rc = setCountedDefinition(def, attr, val);
   } else
   { if ( !val )
     { clear(def, attr);
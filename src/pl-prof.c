@@ -276,6 +276,14 @@ startProfiler(prof_status how)
 { GET_LD
   int sig, timer;
 
+  if ( GD->profile.samplers )
+  { term_t tid = PL_new_term_ref();
+
+    PL_unify_thread_id(tid, LD->thread.info->pl_tid);
+    return PL_error(NULL, 0, "sampling profiler is running",
+		    ERR_PERMISSION, ATOM_profile, ATOM_thread, tid);
+  }
+
   if ( how == PROF_CPU )
   { sig   = SIGPROF;
     timer = ITIMER_PROF;
@@ -1343,6 +1351,666 @@ freeProfileData(void)
   assert(LD->profile.nodes == 0);
 }
 
+		 /*******************************
+		 *      SAMPLING PROFILER	*
+		 *******************************/
+
+/* - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+The sampling profiler does not  instrument   calls.  Each thread that is
+sampled owns a POSIX timer that measures  the thread's CPU time or wall
+time and sends SIGPROF to  this  thread   (Linux  SIGEV_THREAD_ID).  The
+signal handler walks the parent chain   of  the current environment and
+writes the predicates of at most  `depth`   frames  into a ring buffer.
+A sample consists of a count n, followed by n Definition pointers, leaf
+first. If GC or a stack shift is in progress the stack cannot be walked
+and the sample is a single SAMPLE_GC pseudo frame.
+
+The ring buffer has a single producer (the signal handler) and a single
+consumer ('$prof_samples'/2) and is  lock-free:   the  producer  only
+writes `head` and the consumer only writes   `tail`. If there is no room
+for a sample it is dropped and counted.  The  timer runs on the thread's
+own time and the handler only  samples   its  own  thread, so threads can
+be sampled concurrently. The sampler and  the instrumenting profiler use
+the same signal and cannot run at the same time.
+
+Definitions are not reference counted.  Samples   must  be collected
+before the sampled predicates are destroyed.   This  is the case unless
+temporary modules are destroyed while being profiled.
+- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
+#if defined(HAVE_TIMER_CREATE) && defined(HAVE_SIGACTION) && \
+    !defined(__WINDOWS__)
+#define O_PROF_SAMPLER 1
+#endif
+
+#define SAMPLE_GC ((uintptr_t)1)	/* pseudo frame: GC or stack shift */
+
+#ifdef O_PROF_SAMPLER
+
+typedef struct prof_sampler
+{ timer_t	timer;			/* POSIX timer */
+  int		running;		/* timer is running */
+  unsigned int	depth;			/* max frames per sample */
+  size_t	mask;			/* size-1 of ring (power of 2) */
+  size_t	head;			/* next free (producer) */
+  size_t	tail;			/* first unread (consumer) */
+  uintptr_t	samples;		/* # samples taken */
+  uintptr_t	dropped;		/* # samples dropped (ring full) */
+  uintptr_t	ring[1];		/* sample records */
+} prof_sampler;
+
+#if defined(SIGEV_THREAD_ID) && !defined(sigev_notify_thread_id)
+#define sigev_notify_thread_id _sigev_un._tid
+#endif
+
+#define sample_stack(s) LDFUNC(sample_stack, s)
+static void
+sample_stack(DECL_LD prof_sampler *s)
+{ size_t head = s->head;
+  size_t tail = s->tail;
+  size_t n = 0;
+
+  MEMORY_ACQUIRE();
+  if ( s->mask+1 - (head-tail) < s->depth+1 )
+  { s->dropped++;
+    return;
+  }
+
+  if ( gc_status.active
+#ifdef O_PLMT
+       || LD->gc.active
+#endif
+     )
+  { s->ring[(head+1)&s->mask] = SAMPLE_GC;
+    n = 1;
+  } else
+  { LocalFrame fr = environment_frame;
+
+    while( fr && n < s->depth && onStackArea(local, fr) && fr->predicate )
+    { LocalFrame parent;
+
+      s->ring[(head+1+n)&s->mask] = (uintptr_t)fr->predicate;
+      n++;
+      parent = parentFrame(fr);
+      if ( parent >= fr )		/* parents are older */
+	break;
+      fr = parent;
+    }
+  }
+
+  if ( n > 0 )
+  { s->ring[head&s->mask] = n;
+    s->samples++;
+    MEMORY_RELEASE();
+    s->head = head+n+1;
+  }
+}
+
+
+static void
+sig_sample(int sig)
+{ GET_LD
+  int saved_errno = errno;
+  prof_sampler *s;
+  (void)sig;
+
+  if ( HAS_LD && (s=LD->profile.sampler) && s->running )
+    sample_stack(s);
+
+  errno = saved_errno;
+}
+
+
+static void
+free_sampler(PL_local_data_t *ld)
+{ prof_sampler *s;
+
+  if ( (s=ld->profile.sampler) )
+  { if ( s->running )
+    { timer_delete(s->timer);
+      ATOMIC_DEC(&GD->profile.samplers);
+    }
+    ld->profile.sampler = NULL;
+    MEMORY_BARRIER();
+    free(s);
+  }
+}
+
+
+/** '$prof_sample_start'(+Clock, +Frequency, +Depth, +Size)
+ *
+ * Start sampling the calling thread Frequency times per second of
+ * Clock (`cputime` or `walltime`), recording at most Depth frames per
+ * sample in a ring buffer of Size words.  Previously collected samples
+ * are discarded.
+ */
+
+static
+PRED_IMPL("$prof_sample_start", 4, prof_sample_start, 0)
+{ PRED_LD
+  prof_status how;
+  double hz;
+  int depth;
+  size_t size, words;
+  prof_sampler *s;
+  struct sigevent sev;
+  struct itimerspec its;
+  long ns;
+
+  if ( !get_prof_status(A1, &how) ||
+       !PL_get_float_ex(A2, &hz) ||
+       !PL_get_integer_ex(A3, &depth) ||
+       !PL_get_size_ex(A4, &size) )
+    return FALSE;
+  if ( how == PROF_INACTIVE )
+    return PL_domain_error("profile_status", A1);
+  if ( hz < 1.0 || hz > 100000.0 )
+    return PL_domain_error("sample_frequency", A2);
+  if ( depth < 1 )
+    return PL_domain_error("not_less_than_one", A3);
+  for(words=64; words < size || words < 2*((size_t)depth+1); words *= 2)
+    ;
+
+  if ( GD->profile.thread )
+    return PL_permission_error("sample", "profiler", A1);
+
+  free_sampler(LD);
+  if ( !(s = malloc(offsetof(prof_sampler, ring) + words*sizeof(uintptr_t))) )
+    return PL_no_memory();
+  memset(s, 0, offsetof(prof_sampler, ring));
+  s->depth = depth;
+  s->mask  = words-1;
+
+  set_sighandler_flags(SIGPROF, sig_sample, SA_RESTART);
+
+  memset(&sev, 0, sizeof(sev));
+  sev.sigev_signo = SIGPROF;
+#if defined(SIGEV_THREAD_ID) && defined(O_PLMT)
+  sev.sigev_notify = SIGEV_THREAD_ID;
+  sev.sigev_notify_thread_id = LD->thread.info->pid;
+#else
+  sev.sigev_notify = SIGEV_SIGNAL;
+#endif
+  if ( timer_create(how == PROF_CPU ? CLOCK_THREAD_CPUTIME_ID
+				    : CLOCK_MONOTONIC,
+		    &sev, &s->timer) != 0 )
+  { free(s);
+    return PL_error(NULL, 0, MSG_ERRNO, ERR_SYSCALL, "timer_create");
+  }
+
+  ns = (long)(1000000000.0/hz);
+  its.it_interval.tv_sec  = ns / 1000000000;
+  its.it_interval.tv_nsec = ns % 1000000000;
+  its.it_value            = its.it_interval;
+
+  LD->profile.sampler = s;
+  s->running = TRUE;
+  ATOMIC_INC(&GD->profile.samplers);
+  if ( timer_settime(s->timer, 0, &its, NULL) != 0 )
+  { int rc = PL_error(NULL, 0, MSG_ERRNO, ERR_SYSCALL, "timer_settime");
+
+    free_sampler(LD);
+    return rc;
+  }
+
+  return TRUE;
+}
+
+
+/** '$prof_sample_stop'
+ *
+ * Stop the sampling timer of the calling thread.  Samples are kept.
+ */
+
+static
+PRED_IMPL("$prof_sample_stop", 0, prof_sample_stop, 0)
+{ PRED_LD
+  prof_sampler *s;
+
+  if ( (s=LD->profile.sampler) && s->running )
+  { timer_delete(s->timer);
+    s->running = FALSE;
+    ATOMIC_DEC(&GD->profile.samplers);
+  }
+
+  return TRUE;
+}
+
+
+/** '$prof_samples'(-Samples, -Statistics)
+ *
+ * Remove the samples from the ring buffer of the calling thread.
+ * Samples is a list of stacks, where each stack is a list of
+ * qualified predicate indicators, leaf first. Statistics is a term
+ * samples(Taken, Dropped).
+ */
+
+static
+PRED_IMPL("$prof_samples", 2, prof_samples, 0)
+{ PRED_LD
+  prof_sampler *s = LD->profile.sampler;
+  term_t tail  = PL_copy_term_ref(A1);
+  term_t head  = PL_new_term_ref();
+  term_t stail = PL_new_term_ref();
+  term_t shead = PL_new_term_ref();
+  size_t h, t;
+
+  if ( !s )
+    return ( PL_unify_nil(A1) &&
+	     PL_unify_term(A2, PL_FUNCTOR_CHARS, "samples", 2,
+			         PL_INT, 0, PL_INT, 0) );
+
+  h = s->head;
+  MEMORY_ACQUIRE();
+  for(t = s->tail; t != h; )
+  { size_t n = s->ring[t&s->mask];
+    size_t i;
+
+    if ( !PL_unify_list(tail, head, tail) )
+      return FALSE;
+    PL_put_term(stail, head);
+    for(i=1; i<=n; i++)
+    { uintptr_t f = s->ring[(t+i)&s->mask];
+
+      if ( !PL_unify_list(stail, shead, stail) )
+	return FALSE;
+      if ( f == SAMPLE_GC )
+      { if ( !PL_unify_atom(shead, ATOM_dgarbage_collect) )
+	  return FALSE;
+      } else if ( !unify_definition(MODULE_user, shead, (Definition)f, 0,
+				    GP_QUALIFY|GP_NAMEARITY) )
+	return FALSE;
+    }
+    if ( !PL_unify_nil(stail) )
+      return FALSE;
+    t += n+1;
+  }
+  MEMORY_RELEASE();
+  s->tail = t;
+
+  return ( PL_unify_nil(tail) &&
+	   PL_unify_term(A2, PL_FUNCTOR_CHARS, "samples", 2,
+			       PL_INT64, (int64_t)s->samples,
+			       PL_INT64, (int64_t)s->dropped) );
+}
+
+#else /*O_PROF_SAMPLER*/
+
+static
+PRED_IMPL("$prof_sample_start", 4, prof_sample_start, 0)
+{ return PL_error(NULL, 0, NULL, ERR_NOT_IMPLEMENTED, "sampling profiler");
+}
+
+static
+PRED_IMPL("$prof_sample_stop", 0, prof_sample_stop, 0)
+{ return TRUE;
+}
+
+static
+PRED_IMPL("$prof_samples", 2, prof_samples, 0)
+{ return ( PL_unify_nil(A1) &&
+	   PL_unify_term(A2, PL_FUNCTOR_CHARS, "samples", 2,
+			       PL_INT, 0, PL_INT, 0) );
+}
+
+#define free_sampler(ld) (void)0
+
+#endif /*O_PROF_SAMPLER*/
+
+		 /*******************************
+		 *     ALLOCATION PROFILER	*
+		 *******************************/
+
+/* - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+The allocation profiler samples, for the  calling thread, either the
+growth of the global stack or the  memory allocated using allocHeap().
+Each time `period` bytes have been allocated,  the stack of predicates
+is recorded, leaf first, in a ring buffer that has the same layout as
+the one of the sampling profiler, except that a sample starts with three
+words: the number of frames, the state and the weight.  The weight is
+the number of periods that elapsed since the previous sample, so large
+allocations are not under-represented.
+
+There is no central allocator for the  global stack: the VM allocates
+inline.  We therefore check the growth  of   the  global stack in two
+places: allocGlobal() and  the  call  port   of  the  VM.  The latter is
+reached through the alerted path (ALERT_ALLOCPROF).  The memory was
+allocated by the clause that makes the call, while unifying its head or
+building the arguments.  We record the stack  of  the new frame because
+after last call optimization the frame  of   that  clause  is reused and
+only the new frame shows where we are.  If the global stack shrank since
+the previous check due to backtracking  or   GC,  we  simply  restart
+counting at the new top.
+
+For the global stack the state holds the  offset of the sampled cell. At
+the end of the GC mark phase we   check  whether the sampled cells that
+were not yet checked are marked, which   provides  the survival rate of
+allocation sites for tuning.  A cell that  was reclaimed by backtracking
+and reused before the GC may be  reported as surviving.  Heap samples are
+attributed to the thread that calls allocHeap().
+- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
+#define ALLOC_PENDING	0		/* global sample, not yet checked */
+#define ALLOC_SURVIVED	1		/* survived its first GC */
+#define ALLOC_RECLAIMED	2		/* collected by its first GC */
+#define ALLOC_HEAP	3		/* heap sample */
+#define ALLOC_STATE_BITS 2
+#define ALLOC_STATE_MASK ((1<<ALLOC_STATE_BITS)-1)
+
+typedef struct alloc_sampler
+{ int		running;		/* sampling is active */
+  int		heap;			/* sample allocHeap() rather than */
+					/* the global stack */
+  unsigned int	depth;			/* max frames per sample */
+  size_t	period;			/* bytes between samples */
+  intptr_t	left;			/* bytes until the next sample */
+  size_t	used;			/* global stack usage at last check */
+  size_t	mask;			/* size-1 of ring (power of 2) */
+  size_t	head;			/* next free */
+  size_t	tail;			/* first unread */
+  size_t	checked;		/* first not checked by GC */
+  uintptr_t	samples;		/* # samples taken */
+  uintptr_t	dropped;		/* # samples dropped (ring full) */
+  uintptr_t	ring[1];		/* sample records */
+} alloc_sampler;
+
+#define alloc_sample(s, fr, state, weight) \
+	LDFUNC(alloc_sample, s, fr, state, weight)
+
+static void
+alloc_sample(DECL_LD alloc_sampler *s, LocalFrame fr,
+	     uintptr_t state, uintptr_t weight)
+{ size_t head = s->head;
+  size_t n = 0;
+
+  if ( s->mask+1 - (head-s->tail) < s->depth+3 )
+  { s->dropped++;
+    return;
+  }
+
+  if ( gc_status.active
+#ifdef O_PLMT
+       || LD->gc.active
+#endif
+     )
+  { s->ring[(head+3)&s->mask] = SAMPLE_GC;
+    n = 1;
+  } else
+  { while( fr && n < s->depth && onStackArea(local, fr) && fr->predicate )
+    { LocalFrame parent;
+
+      s->ring[(head+3+n)&s->mask] = (uintptr_t)fr->predicate;
+      n++;
+      parent = parentFrame(fr);
+      if ( parent >= fr )
+	break;
+      fr = parent;
+    }
+  }
+
+  if ( n > 0 )
+  { s->ring[head&s->mask]     = n;
+    s->ring[(head+1)&s->mask] = state;
+    s->ring[(head+2)&s->mask] = weight;
+    s->samples++;
+    s->head = head+n+3;
+  }
+}
+
+
+static uintptr_t
+alloc_weight(alloc_sampler *s, size_t bytes)
+{ uintptr_t weight = 0;
+
+  s->left -= bytes;
+  while ( s->left <= 0 )
+  { s->left += s->period;
+    weight++;
+  }
+
+  return weight;
+}
+
+
+/* allocProfileGlobal() is called from allocGlobal() with the first
+ * allocated cell and from the call port of the VM with p == NULL.
+ */
+
+void
+allocProfileGlobal(DECL_LD LocalFrame fr, Word p)
+{ alloc_sampler *s = LD->profile.alloc;
+  size_t used = (char*)gTop - (char*)gBase;
+
+  if ( !s || !s->running || s->heap )
+    return;
+
+  if ( used > s->used )
+  { uintptr_t weight = alloc_weight(s, used - s->used);
+
+    if ( weight )
+    { size_t offset = (p ? p : gTop-1) - gBase;
+
+      alloc_sample(s, fr, offset<<ALLOC_STATE_BITS|ALLOC_PENDING, weight);
+    }
+  }
+  s->used = used;
+}
+
+
+void
+allocProfileHeap(size_t bytes)
+{ GET_LD
+  alloc_sampler *s;
+
+  if ( HAS_LD && (s=LD->profile.alloc) && s->running && s->heap )
+  { uintptr_t weight = alloc_weight(s, bytes);
+
+    if ( weight )
+      alloc_sample(s, environment_frame, ALLOC_HEAP, weight);
+  }
+}
+
+
+/* Called by the garbage collector after the mark phase */
+
+void
+allocProfileMarked(DECL_LD)
+{ alloc_sampler *s = LD->profile.alloc;
+  size_t t, h = s->head;
+  size_t top = gTop - gBase;
+
+  t = s->checked;
+  if ( t - s->tail > h - s->tail )	/* consumed */
+    t = s->tail;
+  while ( t != h )
+  { size_t n = s->ring[t&s->mask];
+    uintptr_t *sp = &s->ring[(t+1)&s->mask];
+
+    if ( (*sp&ALLOC_STATE_MASK) == ALLOC_PENDING )
+    { size_t offset = *sp>>ALLOC_STATE_BITS;
+      int alive = ( offset < top && is_marked(gBase+offset) );
+
+      *sp = alive ? ALLOC_SURVIVED : ALLOC_RECLAIMED;
+    }
+    t += n+3;
+  }
+  s->checked = h;
+  s->used = (char*)gTop - (char*)gBase;
+}
+
+
+/* True if ld samples global stack allocations (see updateAlerted()) */
+
+bool
+allocProfiling(PL_local_data_t *ld)
+{ alloc_sampler *s = ld->profile.alloc;
+
+  return s && s->running && !s->heap;
+}
+
+
+static void
+free_alloc_sampler(PL_local_data_t *ld)
+{ alloc_sampler *s;
+
+  if ( (s=ld->profile.alloc) )
+  { if ( s->heap && s->running )
+      ATOMIC_DEC(&GD->profile.alloc_samplers);
+    ld->profile.alloc = NULL;
+    updateAlerted(ld);
+    free(s);
+  }
+}
+
+
+/** '$alloc_sample_start'(+Space, +Period, +Depth, +Size)
+ *
+ * Start sampling allocations on Space (`global` or `heap`) of the
+ * calling thread every Period bytes, recording at most Depth frames
+ * per sample in a ring buffer of Size words.  Previously collected
+ * samples are discarded.
+ */
+
+static
+PRED_IMPL("$alloc_sample_start", 4, alloc_sample_start, 0)
+{ PRED_LD
+  atom_t space;
+  size_t period, size, words;
+  int depth;
+  alloc_sampler *s;
+
+  if ( !PL_get_atom_ex(A1, &space) ||
+       !PL_get_size_ex(A2, &period) ||
+       !PL_get_integer_ex(A3, &depth) ||
+       !PL_get_size_ex(A4, &size) )
+    return FALSE;
+  if ( space != ATOM_global && space != ATOM_heap )
+    return PL_domain_error("memory_space", A1);
+  if ( period < 1 )
+    return PL_domain_error("not_less_than_one", A2);
+  if ( depth < 1 )
+    return PL_domain_error("not_less_than_one", A3);
+  for(words=64; words < size || words < 2*((size_t)depth+3); words *= 2)
+    ;
+
+  free_alloc_sampler(LD);
+  if ( !(s = malloc(offsetof(alloc_sampler, ring) + words*sizeof(uintptr_t))) )
+    return PL_no_memory();
+  memset(s, 0, offsetof(alloc_sampler, ring));
+  s->heap   = (space == ATOM_heap);
+  s->depth  = depth;
+  s->period = period;
+  s->left   = period;
+  s->used   = (char*)gTop - (char*)gBase;
+  s->mask   = words-1;
+  s->running = TRUE;
+
+  LD->profile.alloc = s;
+  if ( s->heap )
+    ATOMIC_INC(&GD->profile.alloc_samplers);
+  updateAlerted(LD);
+
+  return TRUE;
+}
+
+
+/** '$alloc_sample_stop'
+ *
+ * Stop sampling allocations of the calling thread.  Samples are kept.
+ */
+
+static
+PRED_IMPL("$alloc_sample_stop", 0, alloc_sample_stop, 0)
+{ PRED_LD
+  alloc_sampler *s;
+
+  if ( (s=LD->profile.alloc) && s->running )
+  { s->running = FALSE;
+    if ( s->heap )
+      ATOMIC_DEC(&GD->profile.alloc_samplers);
+    updateAlerted(LD);
+  }
+
+  return TRUE;
+}
+
+
+/** '$alloc_samples'(-Samples, -Statistics)
+ *
+ * Remove the samples from the buffer of the calling thread.  Samples
+ * is a list of sample(Weight, Survival, Stack), where Survival is one
+ * of `survived`, `reclaimed` or `unknown` and Stack is a list of
+ * qualified predicate indicators, leaf first.  Statistics is a term
+ * samples(Taken, Dropped).
+ */
+
+static
+PRED_IMPL("$alloc_samples", 2, alloc_samples, 0)
+{ PRED_LD
+  alloc_sampler *s = LD->profile.alloc;
+  term_t tail  = PL_copy_term_ref(A1);
+  term_t head  = PL_new_term_ref();
+  term_t stack = PL_new_term_ref();
+  term_t stail = PL_new_term_ref();
+  term_t shead = PL_new_term_ref();
+  size_t h, t;
+
+  if ( !s )
+    return ( PL_unify_nil(A1) &&
+	     PL_unify_term(A2, PL_FUNCTOR_CHARS, "samples", 2,
+			         PL_INT, 0, PL_INT, 0) );
+
+  h = s->head;
+  for(t = s->tail; t != h; )
+  { size_t n = s->ring[t&s->mask];
+    uintptr_t state = s->ring[(t+1)&s->mask] & ALLOC_STATE_MASK;
+    uintptr_t weight = s->ring[(t+2)&s->mask];
+    atom_t survival;
+    size_t i;
+
+    switch(state)
+    { case ALLOC_SURVIVED:  survival = ATOM_survived;  break;
+      case ALLOC_RECLAIMED: survival = ATOM_reclaimed; break;
+      default:		    survival = ATOM_unknown;   break;
+    }
+
+    PL_put_variable(stack);
+    PL_put_term(stail, stack);
+    for(i=3; i<n+3; i++)
+    { uintptr_t f = s->ring[(t+i)&s->mask];
+
+      if ( !PL_unify_list(stail, shead, stail) )
+	return FALSE;
+      if ( f == SAMPLE_GC )
+      { if ( !PL_unify_atom(shead, ATOM_dgarbage_collect) )
+	  return FALSE;
+      } else if ( !unify_definition(MODULE_user, shead, (Definition)f, 0,
+				    GP_QUALIFY|GP_NAMEARITY) )
+	return FALSE;
+    }
+    if ( !PL_unify_nil(stail) ||
+	 !PL_unify_list(tail, head, tail) ||
+	 !PL_unify_term(head, PL_FUNCTOR_CHARS, "sample", 3,
+			        PL_INT64, (int64_t)weight,
+			        PL_ATOM, survival,
+			        PL_TERM, stack) )
+      return FALSE;
+    t += n+3;
+  }
+  s->tail = t;
+
+  return ( PL_unify_nil(tail) &&
+	   PL_unify_term(A2, PL_FUNCTOR_CHARS, "samples", 2,
+			       PL_INT64, (int64_t)s->samples,
+			       PL_INT64, (int64_t)s->dropped) );
+}
+
+void
+freeProfileSampler(PL_local_data_t *ld)
+{ free_sampler(ld);
+  free_alloc_sampler(ld);
+}
+
 #endif /* O_PROFILE */
 
 		 /*******************************
@@ -1358,5 +2026,11 @@ BeginPredDefs(profile)
   PRED_DEF("$prof_sibling_of", 2, prof_sibling_of, PL_FA_NONDETERMINISTIC)
   PRED_DEF("$prof_procedure_data", 8, prof_procedure_data, PL_FA_TRANSPARENT)
   PRED_DEF("$prof_statistics", 5, prof_statistics, 0)
+  PRED_DEF("$prof_sample_start", 4, prof_sample_start, 0)
+  PRED_DEF("$prof_sample_stop", 0, prof_sample_stop, 0)
+  PRED_DEF("$prof_samples", 2, prof_samples, 0)
+  PRED_DEF("$alloc_sample_start", 4, alloc_sample_start, 0)
+  PRED_DEF("$alloc_sample_stop", 0, alloc_sample_stop, 0)
+  PRED_DEF("$alloc_samples", 2, alloc_samples, 0)
 #endif
 EndPredDefs
@@ -48,6 +48,8 @@ typedef enum
 #define	profResumeParent(node)		LDFUNC(profResumeParent, node)
 #define	profExit(node)			LDFUNC(profExit, node)
 #define	profFail(node)			LDFUNC(profRedo, node)
+#define	allocProfileGlobal(fr, p)	LDFUNC(allocProfileGlobal, fr, p)
+#define	allocProfileMarked(_)		LDFUNC(allocProfileMarked, _)
 #endif /*USE_LD_MACROS*/
 
 #define LDFUNC_DECLARATIONS
@@ -60,7 +62,23 @@ void		profResumeParent(struct call_node *node);
 void		profExit(struct call_node *node);
 void		profFail(struct call_node *node);
 void		profSetHandle(struct call_node *node, void *handle);
+void		freeProfileSampler(PL_local_data_t *ld);
+void		allocProfileGlobal(LocalFrame fr, Word p);
+void		allocProfileHeap(size_t bytes);
+void		allocProfileMarked(void);
+bool		allocProfiling(PL_local_data_t *ld);
 
 #undef LDFUNC_DECLARATIONS
 
+/* Check growth of the global stack at the call port (alerted path) */
+
+static inline void
+AllocProfileCall(LocalFrame fr)
+{
+#ifdef O_PROFILE
+  if ( unlikely(LD->profile.alloc != NULL) )
+    allocProfileGlobal(fr, NULL);
+#endif
+}
+
 #endif /*PL_PROF_H_INCLUDED*/
@@ -42,6 +42,7 @@
 #include "os/pl-ctype.h"
 #include "os/pl-utf8.h"
 #include "os/pl-dtoa.h"
+#include "os/pl-fltconv.h"
 #include "os/pl-prologflag.h"
 #include "pl-umap.c"			/* Unicode map */
 #include "pl-dict.h"
@@ -2154,6 +2155,65 @@ skip_decimal_separator(cucharp *sp, int zero, int *grouped)
 }
 
 
+#ifdef O_BIGNUM
+/* - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+scan_mpz() reads an integer that does not  fit in 64 bits. It re-scans
+the digits from *sp, collecting them  without digit separators, and
+converts them in one call to mpz_set_digits()  rather than digit by
+digit, which is quadratic in the number of digits.  If `zero` is
+non-zero we read (Unicode) decimal digits, else ASCII digits in `base`.
+- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
+static strnumstat
+scan_mpz(cucharp *sp, int zero, int base, int negative, Number n,
+	 int *grouped)
+{ static const char digits[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+  tmp_buffer b;
+  cucharp s = *sp;
+  int rc;
+
+  initBuffer(&b);
+  if ( zero )
+  { cucharp sn;
+    int c;
+
+    do
+    { for(sn = utf8_get_uchar(s, &c); isDecimal(zero, c); sn = utf8_get_uchar(s, &c))
+      { s = sn;
+	addBuffer(&b, digits[c-zero], char);
+      }
+    } while ( skip_decimal_separator(&s, zero, grouped) );
+  } else
+  { int d;
+
+    do
+    { while((d = digitValue(base, *s)) >= 0)
+      { s++;
+	addBuffer(&b, digits[d], char);
+      }
+    } while ( skip_digit_separator(&s, base, NULL) );
+  }
+
+  addBuffer(&b, EOS, char);
+
+  n->value.i = 0;
+  n->type = V_INTEGER;
+  promoteToMPZNumber(n);
+  rc = mpz_set_digits(n->value.mpz, baseBuffer(&b, char), base);
+  discardBuffer(&b);
+  if ( !rc )
+  { clearNumber(n);
+    return NUM_ERROR;
+  }
+  if ( negative )
+    mpz_neg(n->value.mpz, n->value.mpz);
+  *sp = s;
+
+  return NUM_OK;
+}
+#endif
+
+
 static strnumstat
 scan_decimal(cucharp *sp, int zero, int negative, Number n, int *grouped)
 { int64_t maxi = PLMAXINT/10;
@@ -2176,24 +2236,7 @@ scan_decimal(cucharp *sp, int zero, int negative, Number n, int *grouped)
 	   || ( !negative && ( (t > maxi) || (t == maxi && c - zero > maxlastdigit) )) )
       {
 #ifdef O_BIGNUM
-	n->value.i = t;
-	n->type = V_INTEGER;
-	promoteToMPZNumber(n);
-
-	do
-	{ for(sn = utf8_get_uchar(s, &c); isDecimal(zero, c); sn = utf8_get_uchar(s, &c))
-	  { s = sn;
-	    mpz_mul_ui(n->value.mpz, n->value.mpz, 10);
-	    if (negative)
-	      mpz_sub_ui(n->value.mpz, n->value.mpz, c - zero);
-	    else
-	      mpz_add_ui(n->value.mpz, n->value.mpz, c - zero);
-	  }
-	} while ( skip_decimal_separator(&s, zero, grouped) );
-
-	*sp = s;
-
-	return NUM_OK;
+	return scan_mpz(sp, zero, 10, negative, n, grouped);
 #else
 	double maxf =  MAXREAL / 10.0 - 10.0;
 	double minf = -MAXREAL / 10.0 + 10.0;
@@ -2255,24 +2298,7 @@ scan_number(cucharp *s, int negative, int b, Number n)
 	   || ( !negative && ( (t > maxi) || (t == maxi && d > maxlastdigit) )) )
       {
 #ifdef O_BIGNUM
-	n->value.i = t;
-	n->type = V_INTEGER;
-	promoteToMPZNumber(n);
-
-	do
-	{ while((d = digitValue(b, *q)) >= 0)
-	  { q++;
-	    mpz_mul_ui(n->value.mpz, n->value.mpz, b);
-	    if (negative)
-	      mpz_sub_ui(n->value.mpz, n->value.mpz, d);
-	    else
-	      mpz_add_ui(n->value.mpz, n->value.mpz, d);
-	  }
-	} while ( skip_digit_separator(&q, b, NULL) );
-
-	*s = q;
-
-	return NUM_OK;
+	return scan_mpz(s, 0, b, negative, n, NULL);
 #else
 
 	double maxf =  MAXREAL / (double) b - (double) b;
@@ -2696,6 +2722,9 @@ ascii_to_double(cucharp s, cucharp e, double *dp)
 { char *es;
   double d;
 
+  if ( fast_strtod((const char*)s, (const char*)e, dp) )
+    return NUM_OK;
+
   errno = 0;
   d = strtod((char*)s, &es);
   if ( (cucharp)es == e || (e[0] == '.' && e+1 == (cucharp)es) )
@@ -44,6 +44,7 @@
 #include "os/pl-cstack.h"
 #include "os/pl-ctype.h"
 #include "os/pl-prologflag.h"
+#include "os/pl-fmt.h"
 #include "pl-dbref.h"
 #include "pl-trie.h"
 #include "pl-tabling.h"
@@ -51,6 +52,7 @@
 #include "pl-event.h"
 #include "pl-fli.h"
 #include "pl-funct.h"
+#include "pl-atom.h"
 #include "pl-modul.h"
 #include "pl-rec.h"
 #include "pl-flag.h"
@@ -64,6 +66,8 @@
 #include "pl-pro.h"
 #include "pl-gvar.h"
 #include "pl-coverage.h"
+#include "pl-prof.h"
+#include "pl-counters.h"
 #include <sys/stat.h>
 #ifdef HAVE_UNISTD_H
 #include <unistd.h>
@@ -620,8 +624,14 @@ pl_signal_handler(int sig)
 #define SA_RESTART 0
 #endif
 
+/* set_sighandler_flags() is set_sighandler(), passing sa_flags to
+   sigaction().  Use SA_RESTART for high frequency signals such as the
+   sampling profiler, so blocking system calls are restarted rather than
+   failing with EINTR.  The flags are ignored if there is no sigaction().
+*/
+
 handler_t
-set_sighandler(int sig, handler_t func)
+set_sighandler_flags(int sig, handler_t func, int flags)
 {
 #ifdef HAVE_SIGACTION
   struct sigaction old;
@@ -629,7 +639,7 @@ set_sighandler(int sig, handler_t func)
 
   memset(&new, 0, sizeof(new));	/* deal with other fields */
   new.sa_handler = func;
-/*new.sa_flags   = SA_RESTART;  all blocking functions are restarted */
+  new.sa_flags   = flags;
 
   if ( sigaction(sig, &new, &old) == 0 )
     return old.sa_handler;
@@ -649,12 +659,18 @@ set_sighandler(int sig, handler_t func)
       return SIG_IGN;
   }
 #endif /*__WINDOWS__*/
+  (void)flags;
   return signal(sig, func);
 #else
   return NULL;
 #endif
 }
 
+handler_t
+set_sighandler(int sig, handler_t func)
+{ return set_sighandler_flags(sig, func, 0);
+}
+
 static SigHandler
 prepareSignal(int sig, int plsig_flags)
 { SigHandler sh = &GD->signals.handlers[SIGNAL_INDEX(sig)];
@@ -838,6 +854,13 @@ gc_tune_handler(int sig)
   call_tune_gc_hook();
 }
 
+static void
+gc_event_handler(int sig)
+{ (void)sig;
+
+  send_gc_events();
+}
+
 static void
 cgc_handler(int sig)
 { (void)sig;
@@ -916,6 +939,7 @@ initSignals(DECL_LD)
 
   PL_signal(SIG_GC|PL_SIGSYNC,		  gc_handler);
   PL_signal(SIG_TUNE_GC|PL_SIGSYNC,	  gc_tune_handler);
+  PL_signal(SIG_GC_EVENT|PL_SIGSYNC,	  gc_event_handler);
   PL_signal(SIG_CLAUSE_GC|PL_SIGSYNC,     cgc_handler);
   PL_signal(SIG_PLABORT|PL_SIGSYNC,       abort_handler);
 #ifdef SIG_THREAD_SIGNAL
@@ -1787,6 +1811,11 @@ freePrologLocalData(PL_local_data_t *ld)
 #endif
 
   free_undo_data(ld);
+  freeFormatCache(ld);
+#ifdef O_PROFILE
+  freeProfileSampler(ld);
+#endif
+  freeCountersLocalData(ld);
 
   if ( ld->btrace_store )
   { btrace_destroy(ld->btrace_store);
@@ -1795,6 +1824,7 @@ freePrologLocalData(PL_local_data_t *ld)
 
   cleanAbortHooks(ld);
   unreferenceStandardStreams(ld);
+  freeAtomCache(ld);
 }
 
 /* The following definitions aren't necessary for compiling, and in fact
@@ -60,6 +60,7 @@ void		startCritical(void);
 int		endCritical(void);
 void		dispatch_signal(int sig, int sync);
 handler_t	set_sighandler(int sig, handler_t func);
+handler_t	set_sighandler_flags(int sig, handler_t func, int flags);
 void		blockSignals(sigset_t *mask);
 void		allSignalMask(sigset_t *set);
 void		unblockSignals(sigset_t *mask);
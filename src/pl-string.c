@@ -268,7 +268,8 @@ PRED_IMPL("string_code", 3, string_code, PL_FA_NONDETERMINISTIC)
   { case FRG_FIRST_CALL:
     { size_t i;
 
-      if ( !PL_get_text(A2, &t, CVT_ATOM|CVT_STRING|CVT_LIST|CVT_EXCEPTION) )
+      if ( !PL_get_text(A2, &t, CVT_ATOM|CVT_STRING|CVT_LIST|
+				CVT_EXCEPTION|BUF_ALLOW_STACK) )
 	return FALSE;
       if ( !PL_is_variable(A1) )
       { if ( !PL_get_size_ex(A1, &i) )
@@ -292,7 +293,7 @@ PRED_IMPL("string_code", 3, string_code, PL_FA_NONDETERMINISTIC)
     case FRG_REDO:
     { idx = (size_t)CTX_INT;
 
-      PL_get_text(A2, &t, CVT_ALL);
+      PL_get_text(A2, &t, CVT_ALL|BUF_ALLOW_STACK);
       if ( PL_is_variable(A3) )
 	tchar = -1;
       else
@@ -300,8 +301,10 @@ PRED_IMPL("string_code", 3, string_code, PL_FA_NONDETERMINISTIC)
 
     gen:
       if ( tchar == -1 )
-      { if ( PL_unify_integer(A1, idx+1) &&
-	     PL_unify_integer(A3, text_get_char(&t, idx)) )
+      { int c = text_get_char(&t, idx);
+
+	if ( PL_unify_integer(A1, idx+1) &&
+	     PL_unify_integer(A3, c) )
 	{ if ( idx+1 < t.length )
 	    ForeignRedoInt(idx+1);
 	  else
@@ -312,7 +315,8 @@ PRED_IMPL("string_code", 3, string_code, PL_FA_NONDETERMINISTIC)
 
       for(; idx < t.length; idx++)
       { if ( text_get_char(&t, idx) == tchar )
-	{ if ( PL_unify_integer(A1, idx+1) )
+	{ if ( PL_unify_integer(A1, idx+1) &&
+	       PL_refresh_text(A2, &t) )
 	  { for(idx++; idx < t.length; idx++)
 	    { if ( text_get_char(&t, idx) == tchar )
 		ForeignRedoInt(idx);
@@ -361,6 +365,10 @@ PRED_IMPL("get_string_code", 3, get_string_code, 0)
 
 
 /** split_string(+String, +SepChars, +PadChars, -SubStrings) is det.
+
+If String is a string, we do not copy it but access it on the global
+stack. As creating the result may move it, we must use PL_refresh_text()
+after creating new terms.
 */
 
 static
@@ -374,7 +382,7 @@ PRED_IMPL("split_string", 4, split_string, 0)
     sep.storage = PL_CHARS_VIRGIN;
     pad.storage = PL_CHARS_VIRGIN;
 
-  if ( PL_get_text(A1, &input, flags) &&
+  if ( PL_get_text(A1, &input, flags|BUF_ALLOW_STACK) &&
        PL_get_text(A2, &sep,   flags) &&
        PL_get_text(A3, &pad,   flags) )
   { size_t i, last;
@@ -414,7 +422,9 @@ PRED_IMPL("split_string", 4, split_string, 0)
 	i--;
 
       if ( !PL_unify_list_ex(tail, head, tail) ||
-	   !PL_unify_text_range(head, &input, last, i-last, PL_STRING) )
+	   !PL_refresh_text(A1, &input) ||
+	   !PL_unify_text_range(head, &input, last, i-last, PL_STRING) ||
+	   !PL_refresh_text(A1, &input) )
 	goto error;
 
       if ( sep_at == end )
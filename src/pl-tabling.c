@@ -2596,7 +2596,7 @@ indexOfWord(DECL_LD word w)
 	size_t n = wsizeofInd(*p);
 	word k;
 
-	k = MurmurHashAligned2(p+1, n*sizeof(*p), MURMUR_SEED);
+	k = WyHash64(p+1, n*sizeof(*p), WYHASH_SEED);
 	k &= ~((word)STG_GLOBAL);	/* avoid confusion with functor_t */
 	if ( !k ) k = 1;		/* avoid no-key */
 	return k;
@@ -7210,8 +7210,8 @@ static unsigned int
 mdep_hash(DECL_LD term_t dep)
 { termhash_t hash;
 
-  if ( variant_hash(dep, &hash, HASH_MURMUR) )
-    return hash.murmur;
+  if ( variant_hash(dep, &hash, HASH_WYHASH) )
+    return hash.wyhash;
 
   assert(0);
   return FALSE;
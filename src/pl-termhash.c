@@ -37,6 +37,7 @@
 /*#define O_DEBUG 1*/
 #include "pl-incl.h"
 #include "pl-termhash.h"
+#include "pl-atom.h"
 #include "pl-fli.h"
 #include "os/pl-text.h"
 #include "pl-arith.h"
@@ -93,8 +94,9 @@ primitiveHashValue(DECL_LD word term, unsigned int *hval)
     case TAG_ATTVAR:
       return FALSE;
     case TAG_ATOM:
-    { *hval = MurmurHashAligned2(&atomValue(term)->hash_value,
-				 sizeof(unsigned int), *hval);
+    { unsigned int ah = atom_term_hash(atomValue(term));
+
+      *hval = MurmurHashAligned2(&ah, sizeof(ah), *hval);
       return TRUE;
     }
     case TAG_STRING:
@@ -143,6 +145,7 @@ primitiveHashValue(DECL_LD word term, unsigned int *hval)
 static void
 start_term(DECL_LD th_data *work, Buffer b, word w)
 { atom_t name;
+  unsigned int ah;
 
   work->term     = valueTerm(w);
   work->functor  = work->term->definition;
@@ -151,8 +154,8 @@ start_term(DECL_LD th_data *work, Buffer b, word w)
   work->in_cycle = 0;
 
   name = nameFunctor(work->functor);
-  work->hash = MurmurHashAligned2(&atomValue(name)->hash_value,
-				  sizeof(unsigned int), work->hash);
+  ah = atom_term_hash(atomValue(name));
+  work->hash = MurmurHashAligned2(&ah, sizeof(ah), work->hash);
 
   DEBUG(1, Sdprintf("Added node %ld, %s/%d, hash=%d\n",
 		    nodeID(work, b),
@@ -366,13 +369,18 @@ VOID_RETURN sha1_end(unsigned char hval[], sha1_ctx ctx[1]);
 
 
 		 /*******************************
-		 *    INCREMENTAL MURMUR HASH	*
+		 *	 INCREMENTAL WYHASH	*
 		 *******************************/
 
+/* - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Used by variant_hash/2. This hash is  not   promised  to be stable over
+versions and thus uses WyHash64() rather than MurmurHashAligned2().
+- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
 #define HASH_BLOCK_SIZE 256
 
 typedef struct hash_state
-{ unsigned int	  hash;
+{ uint64_t	  hash;
   size_t	  len;
   unsigned char	  buf[HASH_BLOCK_SIZE];
 } hash_state;
@@ -380,7 +388,7 @@ typedef struct hash_state
 static void
 hash_init(hash_state *state)
 { state->len  = 0;
-  state->hash = MURMUR_SEED;
+  state->hash = WYHASH_SEED;
 }
 
 static void
@@ -397,8 +405,7 @@ hash_compile(hash_state *state, const unsigned char *data, size_t len)
       memcpy(&state->buf[state->len], data, copy);
       state->len += copy;
       if ( state->len == HASH_BLOCK_SIZE )
-      { state->hash = MurmurHashAligned2(state->buf, HASH_BLOCK_SIZE,
-					 state->hash);
+      { state->hash = WyHash64(state->buf, HASH_BLOCK_SIZE, state->hash);
 	state->len = 0;
       }
     }
@@ -407,7 +414,7 @@ hash_compile(hash_state *state, const unsigned char *data, size_t len)
 
 static unsigned int
 hash_end(hash_state *state)
-{ return MurmurHashAligned2(state->buf, state->len, state->hash);
+{ return WyHash32(state->buf, state->len, state->hash);
 }
 
 /* - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -419,7 +426,7 @@ typedef struct
   hash_algo	algorithm;
   union
   { sha1_ctx	sha1[1];			/* The SHA1 Context */
-    hash_state	murmur[1];
+    hash_state	wyhash[1];
   } ctx;
   segstack	vars;
   Word		vars_first_chunk[64];
@@ -450,9 +457,32 @@ push_attvar(Word p, sha1_state *state)
 	{ if (state->algorithm == HASH_SHA1) \
 	    sha1_hash((const unsigned char*)(p), (l), state->ctx.sha1); \
 	  else \
-	    hash_compile(state->ctx.murmur, (const unsigned char*)(p), (l)); \
+	    hash_compile(state->ctx.wyhash, (const unsigned char*)(p), (l)); \
 	} while(0)
 
+static void
+hash_atom(sha1_state *state, word w)
+{ Atom av = atomValue(w);
+
+  HASH("A", 1);
+  HASH(&av->length, sizeof(av->length));
+  HASH(av->name, (unsigned long)av->length);
+  HASH(av->type->name, (unsigned long)strlen(av->type->name));
+					/* TBD: Include type */
+}
+
+static void
+hash_functor(sha1_state *state, functor_t f)
+{ FunctorDef fd = valueFunctor(f);
+  int arity = arityFunctor(f);
+  Atom fn = atomValue(fd->name);
+
+  HASH("T", 1);
+  HASH(&fn->length, sizeof(fn->length));
+  HASH(fn->name, (unsigned long)fn->length);
+  HASH(&arity, sizeof(arity));
+}
+
 #define variant_sha1(agenda, state) LDFUNC(variant_sha1, agenda, state)
 static status
 variant_sha1(DECL_LD ac_term_agenda *agenda, sha1_state *state)
@@ -493,13 +523,7 @@ variant_sha1(DECL_LD ac_term_agenda *agenda, sha1_state *state)
 	continue;
       }
       case TAG_ATOM:
-      { Atom av = atomValue(w);
-	HASH("A", 1);
-	HASH(&av->length, sizeof(av->length));
-	HASH(av->name, (unsigned long)av->length);
-	HASH(av->type->name, (unsigned long)strlen(av->type->name));
-
-					/* TBD: Include type */
+      { hash_atom(state, w);
 	continue;
       }
       case TAG_INTEGER:
@@ -536,16 +560,7 @@ variant_sha1(DECL_LD ac_term_agenda *agenda, sha1_state *state)
 	  case FALSE:			/* Cycle */
 	    return E_CYCLE;
 	  default:
-	  { FunctorDef fd = valueFunctor(f);
-	    int arity = arityFunctor(f);
-
-	    Atom fn = atomValue(fd->name);
-
-	    HASH("T", 1);
-	    HASH(&fn->length, sizeof(fn->length));
-	    HASH(fn->name, (unsigned long)fn->length);
-	    HASH(&arity, sizeof(arity));
-	  }
+	    hash_functor(state, f);
 	}
 	continue;
       }
@@ -556,28 +571,27 @@ variant_sha1(DECL_LD ac_term_agenda *agenda, sha1_state *state)
 }
 
 
-int
-variant_hash(DECL_LD term_t term, termhash_t *hash, hash_algo algorithm)
+/* - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Add term to the hash  state.  Variables   are  numbered  continuing from
+state->var_count. Returns FALSE with an exception on failure.
+- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
+#define hash_term(term, state) LDFUNC(hash_term, term, state)
+static int
+hash_term(DECL_LD term_t term, sha1_state *state)
 { int rc;
   ac_term_agenda agenda;
-  sha1_state state;
   Word p;
 
-  state.var_count = 0;
-  state.algorithm = algorithm;
-  if ( algorithm == HASH_SHA1 )
-    sha1_begin(state.ctx.sha1);
-  else
-    hash_init(state.ctx.murmur);
   ac_initTermAgenda(&agenda, valTermRef(term));
-  initSegStack(&state.vars, sizeof(Word),
-	       sizeof(state.vars_first_chunk), state.vars_first_chunk);
-  rc = variant_sha1(&agenda, &state);
+  initSegStack(&state->vars, sizeof(Word),
+	       sizeof(state->vars_first_chunk), state->vars_first_chunk);
+  rc = variant_sha1(&agenda, state);
   ac_clearTermAgenda(&agenda);
-  while(popSegStack(&state.vars, &p, Word))
+  while(popSegStack(&state->vars, &p, Word))
   { word w = (word)p;
     if ( unlikely(isAttVar(w)) )
-    { popSegStack(&state.vars, &p, Word);
+    { popSegStack(&state->vars, &p, Word);
       *p = w;
     } else
     { setVar(*p);
@@ -598,10 +612,27 @@ variant_hash(DECL_LD term_t term, termhash_t *hash, hash_algo algorithm)
 		      ERR_RESOURCE, ATOM_memory);
   }
 
+  return TRUE;
+}
+
+
+int
+variant_hash(DECL_LD term_t term, termhash_t *hash, hash_algo algorithm)
+{ sha1_state state;
+
+  state.var_count = 0;
+  state.algorithm = algorithm;
+  if ( algorithm == HASH_SHA1 )
+    sha1_begin(state.ctx.sha1);
+  else
+    hash_init(state.ctx.wyhash);
+  if ( !hash_term(term, &state) )
+    return FALSE;
+
   if ( state.algorithm == HASH_SHA1 )
     sha1_end(hash->sha1, state.ctx.sha1);
   else
-    hash->murmur = hash_end(state.ctx.murmur);
+    hash->wyhash = hash_end(state.ctx.wyhash);
 
   return TRUE;
 }
@@ -613,29 +644,33 @@ have the same hash iff variant(T1,T2) is true. This implies that we must
 basically execute numbervars.
 */
 
+static int
+unify_sha1(term_t t, const unsigned char *sha1)
+{ char hex[SHA1_DIGEST_SIZE*2];
+  const char hexd[] = "0123456789abcdef";
+  char *o;
+  const unsigned char *i;
+  int n;
+
+  o = hex;
+  i = sha1;
+  for(n=0; n<SHA1_DIGEST_SIZE; n++,i++)
+  { *o++ = hexd[*i >> 4];
+    *o++ = hexd[*i&0x0f];
+  }
+
+  return PL_unify_chars(t, PL_ATOM|REP_ISO_LATIN_1, sizeof(hex), hex);
+}
+
 static
 PRED_IMPL("variant_sha1", 2, variant_sha1, 0)
 { PRED_LD
   termhash_t hash;
 
   if ( variant_hash(A1, &hash, HASH_SHA1) )
-  { char hex[SHA1_DIGEST_SIZE*2];
-    const char hexd[] = "0123456789abcdef";
-    char *o;
-    const unsigned char *i;
-    int n;
-
-    o = hex;
-    i = hash.sha1;
-    for(n=0; n<SHA1_DIGEST_SIZE; n++,i++)
-    { *o++ = hexd[*i >> 4];
-      *o++ = hexd[*i&0x0f];
-    }
-
-    return PL_unify_chars(A2, PL_ATOM|REP_ISO_LATIN_1, sizeof(hex), hex);
-  } else
-  { return FALSE;
-  }
+    return unify_sha1(A2, hash.sha1);
+  else
+    return FALSE;
 }
 
 static
@@ -643,19 +678,151 @@ PRED_IMPL("variant_hash", 2, variant_hash, 0)
 { PRED_LD
   termhash_t hash;
 
-  if ( variant_hash(A1, &hash, HASH_MURMUR) )
-  { return PL_unify_integer(A2, hash.murmur&PLMAXTAGGEDINT32);
+  if ( variant_hash(A1, &hash, HASH_WYHASH) )
+  { return PL_unify_integer(A2, hash.wyhash&PLMAXTAGGEDINT32);
   } else
   { return FALSE;
   }
 }
 
+		 /*******************************
+		 *	STREAMING VARIANT SHA1	*
+		 *******************************/
+
+/* - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+A variant_sha1 context allows hashing a   list  that is produced as a
+sequence of parts without materializing the  list. Adding a part hashes
+the list cell '[|]'(Part, _) and   variant_sha1_hash/2  completes a copy
+of the context by hashing the  terminating   [].  The result is thus the
+same as variant_sha1/2 on the  list  of   parts  added  sofar, provided
+the parts do not share variables: variable numbering continues over the
+parts, but a variable that appears in multiple parts is numbered as two
+distinct variables.
+
+The context is a blob that   is  updated destructively. Contexts are not
+thread-safe.
+- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
+typedef struct sha1_stream
+{ sha1_ctx	ctx[1];			/* Context after the last part */
+  int		var_count;		/* Variables numbered sofar */
+} sha1_stream;
+
+typedef struct sha1_stream_ref
+{ sha1_stream  *stream;
+} sha1_stream_ref;
+
+static int
+write_sha1_stream(IOSTREAM *s, atom_t aref, int flags)
+{ sha1_stream_ref *ref = PL_blob_data(aref, NULL, NULL);
+  (void)flags;
+
+  Sfprintf(s, "<variant_sha1>(%p)", ref->stream);
+  return TRUE;
+}
+
+static int
+release_sha1_stream(atom_t aref)
+{ sha1_stream_ref *ref = PL_blob_data(aref, NULL, NULL);
+
+  free(ref->stream);
+  return TRUE;
+}
+
+static PL_blob_t sha1_stream_blob =
+{ PL_BLOB_MAGIC,
+  PL_BLOB_UNIQUE,
+  "variant_sha1",
+  release_sha1_stream,
+  NULL,
+  write_sha1_stream
+};
+
+static int
+get_sha1_stream(term_t t, sha1_stream **sp)
+{ void *data;
+  PL_blob_t *type;
+
+  if ( PL_get_blob(t, &data, NULL, &type) && type == &sha1_stream_blob )
+  { *sp = ((sha1_stream_ref*)data)->stream;
+    return TRUE;
+  }
+
+  return PL_type_error("variant_sha1", t);
+}
+
+/** variant_sha1_new(-Context) is det.
+ */
+
+static
+PRED_IMPL("variant_sha1_new", 1, variant_sha1_new, 0)
+{ sha1_stream_ref ref;
+
+  if ( !(ref.stream = malloc(sizeof(*ref.stream))) )
+    return PL_no_memory();
+  sha1_begin(ref.stream->ctx);
+  ref.stream->var_count = 0;
+
+  if ( PL_unify_blob(A1, &ref, sizeof(ref), &sha1_stream_blob) )
+    return TRUE;
+  free(ref.stream);
+  return FALSE;
+}
+
+/** variant_sha1_add(+Context, @Part) is det.
+ */
+
+static
+PRED_IMPL("variant_sha1_add", 2, variant_sha1_add, 0)
+{ PRED_LD
+  sha1_stream *s = NULL;
+  sha1_state state;
+
+  if ( !get_sha1_stream(A1, &s) )
+    return FALSE;
+
+  state.algorithm = HASH_SHA1;
+  state.var_count = s->var_count;
+  memcpy(state.ctx.sha1, s->ctx, sizeof(s->ctx));
+  hash_functor(&state, FUNCTOR_dot2);
+  if ( !hash_term(A2, &state) )
+    return FALSE;
+  memcpy(s->ctx, state.ctx.sha1, sizeof(s->ctx));
+  s->var_count = state.var_count;
+
+  return TRUE;
+}
+
+/** variant_sha1_hash(+Context, -SHA1) is det.
+ */
+
+static
+PRED_IMPL("variant_sha1_hash", 2, variant_sha1_hash, 0)
+{ sha1_stream *s = NULL;
+  sha1_state state;
+  unsigned char sha1[SHA1_DIGEST_SIZE];
+
+  if ( !get_sha1_stream(A1, &s) )
+    return FALSE;
+
+  state.algorithm = HASH_SHA1;
+  memcpy(state.ctx.sha1, s->ctx, sizeof(s->ctx));
+  hash_atom(&state, ATOM_nil);
+  sha1_end(sha1, state.ctx.sha1);
+
+  return unify_sha1(A2, sha1);
+}
+
+
 		 /*******************************
 		 *      PUBLISH PREDICATES	*
 		 *******************************/
 
 BeginPredDefs(termhash)
   PRED_DEF("variant_sha1", 2, variant_sha1, 0)
+  PRED_DEF("variant_sha1_new", 1, variant_sha1_new, 0)
+  PRED_DEF("variant_sha1_add", 2, variant_sha1_add, 0)
+  PRED_DEF("variant_sha1_hash", 2, variant_sha1_hash, 0)
   PRED_DEF("variant_hash", 2, variant_hash, 0)
   PRED_DEF("term_hash",    2, term_hash,    0)
 EndPredDefs
@@ -41,12 +41,12 @@
 
 typedef enum
 { HASH_SHA1,
-  HASH_MURMUR
+  HASH_WYHASH
 } hash_algo;
 
 typedef union
 { unsigned char sha1[SHA1_DIGEST_SIZE];
-  unsigned int  murmur;
+  unsigned int  wyhash;
 } termhash_t;
 
 #if USE_LD_MACROS
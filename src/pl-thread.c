@@ -2028,6 +2028,7 @@ copy_local_data(PL_local_data_t *ldnew, PL_local_data_t *ldold,
   ldnew->prolog_flag.mask	  = ldold->prolog_flag.mask;
   ldnew->prolog_flag.occurs_check = ldold->prolog_flag.occurs_check;
   ldnew->prolog_flag.access_level = ldold->prolog_flag.access_level;
+  ldnew->prolog_flag.cycle_threshold = ldold->prolog_flag.cycle_threshold;
 #ifdef O_BIGNUM
   ldnew->arith.rat                = ldold->arith.rat;
 #endif
@@ -3666,7 +3667,16 @@ PRED_IMPL("$engine_create", 3, engine_create, 0)
 
 static void
 destroy_interactor(thread_handle *th, int gc)
-{ if ( th->interactor.query )
+{ simpleMutex *mutex = th->interactor.mutex;
+  int locked = FALSE;
+
+  if ( !gc && mutex &&
+       !(th->info && th->info->thread_data == PL_current_engine()) )
+  { simpleMutexLock(mutex);		/* wait for engine_next/2 and */
+    locked = TRUE;			/* '$trim_engines' */
+  }
+
+  if ( th->interactor.query )
   { PL_engine_t me;
 
     PL_set_engine(th->info->thread_data, &me);
@@ -3684,8 +3694,16 @@ destroy_interactor(thread_handle *th, int gc)
     th->interactor.package = 0;
   }
   clear(th, (TH_INTERACTOR_NOMORE|TH_INTERACTOR_DONE));
-  simpleMutexDelete(th->interactor.mutex);
-  th->interactor.mutex = NULL;
+  if ( !gc )
+  { PL_LOCK(L_THREAD);			/* see trim_engine() */
+    th->interactor.mutex = NULL;
+    PL_UNLOCK(L_THREAD);
+  } else
+  { th->interactor.mutex = NULL;
+  }
+  if ( locked )
+    simpleMutexUnlock(mutex);
+  simpleMutexDelete(mutex);
   unalias_thread(th);
 }
 
@@ -4001,6 +4019,7 @@ typedef enum
 #define MSG_WAIT_INTR		(-1)
 #define MSG_WAIT_TIMEOUT	(-2)
 #define MSG_WAIT_DESTROYED	(-3)
+#define MSG_WAIT_IDLE		(-4)
 
 #define dispatch_cond_wait(queue, wait, deadline) LDFUNC(dispatch_cond_wait, queue, wait, deadline)
 static int dispatch_cond_wait(DECL_LD message_queue *queue,
@@ -4384,6 +4403,41 @@ msg_statistics(void)
 #define QSTAT(n) ((void)0)
 #endif
 
+/* - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+A thread that waits  for  a   message  for  idle_trim_time  seconds is
+considered idle and trims its stacks using idleTrimStacks().  We do this
+only once for each period of  inactivity,  i.e.,   not  again  if the
+thread did not run any inferences since the last trim.
+
+idle_trim_deadline() returns the deadline  get_message()   must  use for
+waiting: the user deadline or, if earlier, the idle deadline in `idle`.
+- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
+#define idle_trim_deadline(idle, deadline) LDFUNC(idle_trim_deadline, idle, deadline)
+static struct timespec *
+idle_trim_deadline(DECL_LD struct timespec *idle, struct timespec *deadline)
+{ if ( GD->idle_trim.time > 0.0 &&
+       LD->thread.idle_inferences != LD->statistics.inferences )
+  { struct timespec delta;
+
+    get_current_timespec(idle);
+    timespec_set_dbl(&delta, GD->idle_trim.time);
+    timespec_add(idle, &delta);
+    if ( !deadline || timespec_cmp(idle, deadline) < 0 )
+      return idle;
+  }
+
+  return deadline;
+}
+
+#define idle_trim(_) LDFUNC(idle_trim, _)
+static void
+idle_trim(DECL_LD)
+{ idleTrimStacks();
+  LD->thread.idle_inferences = LD->statistics.inferences;
+}
+
+
 /* - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 get_message() reads the next message from the  message queue. It must be
 called with queue->mutex locked.  It returns one of
@@ -4396,6 +4450,9 @@ called with queue->mutex locked.  It returns one of
 	  Got timeout while waiting
 	* MSG_WAIT_DESTROYED
 	  Queue was destroyed while waiting
+	* MSG_WAIT_IDLE
+	  Waited for the Prolog flag idle_trim_time seconds.  The caller
+	  must release the queue, call idle_trim() and retry.
 
 (*) We need  to lock  because AGC  marks our atoms  while the  thread is
 running.  The thread may pick   a  message containing  an atom  from the
@@ -4416,6 +4473,8 @@ get_message(DECL_LD message_queue *queue, term_t msg, struct timespec *deadline)
   word key = (isvar ? 0L : getIndexOfTerm(msg));
   fid_t fid = PL_open_foreign_frame();
   uint64_t seen = 0;
+  struct timespec idle;
+  struct timespec *wait_deadline = idle_trim_deadline(&idle, deadline);
 
   QSTAT(getmsg);
 
@@ -4511,7 +4570,7 @@ get_message(DECL_LD message_queue *queue, term_t msg, struct timespec *deadline)
     queue->waiting++;
     queue->waiting_var += isvar;
     DEBUG(MSG_QUEUE_WAIT, Sdprintf("%d: waiting on queue\n", PL_thread_self()));
-    rc = dispatch_cond_wait(queue, QUEUE_WAIT_READ, deadline);
+    rc = dispatch_cond_wait(queue, QUEUE_WAIT_READ, wait_deadline);
     switch ( rc )
     { case CV_INTR:
       { DEBUG(MSG_QUEUE_WAIT, Sdprintf("%d: CV_INTR\n", PL_thread_self()));
@@ -4535,7 +4594,7 @@ get_message(DECL_LD message_queue *queue, term_t msg, struct timespec *deadline)
 	queue->waiting--;
 	queue->waiting_var -= isvar;
 	PL_discard_foreign_frame(fid);
-	return MSG_WAIT_TIMEOUT;
+	return wait_deadline == deadline ? MSG_WAIT_TIMEOUT : MSG_WAIT_IDLE;
       }
       case CV_READY:
       case CV_MAYBE:
@@ -4846,6 +4905,9 @@ PRED_IMPL("thread_get_message", 1, thread_get_message, PL_FA_ISO)
     { if ( PL_handle_signals() >= 0 )
 	continue;
       rc = FALSE;
+    } else if ( rc == MSG_WAIT_IDLE )
+    { idle_trim();
+      continue;
     }
 
     break;
@@ -5521,6 +5583,9 @@ thread_get_message(DECL_LD term_t queue, term_t msg, struct timespec *deadline)
 	  continue;
 	rc = FALSE;
 	break;
+      case MSG_WAIT_IDLE:
+	idle_trim();
+	continue;
       case MSG_WAIT_DESTROYED:
 	rc = PL_error(NULL, 0, NULL, ERR_EXISTENCE, ATOM_message_queue, queue);
 	break;
@@ -6639,18 +6704,53 @@ isSignalledGCThread(DECL_LD int sig)
 }
 
 
+/* wakeupGCThread() makes '$gc_wait'/1 reconsider its timeout after
+   the Prolog flag idle_trim_time was changed.  As the gc thread is
+   normally started lazily, we start it here if we need it for trimming
+   idle engines.
+*/
+
+void
+wakeupGCThread(void)
+{ GET_LD
+
+  if ( gc_running() )
+  { pthread_mutex_lock(&GD->thread.gc.mutex);
+    pthread_cond_signal(&GD->thread.gc.cond);
+    pthread_mutex_unlock(&GD->thread.gc.mutex);
+  } else if ( GD->idle_trim.time > 0.0 &&
+	      truePrologFlag(PLFLAG_GCTHREAD) &&
+	      !GD->bootsession )
+  { GCthread();
+  }
+}
+
+
 static
 PRED_IMPL("$gc_wait", 1, gc_wait, 0)
 { PRED_LD
 
   for(;;)
   { unsigned int req;
+    int idle = FALSE;
     atom_t action;
 
     pthread_mutex_lock(&GD->thread.gc.mutex);
     req = GD->thread.gc.requests;
     if ( !req )
-      pthread_cond_wait(&GD->thread.gc.cond, &GD->thread.gc.mutex);
+    { if ( GD->idle_trim.time > 0.0 )	/* see trim_engines() */
+      { struct timespec deadline, delta;
+
+	get_current_timespec(&deadline);
+	timespec_set_dbl(&delta, GD->idle_trim.time);
+	timespec_add(&deadline, &delta);
+	idle = ( pthread_cond_timedwait(&GD->thread.gc.cond,
+					&GD->thread.gc.mutex,
+					&deadline) == ETIMEDOUT );
+      } else
+      { pthread_cond_wait(&GD->thread.gc.cond, &GD->thread.gc.mutex);
+      }
+    }
     pthread_mutex_unlock(&GD->thread.gc.mutex);
 
     if ( (req&GCREQUEST_ABORT) )
@@ -6659,6 +6759,8 @@ PRED_IMPL("$gc_wait", 1, gc_wait, 0)
       action = ATOM_garbage_collect_atoms;
     else if ( (req&GCREQUEST_CGC) )
       action = ATOM_garbage_collect_clauses;
+    else if ( idle )
+      action = ATOM_trim_engines;
     else
       continue;
 
@@ -6679,6 +6781,8 @@ PRED_IMPL("$gc_clear", 1, gc_clear, 0)
       mask = GCREQUEST_AGC;
     else if ( action == ATOM_garbage_collect_clauses )
       mask = GCREQUEST_CGC;
+    else if ( action == ATOM_trim_engines )
+      mask = 0;
     else
       return PL_domain_error("action", A1);
 
@@ -6693,6 +6797,97 @@ PRED_IMPL("$gc_clear", 1, gc_clear, 0)
 }
 
 
+/* - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+'$trim_engines' is called by the gc  thread   if  it  was  idle for the
+Prolog flag idle_trim_time seconds.  Engines have no thread that notices
+they are idle, so we trim engines that did not run any inferences since
+the previous sweep.  The engine is activated in the  gc thread as if we
+called engine_next/2, which is safe as   the  engine is suspended in the
+same state as after PL_next_solution() returned.
+
+Trimming may run GC, so we do not hold  L_THREAD while trimming. We first
+collect the engine symbols under L_THREAD and register them to keep the
+handles alive. Next, we handle the engines one  by one, only holding
+L_THREAD to acquire the interactor mutex  and   activate  the engine. A
+locked mutex implies the engine is  used  by  another thread. Setting
+`has_tid` makes PL_set_engine() fail while we trim and destroy_interactor()
+waits for the mutex.
+- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
+#define trim_engine(th) LDFUNC(trim_engine, th)
+static void
+trim_engine(DECL_LD thread_handle *th)
+{ PL_engine_t me = LD;
+  PL_local_data_t *ld = NULL;
+  int active = FALSE;
+
+  PL_LOCK(L_THREAD);
+  if ( th->interactor.mutex && th->info && !th->info->has_tid &&
+       (ld=th->info->thread_data) &&
+       simpleMutexTryLock(th->interactor.mutex) )
+  { uint64_t inferences = ld->statistics.inferences;
+
+    if ( th->interactor.query &&
+	 ld->thread.idle_seen == inferences &&
+	 ld->thread.idle_inferences != inferences )
+    { activate_interactor(th);
+      active = TRUE;
+    }
+    ld->thread.idle_seen = inferences;
+  } else
+  { ld = NULL;
+  }
+  PL_UNLOCK(L_THREAD);
+
+  if ( ld )
+  { if ( active )
+    { WITH_LD(ld)
+      { idle_trim();
+      }
+      PL_LOCK(L_THREAD);
+      suspend_interactor(me, th);
+      PL_UNLOCK(L_THREAD);
+    }
+    simpleMutexUnlock(th->interactor.mutex);
+  }
+}
+
+
+static
+PRED_IMPL("$trim_engines", 0, trim_engines, 0)
+{ PRED_LD
+  tmp_buffer engines;
+  atom_t *ep, *ee;
+  int tid;
+
+  initBuffer(&engines);
+  PL_LOCK(L_THREAD);
+  for(tid=1; tid<=GD->thread.highest_id; tid++)
+  { PL_thread_info_t *info = GD->thread.threads[tid];
+    thread_handle *th;
+
+    if ( info && info->is_engine && !info->has_tid &&
+	 info->thread_data && info->symbol &&
+	 (th=symbol_thread_handle(info->symbol)) &&
+	 true(th, TH_IS_INTERACTOR) )
+    { PL_register_atom(info->symbol);
+      addBuffer(&engines, info->symbol, atom_t);
+    }
+  }
+  PL_UNLOCK(L_THREAD);
+
+  ep = baseBuffer(&engines, atom_t);
+  ee = topBuffer(&engines, atom_t);
+  for(; ep < ee; ep++)
+  { trim_engine(symbol_thread_handle(*ep));
+    PL_unregister_atom(*ep);
+  }
+  discardBuffer(&engines);
+
+  return TRUE;
+}
+
+
 static rc_cancel
 cancelGCThread(int tid)
 { signalGCThreadCond(tid, SIG_PLABORT);
@@ -8174,6 +8369,7 @@ BeginPredDefs(thread)
   PRED_DEF("$thread_local_clause_count", 3, thread_local_clause_count, 0)
   PRED_DEF("$gc_wait",               1, gc_wait,               0)
   PRED_DEF("$gc_clear",              1, gc_clear,              0)
+  PRED_DEF("$trim_engines",	     0, trim_engines,	       0)
   PRED_DEF("$gc_stop",               0, gc_stop,               0)
 #endif
 EndPredDefs
@@ -602,6 +602,7 @@ void		markAccessedPredicates(PL_local_data_t *ld);
 int		cgc_thread_stats(cgc_stats *stats);
 int		signalGCThread(int sig);
 int		isSignalledGCThread(int sig);
+void		wakeupGCThread(void);
 double		ThreadCPUTime(int which);
 void		updatePendingThreadSignals(void);
 int		require_c_stack(size_t needed);
@@ -3070,6 +3070,167 @@ set_trie_clause_general_undefined(Clause clause)
   }
 }
 
+		 /*******************************
+		 *	  INTERNED TERMS	*
+		 *******************************/
+
+/* - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+term_intern/2 maps a ground term to a  handle. The terms are stored in a
+global trie, such that variant terms   share the same trie node. The
+handle is a unique blob holding  the  node   and  thus  there is at most
+one handle for each node, which  makes   ==/2  on  handles O(1). Handles
+are subject to atom garbage collection.   If  a handle is reclaimed we
+delete its node from the trie, unless   a new handle was created for the
+node while the old one was  being   reclaimed.  The  node's value is the
+index of its current handle to  detect   this  situation.  Updates to the
+trie are serialized using GD->intern.mutex.
+
+We may not call lookupBlob() while holding  the mutex: if the handle is
+being reclaimed, lookupBlob() waits for   release_interned_ref(), which
+needs the mutex. Therefore term_intern/2 registers  itself as a user of
+the node in GD->intern.pending before  releasing   the  mutex and creates
+the handle after releasing it. release_interned_ref() does not delete a
+node that has pending users. The last   pending user has stored its new
+handle in the node, so the node  is   deleted  when  that handle is
+reclaimed.
+- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
+#ifdef O_PLMT
+#define LOCK_INTERN()   simpleMutexLock(&GD->intern.mutex)
+#define UNLOCK_INTERN() simpleMutexUnlock(&GD->intern.mutex)
+#else
+#define LOCK_INTERN()   (void)0
+#define UNLOCK_INTERN() (void)0
+#endif
+
+typedef struct iref
+{ trie_node *node;			/* node in GD->intern.trie */
+} iref;
+
+static int
+write_interned_ref(IOSTREAM *s, atom_t aref, int flags)
+{ iref *ref = PL_blob_data(aref, NULL, NULL);
+  (void)flags;
+
+  Sfprintf(s, "<interned>(%p)", ref->node);
+  return TRUE;
+}
+
+
+/* Add delta to the pending users of node.  Must hold GD->intern.mutex */
+
+#define intern_pending(node, delta) LDFUNC(intern_pending, node, delta)
+static intptr_t
+intern_pending(DECL_LD trie_node *node, intptr_t delta)
+{ intptr_t n = (intptr_t)lookupHTable(GD->intern.pending, node) + delta;
+
+  if ( delta )
+  { if ( n > 0 )
+      updateHTable(GD->intern.pending, node, (void*)n);
+    else
+      deleteHTable(GD->intern.pending, node);
+  }
+
+  return n;
+}
+
+
+static int
+release_interned_ref(atom_t aref)
+{ GET_LD
+  iref *ref = PL_blob_data(aref, NULL, NULL);
+
+  LOCK_INTERN();
+  if ( ref->node->value == consInt(indexAtom(aref)) &&
+       intern_pending(ref->node, 0) == 0 )
+    trie_delete(GD->intern.trie, ref->node, TRUE);
+  UNLOCK_INTERN();
+
+  return TRUE;
+}
+
+
+static int
+save_interned_ref(atom_t aref, IOSTREAM *fd)
+{ iref *ref = PL_blob_data(aref, NULL, NULL);
+  (void)fd;
+
+  return PL_warning("Cannot save reference to <interned>(%p)", ref->node);
+}
+
+
+static atom_t
+load_interned_ref(IOSTREAM *fd)
+{ (void)fd;
+
+  return PL_new_atom("<saved-interned-ref>");
+}
+
+
+static PL_blob_t interned_blob =
+{ PL_BLOB_MAGIC,
+  PL_BLOB_UNIQUE,
+  "interned",
+  release_interned_ref,
+  NULL,
+  write_interned_ref,
+  NULL,
+  save_interned_ref,
+  load_interned_ref
+};
+
+
+/** term_intern(+Term, -Handle) is det.
+ *  term_intern(-Term, +Handle) is det.
+ *
+ * Map between a ground term and its unique handle.
+ */
+
+static
+PRED_IMPL("term_intern", 2, term_intern, 0)
+{ PRED_LD
+  void *data;
+  PL_blob_t *type;
+  trie_node *node;
+  atom_t handle = 0;
+  int rc;
+
+  if ( PL_get_blob(A2, &data, NULL, &type) )
+  { if ( type == &interned_blob )
+      return unify_trie_term(((iref*)data)->node, NULL, A1);
+
+    return PL_type_error("interned", A2);
+  }
+  if ( !PL_is_variable(A2) )
+    return PL_type_error("interned", A2);
+  if ( !PL_is_ground(A1) )
+    return PL_instantiation_error(A1);
+
+  LOCK_INTERN();
+  if ( (rc=trie_lookup(GD->intern.trie, NULL, &node,
+		       valTermRef(A1), TRUE, NULL)) == TRUE )
+    intern_pending(node, 1);
+  UNLOCK_INTERN();
+
+  if ( rc != TRUE )
+    return trie_error(rc, A1);
+
+  iref ref = { .node = node };
+  int new;
+
+  handle = lookupBlob((const char *)&ref, sizeof(ref), &interned_blob, &new);
+  LOCK_INTERN();
+  set_trie_value_word(GD->intern.trie, node, consInt(indexAtom(handle)));
+  intern_pending(node, -1);
+  UNLOCK_INTERN();
+
+  rc = PL_unify_atom(A2, handle);
+  PL_unregister_atom(handle);
+
+  return rc;
+}
+
+
 		 /*******************************
 		 *      PUBLISH PREDICATES	*
 		 *******************************/
@@ -3099,6 +3260,7 @@ BeginPredDefs(trie)
   PRED_DEF("trie_lookup_delete",    3, trie_lookup_delete,   0)
 #endif
   PRED_DEF("$trie_compile",         2, trie_compile,         0)
+  PRED_DEF("term_intern",	    2, term_intern,	     0)
 EndPredDefs
 
 void
@@ -3107,6 +3269,12 @@ initTries(void)
   Definition def;
 
   PL_register_blob_type(&trie_blob);
+  PL_register_blob_type(&interned_blob);
+#ifdef O_PLMT
+  simpleMutexInit(&GD->intern.mutex);
+#endif
+  GD->intern.trie = trie_create(NULL);
+  GD->intern.pending = newHTable(16);
 
   proc = PL_predicate("trie_gen_compiled", 2, "system");
   def = proc->definition;
@@ -98,7 +98,8 @@ push_start_args(argPairs *a, Word left, Word right, int arity)  /* plural */
 
 static inline bool
 push_args(argPairs *a, Word left, Word right, int arity)  /* plural */
-{ if ( !pushSegStack(&a->stack, a->work, aWork) )
+{ if ( a->work.arg < a->work.arity &&
+       !pushSegStack(&a->stack, a->work, aWork) )
     return FALSE;
 
   return push_start_args(a, left, right, arity);
@@ -316,15 +317,39 @@ isomorphic(DECL_LD argPairs *a, int i, int j, Buffer buf)
   return TRUE;
 }
 
-/* t =@= u */
+/* - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+t =@= u
+
+The first LD->prolog_flag.cycle_threshold compound pairs are walked as
+if the terms are acyclic, i.e., without  creating a node for them. This
+avoids the node administration for the common case. Compounds that are
+visited again in the remainder of the walk  are simply compared again,
+which is sound as the node administration  only serves to detect cycles
+and avoid repeated work. Runs  of   identical  atomic  cells are skipped,
+except if the threshold is 0, which selects the old algorithm.
+- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
 #define variant(agenda, buf) LDFUNC(variant, agenda, buf)
 static int
 variant(DECL_LD argPairs *agenda, Buffer buf)
 { Word l = NULL, r =NULL;
+  size_t budget = LD->prolog_flag.cycle_threshold;
+  int use_prefix = (budget > 0);	/* 0: old algorithm */
 
-  while( next_arg(agenda, &l, &r) )
+  for(;;)
   { word wl, wr;
 
+    if ( use_prefix && agenda->work.arg < agenda->work.arity )
+    { size_t nskip = identical_prefix(agenda->work.left, agenda->work.right,
+				      agenda->work.arity - agenda->work.arg,
+				      TRUE);
+      agenda->work.arg   += (int)nskip;
+      agenda->work.left  += nskip;
+      agenda->work.right += nskip;
+    }
+    if ( !next_arg(agenda, &l, &r) )
+      break;
+
  attvar:
    deRef(l);
    deRef(r);
@@ -390,6 +415,19 @@ variant(DECL_LD argPairs *agenda, Buffer buf)
 	  word dm, dn;			/* definition (= functor/arity) */
 	  Word lm, ln;			/* arguments list */
 
+	  if ( budget > 0 )		/* acyclic fast path */
+	  { Functor fl = valueTerm(wl);
+	    Functor fr = valueTerm(wr);
+
+	    budget--;
+	    if ( fl->definition != fr->definition )
+	      return FALSE;
+	    if ( !push_args(agenda, fl->arguments, fr->arguments,
+			    arityFunctor(fl->definition)) )
+	      return MEMORY_OVERFLOW;
+	    continue;
+	  }
+
 	  if ( (i = term_id(l, buf)) < 0 )
 	    return MEMORY_OVERFLOW;
 	  if ( (j = term_id(r, buf)) < 0 )
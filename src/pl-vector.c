@@ -0,0 +1,1307 @@
+/*  Part of SWI-Prolog
+
+    Author:        agent
+    E-mail:        agent@local
+    WWW:           http://www.swi-prolog.org
+    Copyright (c)  2026, agent
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in
+       the documentation and/or other materials provided with the
+       distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "pl-vector.h"
+#include "pl-arith.h"
+#include "pl-fli.h"
+#include "pl-alloc.h"
+#include "pl-gc.h"
+#include <math.h>
+
+/* - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Packed numeric vectors.  A vector is a blob that refers to a malloc()'ed
+array of int64, float64 or float32  elements.  Unlike  a  list  or  a
+compound holding numbers, the elements are not boxed on the global stack,
+so a vector of a million floats  is  8Mb  of  malloc()'ed  memory  that
+is neither copied nor scanned by the garbage collector.  The vector is
+released by atom garbage collection.
+
+Vectors are mutable using vector_set/3, which behaves as nb_setarg/3: the
+assignment is not undone on backtracking.  Vectors are not thread-safe.
+There is no locking; threads modifying a vector while others read it see
+an arbitrary mix of old and new values.
+
+The kernels are written as a blocked main loop over VEC_LANES independent
+accumulators followed by a scalar tail.  This allows GCC and Clang to
+vectorise them at -O2 without reassociating floating point arithmetic.
+If the compiler supports function multi-versioning (HAVE_TARGET_CLONES),
+x86 kernels are compiled for AVX2 as well as  for  the  baseline  and
+selected when the library is loaded.  Float sums and dot products are
+thus computed as VEC_LANES partial sums that are added  at  the  end.
+The result may differ in the last bits from summing the elements from
+left to right.  float32 elements are accumulated as doubles.
+
+int64 sums are exact.  Each element is split in a signed upper and an
+unsigned lower 32-bit half whose sums cannot overflow for blocks of up to
+2^31 elements.  The halves are combined using (big) integer arithmetic.
+Dot products and axpy on int64 vectors check each operation for overflow.
+The dot product continues using bignums after an overflow; axpy and the
+cumulative sum raise an int_overflow evaluation error as the result is an
+int64 vector.
+- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
+#define VEC_INT64	0
+#define VEC_FLOAT64	1
+#define VEC_FLOAT32	2
+
+#define VEC_LANES	8
+#define VEC_I64_BLOCK	((size_t)1<<31)	/* see sum_i64_parts() */
+
+#if defined(HAVE_TARGET_CLONES) && (defined(__x86_64__) || defined(__i386__))
+#define SIMD_KERNEL __attribute__((target_clones("avx2","default")))
+#else
+#define SIMD_KERNEL
+#endif
+
+typedef struct pl_vector
+{ unsigned int	type;			/* VEC_* */
+  size_t	length;			/* # elements */
+  union
+  { int64_t	i[1];
+    double	d[1];
+    float	f[1];
+  } data;
+} pl_vector;
+
+typedef struct vref
+{ pl_vector    *vector;			/* represented vector */
+} vref;
+
+static const size_t vec_elem_size[] =
+{ sizeof(int64_t), sizeof(double), sizeof(float)
+};
+
+
+		 /*******************************
+		 *	       SYMBOL		*
+		 *******************************/
+
+static atom_t
+vector_type_name(unsigned int type)
+{ switch(type)
+  { case VEC_INT64:   return ATOM_int64;
+    case VEC_FLOAT64: return ATOM_float64;
+    case VEC_FLOAT32: return ATOM_float32;
+    default:	      assert(0); return NULL_ATOM;
+  }
+}
+
+static int
+write_vector_ref(IOSTREAM *s, atom_t aref, int flags)
+{ vref *ref = PL_blob_data(aref, NULL, NULL);
+  pl_vector *v = ref->vector;
+  (void)flags;
+
+  Sfprintf(s, "<vector>(%s,%zd,%p)",
+	   stringAtom(vector_type_name(v->type)), v->length, v);
+  return TRUE;
+}
+
+static int
+release_vector_ref(atom_t aref)
+{ vref *ref = PL_blob_data(aref, NULL, NULL);
+
+  free(ref->vector);
+  return TRUE;
+}
+
+static int
+save_vector(atom_t aref, IOSTREAM *fd)
+{ vref *ref = PL_blob_data(aref, NULL, NULL);
+  (void)fd;
+
+  return PL_warning("Cannot save reference to <vector>(%p)", ref->vector);
+}
+
+static atom_t
+load_vector(IOSTREAM *fd)
+{ (void)fd;
+
+  return PL_new_atom("<saved-vector-ref>");
+}
+
+static PL_blob_t vector_blob =
+{ PL_BLOB_MAGIC,
+  0,
+  "vector",
+  release_vector_ref,
+  NULL,
+  write_vector_ref,
+  NULL,
+  save_vector,
+  load_vector
+};
+
+
+static pl_vector *
+new_vector(unsigned int type, size_t length)
+{ size_t esize = vec_elem_size[type];
+  pl_vector *v;
+
+  if ( length > (SIZE_MAX-sizeof(*v))/esize )
+  { PL_resource_error("memory");
+    return NULL;
+  }
+  if ( !(v = malloc(sizeof(*v) + length*esize)) )
+  { PL_no_memory();
+    return NULL;
+  }
+  v->type   = type;
+  v->length = length;
+
+  return v;
+}
+
+static int
+unify_vector(term_t t, pl_vector *v)
+{ vref ref;
+
+  ref.vector = v;
+  return PL_unify_blob(t, &ref, sizeof(ref), &vector_blob);
+}
+
+static pl_vector *
+symbol_vector(word w)
+{ PL_blob_t *type;
+  void *data;
+
+  if ( isAtom(w) &&
+       (data = PL_blob_data(w, NULL, &type)) && type == &vector_blob )
+    return ((vref*)data)->vector;
+
+  return NULL;
+}
+
+static int
+get_vector(term_t t, pl_vector **vp)
+{ void *data;
+  PL_blob_t *type;
+
+  if ( PL_get_blob(t, &data, NULL, &type) && type == &vector_blob )
+  { *vp = ((vref*)data)->vector;
+    return TRUE;
+  }
+
+  PL_type_error("vector", t);
+  return FALSE;
+}
+
+static int
+get_vector_type(term_t t, unsigned int *tp)
+{ atom_t a;
+
+  if ( !PL_get_atom_ex(t, &a) )
+    return FALSE;
+  if ( a == ATOM_int64 )
+    *tp = VEC_INT64;
+  else if ( a == ATOM_float64 )
+    *tp = VEC_FLOAT64;
+  else if ( a == ATOM_float32 )
+    *tp = VEC_FLOAT32;
+  else
+    return PL_domain_error("vector_type", t);
+
+  return TRUE;
+}
+
+static int
+same_length(pl_vector *v1, pl_vector *v2, term_t t2)
+{ if ( v1->length == v2->length )
+    return TRUE;
+
+  return PL_domain_error("vector_length", t2);
+}
+
+static inline double
+vec_double(const pl_vector *v, size_t i)
+{ switch(v->type)
+  { case VEC_INT64:   return (double)v->data.i[i];
+    case VEC_FLOAT64: return v->data.d[i];
+    default:	      return (double)v->data.f[i];
+  }
+}
+
+		 /*******************************
+		 *	 INT64 ARITHMETIC	*
+		 *******************************/
+
+static inline int
+add_i64(int64_t a, int64_t b, int64_t *r)
+{
+#if HAVE___BUILTIN_MUL_OVERFLOW
+  return !__builtin_add_overflow(a, b, r);
+#else
+  int64_t s = (int64_t)((uint64_t)a + (uint64_t)b);
+
+  *r = s;
+  return ((a^s) & (b^s)) >= 0;
+#endif
+}
+
+static inline int
+mul_i64(int64_t a, int64_t b, int64_t *r)
+{
+#if HAVE___BUILTIN_MUL_OVERFLOW
+  return !__builtin_mul_overflow(a, b, r);
+#else
+  if ( a == 0 || b == 0 )
+  { *r = 0;
+    return TRUE;
+  }
+  if ( (a == -1 && b == INT64_MIN) || (b == -1 && a == INT64_MIN) )
+    return FALSE;
+  *r = (int64_t)((uint64_t)a * (uint64_t)b);
+  return *r / b == a;
+#endif
+}
+
+/* r += n, where r is initialised and n is consumed */
+
+static int
+add_number(Number r, Number n)
+{ number s;
+  int rc;
+
+  rc = pl_ar_add(r, n, &s);
+  clearNumber(r);
+  clearNumber(n);
+  if ( rc )
+    *r = s;
+  else
+    r->type = V_INTEGER;		/* clearNumber() safe */
+
+  return rc;
+}
+
+static int
+int_overflow(void)
+{ return PL_error(NULL, 0, NULL, ERR_EVALUATION, ATOM_int_overflow);
+}
+
+
+		 /*******************************
+		 *	      KERNELS		*
+		 *******************************/
+
+SIMD_KERNEL static double
+sum_f64(const double *v, size_t len)
+{ double acc[VEC_LANES] = {0};
+  double s = 0.0;
+  size_t i = 0;
+
+  for(; i+VEC_LANES <= len; i += VEC_LANES)
+  { for(int j=0; j<VEC_LANES; j++)
+      acc[j] += v[i+j];
+  }
+  for(int j=0; j<VEC_LANES; j++)
+    s += acc[j];
+  for(; i<len; i++)
+    s += v[i];
+
+  return s;
+}
+
+SIMD_KERNEL static double
+sum_f32(const float *v, size_t len)
+{ double acc[VEC_LANES] = {0};
+  double s = 0.0;
+  size_t i = 0;
+
+  for(; i+VEC_LANES <= len; i += VEC_LANES)
+  { for(int j=0; j<VEC_LANES; j++)
+      acc[j] += (double)v[i+j];
+  }
+  for(int j=0; j<VEC_LANES; j++)
+    s += acc[j];
+  for(; i<len; i++)
+    s += (double)v[i];
+
+  return s;
+}
+
+/* Sum at most VEC_I64_BLOCK elements as hi*2^32+lo.  The |hi| parts
+   are at most 2^31 and the lo parts below 2^32, so neither sum can
+   overflow.
+*/
+
+SIMD_KERNEL static void
+sum_i64_parts(const int64_t *v, size_t len, int64_t *hip, uint64_t *lop)
+{ int64_t  hi[VEC_LANES] = {0};
+  uint64_t lo[VEC_LANES] = {0};
+  int64_t  h = 0;
+  uint64_t l = 0;
+  size_t i = 0;
+
+  for(; i+VEC_LANES <= len; i += VEC_LANES)
+  { for(int j=0; j<VEC_LANES; j++)
+    { hi[j] += v[i+j] >> 32;
+      lo[j] += (uint32_t)v[i+j];
+    }
+  }
+  for(int j=0; j<VEC_LANES; j++)
+  { h += hi[j];
+    l += lo[j];
+  }
+  for(; i<len; i++)
+  { h += v[i] >> 32;
+    l += (uint32_t)v[i];
+  }
+
+  *hip = h;
+  *lop = l;
+}
+
+SIMD_KERNEL static double
+dot_f64(const double *a, const double *b, size_t len)
+{ double acc[VEC_LANES] = {0};
+  double s = 0.0;
+  size_t i = 0;
+
+  for(; i+VEC_LANES <= len; i += VEC_LANES)
+  { for(int j=0; j<VEC_LANES; j++)
+      acc[j] += a[i+j]*b[i+j];
+  }
+  for(int j=0; j<VEC_LANES; j++)
+    s += acc[j];
+  for(; i<len; i++)
+    s += a[i]*b[i];
+
+  return s;
+}
+
+SIMD_KERNEL static double
+dot_f32(const float *a, const float *b, size_t len)
+{ double acc[VEC_LANES] = {0};
+  double s = 0.0;
+  size_t i = 0;
+
+  for(; i+VEC_LANES <= len; i += VEC_LANES)
+  { for(int j=0; j<VEC_LANES; j++)
+      acc[j] += (double)a[i+j]*(double)b[i+j];
+  }
+  for(int j=0; j<VEC_LANES; j++)
+    s += acc[j];
+  for(; i<len; i++)
+    s += (double)a[i]*(double)b[i];
+
+  return s;
+}
+
+SIMD_KERNEL static void
+axpy_f64(double a, const double *restrict x, const double *restrict y,
+	 double *restrict z, size_t len)
+{ size_t i = 0;
+
+  for(; i+VEC_LANES <= len; i += VEC_LANES)
+  { for(int j=0; j<VEC_LANES; j++)
+      z[i+j] = a*x[i+j] + y[i+j];
+  }
+  for(; i<len; i++)
+    z[i] = a*x[i] + y[i];
+}
+
+SIMD_KERNEL static void
+axpy_f32(float a, const float *restrict x, const float *restrict y,
+	 float *restrict z, size_t len)
+{ size_t i = 0;
+
+  for(; i+VEC_LANES <= len; i += VEC_LANES)
+  { for(int j=0; j<VEC_LANES; j++)
+      z[i+j] = a*x[i+j] + y[i+j];
+  }
+  for(; i<len; i++)
+    z[i] = a*x[i] + y[i];
+}
+
+/* Min and max ignore NaN: (x < m ? x : m) keeps m if x is NaN.  The
+   lanes are initialised with the first element, which the caller
+   ensures is not NaN.
+*/
+
+#define MINMAX_KERNEL(name, type)					\
+SIMD_KERNEL static void							\
+name(const type *v, size_t len, type *minp, type *maxp)			\
+{ type mn[VEC_LANES], mx[VEC_LANES];					\
+  type lo = v[0], hi = v[0];						\
+  size_t i = 0;								\
+									\
+  for(int j=0; j<VEC_LANES; j++)					\
+    mn[j] = mx[j] = v[0];						\
+  for(; i+VEC_LANES <= len; i += VEC_LANES)				\
+  { for(int j=0; j<VEC_LANES; j++)					\
+    { mn[j] = v[i+j] < mn[j] ? v[i+j] : mn[j];				\
+      mx[j] = v[i+j] > mx[j] ? v[i+j] : mx[j];				\
+    }									\
+  }									\
+  for(int j=0; j<VEC_LANES; j++)					\
+  { lo = mn[j] < lo ? mn[j] : lo;					\
+    hi = mx[j] > hi ? mx[j] : hi;					\
+  }									\
+  for(; i<len; i++)							\
+  { lo = v[i] < lo ? v[i] : lo;						\
+    hi = v[i] > hi ? v[i] : hi;						\
+  }									\
+									\
+  *minp = lo;								\
+  *maxp = hi;								\
+}
+
+MINMAX_KERNEL(minmax_i64, int64_t)
+MINMAX_KERNEL(minmax_f64, double)
+MINMAX_KERNEL(minmax_f32, float)
+
+
+		 /*******************************
+		 *	     OPERATIONS		*
+		 *******************************/
+
+static int
+vector_sum(const pl_vector *v, Number r)
+{ switch(v->type)
+  { case VEC_INT64:
+    { const int64_t *p = v->data.i;
+      size_t left = v->length;
+
+      r->type = V_INTEGER;
+      r->value.i = 0;
+
+      while ( left > 0 )
+      { size_t n = left > VEC_I64_BLOCK ? VEC_I64_BLOCK : left;
+	int64_t h, l;
+	uint64_t lo;
+	number nh, nl, shift, t;
+
+	sum_i64_parts(p, n, &h, &lo);
+	p += n;
+	left -= n;
+					/* h*2^32 + lo; lo < 2^63 */
+	if ( h >= -((int64_t)1<<30) && h < ((int64_t)1<<30) )
+	{ if ( add_i64((int64_t)((uint64_t)h<<32), (int64_t)lo, &l) )
+	  { nl.type = V_INTEGER;
+	    nl.value.i = l;
+	    if ( !add_number(r, &nl) )
+	      return FALSE;
+	    continue;
+	  }
+	}
+	nh.type = V_INTEGER;
+	nh.value.i = h;
+	shift.type = V_INTEGER;
+	shift.value.i = (int64_t)1<<32;
+	nl.type = V_INTEGER;
+	nl.value.i = (int64_t)lo;
+	if ( !ar_mul(&nh, &shift, &t) ||
+	     !add_number(r, &t) ||
+	     !add_number(r, &nl) )
+	  return FALSE;
+      }
+      return TRUE;
+    }
+    case VEC_FLOAT64:
+      r->type = V_FLOAT;
+      r->value.f = sum_f64(v->data.d, v->length);
+      return TRUE;
+    case VEC_FLOAT32:
+      r->type = V_FLOAT;
+      r->value.f = sum_f32(v->data.f, v->length);
+      return TRUE;
+  }
+
+  assert(0);
+  return FALSE;
+}
+
+static int
+dot_i64(const int64_t *a, const int64_t *b, size_t len, Number r)
+{ int64_t acc = 0;
+  size_t i;
+
+  for(i=0; i<len; i++)
+  { int64_t p, s;
+
+    if ( !mul_i64(a[i], b[i], &p) || !add_i64(acc, p, &s) )
+      break;
+    acc = s;
+  }
+
+  r->type = V_INTEGER;
+  r->value.i = acc;
+
+  for(; i<len; i++)			/* overflow: continue using bignums */
+  { number na, nb, np;
+
+    na.type = V_INTEGER;
+    na.value.i = a[i];
+    nb.type = V_INTEGER;
+    nb.value.i = b[i];
+    if ( !ar_mul(&na, &nb, &np) ||
+	 !add_number(r, &np) )
+      return FALSE;
+  }
+
+  return TRUE;
+}
+
+/* vector_dot() assumes both vectors have the same length */
+
+static int
+vector_dot(const pl_vector *v1, const pl_vector *v2, Number r)
+{ if ( v1->type == v2->type )
+  { switch(v1->type)
+    { case VEC_INT64:
+	return dot_i64(v1->data.i, v2->data.i, v1->length, r);
+      case VEC_FLOAT64:
+	r->type = V_FLOAT;
+	r->value.f = dot_f64(v1->data.d, v2->data.d, v1->length);
+	return TRUE;
+      case VEC_FLOAT32:
+	r->type = V_FLOAT;
+	r->value.f = dot_f32(v1->data.f, v2->data.f, v1->length);
+	return TRUE;
+    }
+  } else
+  { double s = 0.0;
+
+    for(size_t i=0; i<v1->length; i++)
+      s += vec_double(v1, i)*vec_double(v2, i);
+    r->type = V_FLOAT;
+    r->value.f = s;
+    return TRUE;
+  }
+
+  assert(0);
+  return FALSE;
+}
+
+/* vector_min_max() fails silently if v is empty or only holds NaN */
+
+static int
+vector_min_max(const pl_vector *v, Number min, Number max)
+{ size_t i = 0;
+
+  switch(v->type)
+  { case VEC_INT64:
+    { int64_t lo, hi;
+
+      if ( v->length == 0 )
+	return FALSE;
+      minmax_i64(v->data.i, v->length, &lo, &hi);
+      min->type = max->type = V_INTEGER;
+      min->value.i = lo;
+      max->value.i = hi;
+      return TRUE;
+    }
+    case VEC_FLOAT64:
+    { double lo, hi;
+
+      while( i < v->length && isnan(v->data.d[i]) )
+	i++;
+      if ( i == v->length )
+	return FALSE;
+      minmax_f64(v->data.d+i, v->length-i, &lo, &hi);
+      min->type = max->type = V_FLOAT;
+      min->value.f = lo;
+      max->value.f = hi;
+      return TRUE;
+    }
+    case VEC_FLOAT32:
+    { float lo, hi;
+
+      while( i < v->length && isnan(v->data.f[i]) )
+	i++;
+      if ( i == v->length )
+	return FALSE;
+      minmax_f32(v->data.f+i, v->length-i, &lo, &hi);
+      min->type = max->type = V_FLOAT;
+      min->value.f = lo;
+      max->value.f = hi;
+      return TRUE;
+    }
+  }
+
+  assert(0);
+  return FALSE;
+}
+
+
+		 /*******************************
+		 *	      SORTING		*
+		 *******************************/
+
+/* - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Vectors are sorted using an LSD radix sort on 64-bit keys  that  order
+as unsigned integers.  int64 keys flip the sign bit.  Float keys flip all
+bits of negative numbers and the sign bit of positive ones.  NaN is mapped
+to the largest key, so NaNs end up at the end as positive quiet NaNs.
+float32 keys use the lower 32 bits; passes over bytes that are the same
+for all keys are skipped.
+- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
+#define SIGN64 ((uint64_t)1<<63)
+#define SIGN32 ((uint32_t)1<<31)
+
+static inline uint64_t
+f64_key(double d)
+{ union { double d; uint64_t i; } u;
+
+  if ( isnan(d) )
+    return ~(uint64_t)0;
+  u.d = d;
+  return (u.i & SIGN64) ? ~u.i : u.i ^ SIGN64;
+}
+
+static inline double
+key_f64(uint64_t k)
+{ union { double d; uint64_t i; } u;
+
+  u.i = (k & SIGN64) ? k ^ SIGN64 : ~k;
+  return u.d;
+}
+
+static inline uint64_t
+f32_key(float f)
+{ union { float f; uint32_t i; } u;
+
+  if ( isnan(f) )
+    return ~(uint32_t)0;
+  u.f = f;
+  return (u.i & SIGN32) ? (uint32_t)~u.i : u.i ^ SIGN32;
+}
+
+static inline float
+key_f32(uint64_t k)
+{ union { float f; uint32_t i; } u;
+  uint32_t k32 = (uint32_t)k;
+
+  u.i = (k32 & SIGN32) ? k32 ^ SIGN32 : ~k32;
+  return u.f;
+}
+
+static void
+radix_sort_u64(uint64_t *keys, uint64_t *tmp, size_t n)
+{ size_t count[8][256];
+
+  memset(count, 0, sizeof(count));
+  for(size_t i=0; i<n; i++)
+  { uint64_t k = keys[i];
+
+    for(int d=0; d<8; d++)
+      count[d][(k>>(d*8))&0xff]++;
+  }
+
+  for(int d=0; d<8; d++)
+  { size_t *c = count[d];
+    size_t pos = 0;
+
+    if ( c[(keys[0]>>(d*8))&0xff] == n )
+      continue;				/* all keys have this digit */
+    for(int b=0; b<256; b++)
+    { size_t cnt = c[b];
+      c[b] = pos;
+      pos += cnt;
+    }
+    for(size_t i=0; i<n; i++)
+    { uint64_t k = keys[i];
+      tmp[c[(k>>(d*8))&0xff]++] = k;
+    }
+    memcpy(keys, tmp, n*sizeof(*keys));
+  }
+}
+
+static void
+insertion_sort_u64(uint64_t *keys, size_t n)
+{ for(size_t i=1; i<n; i++)
+  { uint64_t k = keys[i];
+    size_t j = i;
+
+    for(; j > 0 && keys[j-1] > k; j--)
+      keys[j] = keys[j-1];
+    keys[j] = k;
+  }
+}
+
+static int
+sort_vector(const pl_vector *v, pl_vector *s)
+{ size_t n = v->length;
+  uint64_t *keys;
+
+  if ( n < 2 )
+  { memcpy(&s->data, &v->data, n*vec_elem_size[v->type]);
+    return TRUE;
+  }
+  if ( !(keys = malloc(n*2*sizeof(*keys))) )
+    return PL_no_memory();
+
+  switch(v->type)
+  { case VEC_INT64:
+      for(size_t i=0; i<n; i++)
+	keys[i] = (uint64_t)v->data.i[i] ^ SIGN64;
+      break;
+    case VEC_FLOAT64:
+      for(size_t i=0; i<n; i++)
+	keys[i] = f64_key(v->data.d[i]);
+      break;
+    case VEC_FLOAT32:
+      for(size_t i=0; i<n; i++)
+	keys[i] = f32_key(v->data.f[i]);
+      break;
+  }
+
+  if ( n < 64 )
+    insertion_sort_u64(keys, n);
+  else
+    radix_sort_u64(keys, keys+n, n);
+
+  switch(v->type)
+  { case VEC_INT64:
+      for(size_t i=0; i<n; i++)
+	s->data.i[i] = (int64_t)(keys[i] ^ SIGN64);
+      break;
+    case VEC_FLOAT64:
+      for(size_t i=0; i<n; i++)
+	s->data.d[i] = key_f64(keys[i]);
+      break;
+    case VEC_FLOAT32:
+      for(size_t i=0; i<n; i++)
+	s->data.f[i] = key_f32(keys[i]);
+      break;
+  }
+
+  free(keys);
+  return TRUE;
+}
+
+
+		 /*******************************
+		 *	 PROLOG BINDING		*
+		 *******************************/
+
+static
+PRED_IMPL("list_to_vector", 3, list_to_vector, 0)
+{ PRED_LD
+  unsigned int type;
+  size_t len;
+  pl_vector *v;
+
+  if ( !get_vector_type(A1, &type) )
+    return FALSE;
+  switch(PL_skip_list(A2, 0, &len))
+  { case PL_LIST:
+      break;
+    case PL_PARTIAL_LIST:
+      return PL_instantiation_error(A2);
+    default:
+      return PL_type_error("list", A2);
+  }
+
+  if ( (v=new_vector(type, len)) )
+  { term_t tail = PL_copy_term_ref(A2);
+    term_t head = PL_new_term_ref();
+
+    for(size_t i=0; PL_get_list(tail, head, tail); i++)
+    { double f;
+
+      switch(type)
+      { case VEC_INT64:
+	  if ( !PL_get_int64_ex(head, &v->data.i[i]) )
+	    goto error;
+	  break;
+	case VEC_FLOAT64:
+	  if ( !PL_get_float_ex(head, &v->data.d[i]) )
+	    goto error;
+	  break;
+	case VEC_FLOAT32:
+	  if ( !PL_get_float_ex(head, &f) )
+	    goto error;
+	  v->data.f[i] = (float)f;
+	  break;
+      }
+    }
+
+    return unify_vector(A3, v);
+
+  error:
+    free(v);
+  }
+
+  return FALSE;
+}
+
+
+static
+PRED_IMPL("vector_to_list", 2, vector_to_list, 0)
+{ PRED_LD
+  pl_vector *v;
+  size_t len, cell, big = 0;
+  term_t list;
+  Word p;
+
+  if ( !get_vector(A1, &v) )
+    return FALSE;
+  if ( (len=v->length) == 0 )
+    return PL_unify_nil(A2);
+
+  if ( v->type == VEC_INT64 )
+  { for(size_t i=0; i<len; i++)
+    { if ( v->data.i[i] < PLMINTAGGEDINT || v->data.i[i] > PLMAXTAGGEDINT )
+	big++;
+    }
+    cell = 3;
+  } else
+  { cell = 3+2+WORDS_PER_DOUBLE;
+  }
+
+  if ( len > (size_t)(PLMAXINT/sizeof(word))/(3+2+WORDS_PER_DOUBLE) )
+    return outOfStack((Stack)&LD->stacks.global, STACK_OVERFLOW_RAISE);
+  if ( !hasGlobalSpace(len*cell+big*(2+WORDS_PER_INT64)) )
+  { int rc;
+
+    if ( (rc=ensureGlobalSpace(len*cell+big*(2+WORDS_PER_INT64),
+			       ALLOW_GC)) != TRUE )
+      return raiseStackOverflow(rc);
+  }
+
+  list = PL_new_term_ref();
+  p = gTop;
+  gTop += len*3;			/* list skeleton, elements follow */
+  *valTermRef(list) = consPtr(p, TAG_COMPOUND|STG_GLOBAL);
+  for(size_t i=0; i<len; i++)
+  { p[0] = FUNCTOR_dot2;
+    if ( v->type == VEC_INT64 )
+      put_int64(&p[1], v->data.i[i], ALLOW_CHECKED);
+    else
+      put_double(&p[1], vec_double(v, i), ALLOW_CHECKED);
+    p[2] = consPtr(&p[3], TAG_COMPOUND|STG_GLOBAL);
+    p += 3;
+  }
+  p[-1] = ATOM_nil;
+
+  return PL_unify(A2, list);
+}
+
+
+static
+PRED_IMPL("new_vector", 4, new_vector, 0)
+{ unsigned int type;
+  size_t len;
+  pl_vector *v;
+
+  if ( !get_vector_type(A1, &type) ||
+       !PL_get_size_ex(A2, &len) )
+    return FALSE;
+
+  if ( (v=new_vector(type, len)) )
+  { switch(type)
+    { case VEC_INT64:
+      { int64_t i;
+
+	if ( !PL_get_int64_ex(A3, &i) )
+	{ free(v);
+	  return FALSE;
+	}
+	for(size_t k=0; k<len; k++)
+	  v->data.i[k] = i;
+	break;
+      }
+      case VEC_FLOAT64:
+      case VEC_FLOAT32:
+      { double f;
+
+	if ( !PL_get_float_ex(A3, &f) )
+	{ free(v);
+	  return FALSE;
+	}
+	if ( type == VEC_FLOAT64 )
+	{ for(size_t k=0; k<len; k++)
+	    v->data.d[k] = f;
+	} else
+	{ for(size_t k=0; k<len; k++)
+	    v->data.f[k] = (float)f;
+	}
+	break;
+      }
+    }
+
+    return unify_vector(A4, v);
+  }
+
+  return FALSE;
+}
+
+
+static
+PRED_IMPL("is_vector", 1, is_vector, 0)
+{ void *data;
+  PL_blob_t *type;
+
+  return ( PL_get_blob(A1, &data, NULL, &type) && type == &vector_blob );
+}
+
+
+static
+PRED_IMPL("vector_type", 2, vector_type, 0)
+{ PRED_LD
+  pl_vector *v;
+
+  return ( get_vector(A1, &v) &&
+	   PL_unify_atom(A2, vector_type_name(v->type)) );
+}
+
+
+static
+PRED_IMPL("vector_length", 2, vector_length, 0)
+{ pl_vector *v;
+
+  return ( get_vector(A1, &v) &&
+	   PL_unify_int64(A2, v->length) );
+}
+
+
+/* Get a 0-based index into v, which is the vector referenced by vt.
+   Raise an error rather than failing if the index is out of range.
+*/
+
+static int
+get_index(term_t t, term_t vt, pl_vector *v, size_t *ip)
+{ int64_t i;
+
+  if ( !PL_get_int64_ex(t, &i) )
+    return FALSE;
+  if ( i < 0 )
+    return PL_error(NULL, 0, NULL, ERR_DOMAIN, ATOM_not_less_than_zero, t);
+  if ( (uint64_t)i >= v->length )
+    return PL_error(NULL, 0, NULL, ERR_EXISTENCE3, ATOM_index, t, vt);
+  *ip = (size_t)i;
+
+  return TRUE;
+}
+
+
+static
+PRED_IMPL("vector_get", 3, vector_get, 0)
+{ pl_vector *v;
+  size_t i;
+
+  if ( !get_vector(A1, &v) || !get_index(A2, A1, v, &i) )
+    return FALSE;
+
+  if ( v->type == VEC_INT64 )
+    return PL_unify_int64(A3, v->data.i[i]);
+  else
+    return PL_unify_float(A3, vec_double(v, i));
+}
+
+
+static
+PRED_IMPL("vector_set", 3, vector_set, 0)
+{ pl_vector *v;
+  size_t i;
+  double f;
+
+  if ( !get_vector(A1, &v) || !get_index(A2, A1, v, &i) )
+    return FALSE;
+
+  switch(v->type)
+  { case VEC_INT64:
+      return PL_get_int64_ex(A3, &v->data.i[i]);
+    case VEC_FLOAT64:
+      return PL_get_float_ex(A3, &v->data.d[i]);
+    case VEC_FLOAT32:
+      if ( !PL_get_float_ex(A3, &f) )
+	return FALSE;
+      v->data.f[i] = (float)f;
+      return TRUE;
+  }
+
+  assert(0);
+  return FALSE;
+}
+
+
+static
+PRED_IMPL("vector_slice", 4, vector_slice, 0)
+{ pl_vector *v, *s;
+  size_t start, len;
+
+  if ( !get_vector(A1, &v) ||
+       !PL_get_size_ex(A2, &start) ||
+       !PL_get_size_ex(A3, &len) )
+    return FALSE;
+  if ( start > v->length || len > v->length - start )
+  { term_t ex;					/* first index out of range */
+
+    return ( (ex=PL_new_term_ref()) &&
+	     PL_put_int64(ex, start > v->length ? start : v->length) &&
+	     PL_error(NULL, 0, NULL, ERR_EXISTENCE3, ATOM_index, ex, A1) );
+  }
+
+  if ( (s=new_vector(v->type, len)) )
+  { size_t esize = vec_elem_size[v->type];
+
+    memcpy(&s->data, (char*)&v->data + start*esize, len*esize);
+    return unify_vector(A4, s);
+  }
+
+  return FALSE;
+}
+
+
+static
+PRED_IMPL("vector_sum", 2, vector_sum, 0)
+{ pl_vector *v;
+  number n;
+  int rc;
+
+  if ( !get_vector(A1, &v) || !vector_sum(v, &n) )
+    return FALSE;
+  rc = PL_unify_number(A2, &n);
+  clearNumber(&n);
+
+  return rc;
+}
+
+
+static
+PRED_IMPL("vector_dot", 3, vector_dot, 0)
+{ pl_vector *v1, *v2;
+  number n;
+  int rc;
+
+  if ( !get_vector(A1, &v1) || !get_vector(A2, &v2) ||
+       !same_length(v1, v2, A2) ||
+       !vector_dot(v1, v2, &n) )
+    return FALSE;
+  rc = PL_unify_number(A3, &n);
+  clearNumber(&n);
+
+  return rc;
+}
+
+
+static
+PRED_IMPL("vector_min_max", 3, vector_min_max, 0)
+{ pl_vector *v;
+  number min, max;
+
+  if ( !get_vector(A1, &v) )
+    return FALSE;
+
+  return ( vector_min_max(v, &min, &max) &&
+	   PL_unify_number(A2, &min) &&
+	   PL_unify_number(A3, &max) );
+}
+
+
+static
+PRED_IMPL("vector_axpy", 4, vector_axpy, 0)
+{ pl_vector *x, *y, *z;
+  size_t len;
+
+  if ( !get_vector(A2, &x) || !get_vector(A3, &y) ||
+       !same_length(x, y, A3) )
+    return FALSE;
+  if ( x->type != y->type )
+    return PL_domain_error(stringAtom(vector_type_name(x->type)), A3);
+  len = x->length;
+
+  if ( x->type == VEC_INT64 )
+  { int64_t a;
+
+    if ( !PL_get_int64_ex(A1, &a) || !(z=new_vector(x->type, len)) )
+      return FALSE;
+    for(size_t i=0; i<len; i++)
+    { int64_t p;
+
+      if ( !mul_i64(a, x->data.i[i], &p) ||
+	   !add_i64(p, y->data.i[i], &z->data.i[i]) )
+      { free(z);
+	return int_overflow();
+      }
+    }
+  } else
+  { double a;
+
+    if ( !PL_get_float_ex(A1, &a) || !(z=new_vector(x->type, len)) )
+      return FALSE;
+    if ( x->type == VEC_FLOAT64 )
+      axpy_f64(a, x->data.d, y->data.d, z->data.d, len);
+    else
+      axpy_f32((float)a, x->data.f, y->data.f, z->data.f, len);
+  }
+
+  return unify_vector(A4, z);
+}
+
+
+static
+PRED_IMPL("vector_sort", 2, vector_sort, 0)
+{ pl_vector *v, *s;
+
+  if ( !get_vector(A1, &v) || !(s=new_vector(v->type, v->length)) )
+    return FALSE;
+  if ( !sort_vector(v, s) )
+  { free(s);
+    return FALSE;
+  }
+
+  return unify_vector(A2, s);
+}
+
+
+static
+PRED_IMPL("vector_cumsum", 2, vector_cumsum, 0)
+{ pl_vector *v, *c;
+  size_t len;
+
+  if ( !get_vector(A1, &v) || !(c=new_vector(v->type, v->length)) )
+    return FALSE;
+  len = v->length;
+
+  switch(v->type)
+  { case VEC_INT64:
+    { int64_t s = 0;
+
+      for(size_t i=0; i<len; i++)
+      { if ( !add_i64(s, v->data.i[i], &s) )
+	{ free(c);
+	  return int_overflow();
+	}
+	c->data.i[i] = s;
+      }
+      break;
+    }
+    case VEC_FLOAT64:
+    { double s = 0.0;
+
+      for(size_t i=0; i<len; i++)
+	c->data.d[i] = (s += v->data.d[i]);
+      break;
+    }
+    case VEC_FLOAT32:
+    { double s = 0.0;
+
+      for(size_t i=0; i<len; i++)
+	c->data.f[i] = (float)(s += v->data.f[i]);
+      break;
+    }
+  }
+
+  return unify_vector(A2, c);
+}
+
+
+		 /*******************************
+		 *	     FUNCTIONS		*
+		 *******************************/
+
+/* - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+valueVectorFunction() evaluates sum_vector/1, dot_vector/2, min_vector/1
+and max_vector/1 for valueExpression().  The arguments are not evaluated.
+- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
+#define arg_vector(p, vp) LDFUNC(arg_vector, p, vp)
+static int
+arg_vector(DECL_LD Word p, pl_vector **vp)
+{ deRef(p);
+
+  if ( (*vp = symbol_vector(*p)) )
+    return TRUE;
+
+  if ( isVar(*p) )
+    return PL_error(NULL, 0, NULL, ERR_INSTANTIATION);
+  PL_error(NULL, 0, NULL, ERR_TYPE, ATOM_vector, pushWordAsTermRef(p));
+  popTermRef();
+
+  return FALSE;
+}
+
+int
+valueVectorFunction(DECL_LD Functor term, Number r)
+{ functor_t f = term->definition;
+  pl_vector *v;
+
+  if ( !arg_vector(&term->arguments[0], &v) )
+    return FALSE;
+
+  if ( f == FUNCTOR_sum_vector1 )
+  { if ( !vector_sum(v, r) )
+      return FALSE;
+  } else if ( f == FUNCTOR_dot_vector2 )
+  { pl_vector *v2;
+
+    if ( !arg_vector(&term->arguments[1], &v2) )
+      return FALSE;
+    if ( v->length != v2->length )
+    { Word p = &term->arguments[1];
+
+      deRef(p);
+      PL_domain_error("vector_length", pushWordAsTermRef(p));
+      popTermRef();
+      return FALSE;
+    }
+    if ( !vector_dot(v, v2, r) )
+      return FALSE;
+  } else
+  { number min, max;
+
+    if ( !vector_min_max(v, &min, &max) )
+      return PL_error(NULL, 0, NULL, ERR_AR_UNDEF);
+    *r = (f == FUNCTOR_min_vector1 ? min : max);
+  }
+
+  return r->type == V_FLOAT ? check_float(r) : TRUE;
+}
+
+
+		 /*******************************
+		 *      PUBLISH PREDICATES	*
+		 *******************************/
+
+BeginPredDefs(vector)
+  PRED_DEF("list_to_vector", 3, list_to_vector, 0)
+  PRED_DEF("vector_to_list", 2, vector_to_list, 0)
+  PRED_DEF("new_vector",     4, new_vector,     0)
+  PRED_DEF("is_vector",      1, is_vector,      0)
+  PRED_DEF("vector_type",    2, vector_type,    0)
+  PRED_DEF("vector_length",  2, vector_length,  0)
+  PRED_DEF("vector_get",     3, vector_get,     0)
+  PRED_DEF("vector_set",     3, vector_set,     0)
+  PRED_DEF("vector_slice",   4, vector_slice,   0)
+  PRED_DEF("vector_sum",     2, vector_sum,     0)
+  PRED_DEF("vector_dot",     3, vector_dot,     0)
+  PRED_DEF("vector_min_max", 3, vector_min_max, 0)
+  PRED_DEF("vector_axpy",    4, vector_axpy,    0)
+  PRED_DEF("vector_sort",    2, vector_sort,    0)
+  PRED_DEF("vector_cumsum",  2, vector_cumsum,  0)
+EndPredDefs
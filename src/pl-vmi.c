@@ -2068,6 +2068,7 @@ VMH(depart_or_retry_continue, 0, (), ())
 
     Profile(FR->prof_node = profCall(DEF));
     Coverage(FR, CALL_PORT);
+    AllocProfileCall(FR);
 
 #ifdef O_LIMIT_DEPTH
     { size_t depth = levelFrame(FR);
@@ -2130,6 +2131,7 @@ VMH(depart_or_retry_continue, 0, (), ())
 #endif /*O_DEBUGGER*/
   }
 
+  CountPort(FR, CALL_PORT);
   PC = DEF->codes;
   NEXT_INSTRUCTION;
 }
@@ -2155,7 +2157,8 @@ VMI(I_DEPART, VIF_BREAK, 1, (CA1_PROC))
        truePrologFlag(PLFLAG_LASTCALL) &&
        ( proc->definition->impl.any.defined ||
 	 true(proc->definition, PROC_DEFINED)) )
-  { if ( true(FR, FR_WATCHED) )
+  { CountLCO(FR);
+    if ( true(FR, FR_WATCHED) )
     { LD->query->next_environment = lTop;
       lTop = (LocalFrame)ARGP;		/* just pushed arguments, so top */
       SAVE_REGISTERS(QID);
@@ -2293,6 +2296,7 @@ VMI(I_EXIT, VIF_BREAK, 0, ())
   }
 
   Coverage(FR, EXIT_PORT);
+  CountPort(FR, EXIT_PORT);
 
   if ( (void *)BFR <= (void *)FR )	/* deterministic */
   { leave = true(FR, FR_WATCHED) ? FR : NULL;
@@ -2610,6 +2614,7 @@ VMI(I_LCALL, 0, 1, (CA1_PROC))
 { Procedure proc = (Procedure)*PC++;
   Module ctx0 = contextModule(FR);
 
+  CountLCO(FR);
   leaveDefinition(DEF);
   FR->clause = NULL;
   DEF = proc->definition;
@@ -2647,7 +2652,8 @@ VMI(I_LCALL, 0, 1, (CA1_PROC))
 END_VMI
 
 VMI(I_TCALL, 0, 0, ())
-{ if ( true(FR, FR_WATCHED) )
+{ CountLCO(FR);
+  if ( true(FR, FR_WATCHED) )
   { SAVE_REGISTERS(QID);
     frameFinished(FR, FINISH_EXIT);
     LOAD_REGISTERS(QID);
@@ -5384,6 +5390,7 @@ again:
 	      LOAD_REGISTERS(QID)
 	    });
 
+      CountPort(FR, EXCEPTION_PORT);
       if ( true(FR, FR_WATCHED) )
       { SAVE_REGISTERS(QID);
 	dbg_discardChoicesAfter(FR, FINISH_EXTERNAL_EXCEPT);
@@ -5448,6 +5455,7 @@ again:
 
       lTop = (LocalFrame)argFrameP(FR, FR->predicate->functor->arity);
       discardFrame(FR);
+      CountPort(FR, EXCEPTION_PORT);
       if ( true(FR, FR_WATCHED) )
       { SAVE_REGISTERS(QID);
 	frameFinished(FR, FINISH_EXCEPT);
@@ -6908,6 +6916,7 @@ next_choice:
       PC     = clause->codes;
       lTop   = (LocalFrame)argFrameP(FR, clause->variables);
       UMODE  = uread;
+      CountPort(FR, REDO_PORT);
 
       DEBUG(CHK_SECURE, assert(LD->mark_bar >= gBase && LD->mark_bar <= gTop));
 
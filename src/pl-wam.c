@@ -65,6 +65,7 @@
 #include "pl-index.h"
 #include "pl-cont.h"
 #include "pl-coverage.h"
+#include "pl-counters.h"
 #include <fenv.h>
 #ifdef _MSC_VER
 #pragma warning(disable: 4102)		/* unreferenced labels */
@@ -212,6 +213,7 @@ updateAlerted(PL_local_data_t *ld)
   }
 #ifdef O_PROFILE
   if ( ld->profile.active )			mask |= ALERT_PROFILE;
+  if ( allocProfiling(ld) )			mask |= ALERT_ALLOCPROF;
 #endif
 #ifdef O_PLMT
   if ( ld->exit_requested )			mask |= ALERT_EXITREQ;
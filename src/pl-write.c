@@ -46,8 +46,10 @@
 #include "pl-prims.h"
 #include "pl-modul.h"
 #include "pl-setup.h"
+#include "pl-gc.h"
 #include <math.h>
 #include "os/pl-dtoa.h"
+#include "os/pl-fltconv.h"
 #include "os/pl-ctype.h"
 #include "os/pl-utf8.h"
 #include "os/pl-prologflag.h"
@@ -269,7 +271,7 @@ code_requires_quoted(int c, IOSTREAM *fd, int flags)
 }
 
 static int
-atomType(atom_t a, write_options *options)
+atomTypeNoCache(atom_t a, write_options *options)
 { Atom atom = atomValue(a);
   char *s = atom->name;
   size_t len = atom->length;
@@ -327,6 +329,71 @@ atomType(atom_t a, write_options *options)
 }
 
 
+/* - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Deciding whether an atom needs quotes requires scanning its text. As the
+same atoms are typically written many  times,   we  cache the result in
+a byte per atom (see allocateAtomBlock()   in pl-atom.c). The type only
+depends on the text if the atom consists  of printable ASCII and is not
+affected by the var_prefix, dot_in_atom and back_quotes settings. Other
+atoms are flagged AT_CONTEXT and classified by atomTypeNoCache().
+- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
+#define AT_TYPE_MASK	0x07		/* AT_* */
+#define AT_CACHED	0x08		/* Cached info is valid */
+#define AT_ASCII	0x10		/* Only printable ASCII */
+#define AT_ESCAPE	0x20		/* Contains ' or \ */
+#define AT_CONTEXT	0x40		/* Type depends on options */
+
+static int
+atomWriteType(atom_t a, Atom atom)
+{ unsigned char *tp = atomWriteTypeP(a);
+  int wt = *tp;
+
+  if ( !wt )
+  { const unsigned char *s = (const unsigned char *)atom->name;
+    size_t len = atom->length;
+    int dot = FALSE;
+    size_t i;
+
+    wt = AT_CACHED|AT_ASCII;
+    for(i=0; i<len; i++)
+    { int c = s[i];
+
+      if ( c < ' ' || c >= 0x7f )
+	wt &= ~AT_ASCII;
+      else if ( c == '\'' || c == '\\' )
+	wt |= AT_ESCAPE;
+      else if ( c == '.' )
+	dot = TRUE;
+      else if ( c == '`' )
+	wt |= AT_CONTEXT;
+    }
+    if ( len > 0 && isAlpha(s[0]) && (dot || !isLower(s[0])) )
+      wt |= AT_CONTEXT;
+
+    if ( !(wt&AT_ASCII) )
+      wt |= AT_CONTEXT;
+    else if ( !(wt&AT_CONTEXT) )
+      wt |= atomTypeNoCache(a, NULL);
+
+    *tp = (unsigned char)wt;
+  }
+
+  return wt;
+}
+
+
+static int
+atomType(atom_t a, write_options *options)
+{ int wt = atomWriteType(a, atomValue(a));
+
+  if ( !(wt&AT_CONTEXT) )
+    return wt&AT_TYPE_MASK;
+
+  return atomTypeNoCache(a, options);
+}
+
+
 static int
 unquoted_atomW(atom_t atom, IOSTREAM *fd, int flags)
 { Atom ap = atomValue(atom);
@@ -972,7 +1039,9 @@ complicated to avoid. Second, it does not provide a mode that guarantees
 reliable read-back. Using %g gets closest,   but %.15g doesn't guarantee
 read-back and %.17g does, but prints 0.1 as 0.100..001, etc.
 
-This uses dtoa.c. See pl-dtoa.c for how this is packed into SWI-Prolog.
+The digits are computed by float_shortest()   from pl-fltconv.c using the
+Ryu algorithm. This produces the  same  digits   as  dtoa()  in mode 0,
+but avoids allocation and is a lot faster.
 
 TBD: The number of cases are large. We should see whether it is possible
 to clean this up a bit. The 5 cases   as  such are real: there is no way
@@ -1127,19 +1196,42 @@ format_special_float(double f, char *buf)
 }
 
 
+static void
+format_exponent(char *o, int e, int plus)
+{ char tmp[8];
+  int n = 0;
+
+  *o++ = 'e';
+  if ( e < 0 )
+  { *o++ = '-';
+    e = -e;
+  } else if ( plus )
+  { *o++ = '+';
+  }
+  do
+  { tmp[n++] = (char)('0' + e%10);
+    e /= 10;
+  } while(e);
+  while(n > 0)
+    *o++ = tmp[--n];
+  *o = EOS;
+}
+
 char *
 format_float(double f, char *buf)
-{ char *end, *o=buf, *s;
-  int decpt, sign;
+{ char digits[FLT_SHORTEST_DIGITS];
+  char *end, *o=buf, *s;
+  int decpt;
 
   if ( (s=format_special_float(f, buf)) )
     return s;
 
-  s = dtoa(f, 0, 30, &decpt, &sign, &end);
-  DEBUG(2, Sdprintf("decpt=%d, sign=%d, len = %d, '%s'\n",
-		    decpt, sign, end-s, s));
+  s = digits;
+  end = s + float_shortest(fabs(f), s, &decpt);
+  DEBUG(2, Sdprintf("decpt=%d, len = %d, '%s'\n",
+		    decpt, end-s, s));
 
-  if ( sign )
+  if ( signbit(f) )
     *o++ = '-';
 
   if ( decpt <= 0 )			/* decimal dot before */
@@ -1151,7 +1243,7 @@ format_float(double f, char *buf)
 	o += end-s-1;
       } else
 	*o++ = '0';
-      sprintf(o, "e%d", decpt-1);
+      format_exponent(o, decpt-1, FALSE);
     } else
     { int i;
 
@@ -1181,7 +1273,7 @@ format_float(double f, char *buf)
 	o += end-s-1;
       } else
 	*o++ = '0';
-      sprintf(o, "e+%d", trailing);
+      format_exponent(o, trailing, TRUE);
     } else				/* within precision trail with .0 */
     { memcpy(o, s, end-s);
       o += end-s;
@@ -1194,8 +1286,6 @@ format_float(double f, char *buf)
     }
   }
 
-  freedtoa(s);
-
   return buf;
 }
 
@@ -1791,6 +1881,256 @@ writeTerm2(term_t t, int prec, write_options *options, int flags)
 }
 
 
+		 /*******************************
+		 *	    FAST WRITER		*
+		 *******************************/
+
+/* - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+If no portray hooks, depth limit or  alternative list notation applies,
+writeTopTerm() uses writeTermFast(), which walks   the  term directly
+rather than using term references and writeTerm(). This is notably the
+case for write_canonical/1 and writeq/1 when writing (large) facts.
+
+All tokens emitted by writeTermFast() are either  the start of the term
+or follow one of "(,[|" and thus never need a space. Tokens that consist
+of printable ASCII characters are copied directly into the stream buffer
+by PutASCII().
+
+Anything not handled  here  is  passed  to   writeTerm().  This  is the
+case for variables, strings, big numbers,   blobs,  non-ASCII atoms and
+dicts as well as terms that must be   written as operators, i.e., if the
+functor is an operator and ignore_ops is not in effect.
+
+Writing a  subterm  may  run  GC  or   shift  the  stacks,  either  in
+writeTerm() or when flushing the output  stream. Compound terms are thus
+anchored in a term reference and  their   arguments  are  fetched from
+there after writing each argument.
+- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
+#define canWriteFast(options) \
+	( false(options, PL_WRT_PORTRAY|PL_WRT_BLOB_PORTRAY| \
+			 PL_WRT_ATTVAR_PORTRAY|PL_WRT_PARTIAL| \
+			 PL_WRT_DOTLISTS|PL_WRT_NO_LISTS) && \
+	  !(options)->max_depth )
+
+static inline int
+fastEncoding(IOSTREAM *s)
+{ switch(s->encoding)
+  { case ENC_OCTET:
+    case ENC_ASCII:
+    case ENC_ISO_LATIN_1:
+    case ENC_UTF8:
+      return !s->tee;
+    default:
+      return FALSE;
+  }
+}
+
+/* PutASCII() emits a non-empty string of printable ASCII characters */
+
+static bool
+PutASCII(const char *str, size_t len, IOSTREAM *s)
+{ if ( s->buffer && (size_t)(s->limitp - s->bufp) >= len &&
+       fastEncoding(s) )
+  { memcpy(s->bufp, str, len);
+    s->bufp += len;
+    if ( s->position )
+    { s->position->byteno  += len;
+      s->position->charno  += len;
+      s->position->linepos += (int)len;
+    }
+    s->lastc = str[len-1]&0xff;
+
+    return TRUE;
+  }
+
+  return PutStringN(str, len, s);
+}
+
+static inline bool
+PutcASCII(int c, IOSTREAM *s)
+{ char chr = (char)c;
+
+  return PutASCII(&chr, 1, s);
+}
+
+static bool
+PutCommaFast(write_options *options)
+{ if ( options->spacing == ATOM_next_argument )
+    return PutASCII(", ", 2, options->out);
+  else
+    return PutcASCII(',', options->out);
+}
+
+static int
+writeAtomFast(atom_t a, write_options *options)
+{ Atom atom = atomValue(a);
+  const char *s = atom->name;
+  size_t len = atom->length;
+  size_t i;
+  int wt;
+
+  if ( atom->type->write || false(atom->type, PL_BLOB_TEXT) || len == 0 )
+    return writeAtom(a, options);
+  wt = atomWriteType(a, atom);
+  if ( !(wt&AT_ASCII) )
+    return writeAtom(a, options);
+
+  if ( true(options, PL_WRT_QUOTED) )
+  { int type = ( (wt&AT_CONTEXT) ? atomTypeNoCache(a, options)
+				 : (wt&AT_TYPE_MASK) );
+
+    switch( type )
+    { case AT_LOWER:
+      case AT_SYMBOL:
+      case AT_SOLO:
+      case AT_SPECIAL:
+	break;
+      default:
+      { char buf[256];
+	char *o = buf;
+	int esc = true(options, PL_WRT_CHARESCAPES);
+
+	if ( !(wt&AT_ESCAPE) )
+	  return ( PutcASCII('\'', options->out) &&
+		   PutASCII(s, len, options->out) &&
+		   PutcASCII('\'', options->out) );
+	if ( len > (sizeof(buf)-2)/2 )
+	  return writeAtom(a, options);
+	*o++ = '\'';
+	for(i=0; i<len; i++)
+	{ if ( s[i] == '\'' || s[i] == '\\' )
+	    *o++ = esc ? '\\' : s[i];
+	  *o++ = s[i];
+	}
+	*o++ = '\'';
+
+	return PutASCII(buf, o-buf, options->out);
+      }
+    }
+  }
+
+  return PutASCII(s, len, options->out);
+}
+
+static char *
+format_int64(int64_t i, char *end)
+{ uint64_t u = i < 0 ? -(uint64_t)i : (uint64_t)i;
+  char *s = end;
+
+  do
+  { *--s = (char)('0' + u%10);
+    u /= 10;
+  } while(u);
+  if ( i < 0 )
+    *--s = '-';
+
+  return s;
+}
+
+#define writeTermFast(p, prec, flags, options) \
+	LDFUNC(writeTermFast, p, prec, flags, options)
+
+static bool
+writeTermFast(DECL_LD Word p, int prec, int flags, write_options *options)
+{ IOSTREAM *out = options->out;
+  term_t t;
+  int rc;
+
+  deRef(p);
+  if ( isAtom(*p) )
+  { return writeAtomFast(*p, options);
+  } else if ( isTaggedInt(*p) )
+  { char buf[24];
+    char *s = format_int64(valInt(*p), &buf[sizeof(buf)]);
+
+    return PutASCII(s, &buf[sizeof(buf)]-s, out);
+  } else if ( isFloat(*p) )
+  { char buf[100];
+
+    format_float(valFloat(*p), buf);
+    return PutASCII(buf, strlen(buf), out);
+  } else if ( isTerm(*p) )
+  { word w = *p;
+    Functor f = valueTerm(w);
+    FunctorDef fd = valueFunctor(f->definition);
+    size_t arity = fd->arity;
+    size_t n;
+
+    if ( f->definition == FUNCTOR_isovar1 &&
+	 true(options, PL_WRT_NUMBERVARS|PL_WRT_VARNAMES) )
+    { t = pushWordAsTermRef(p);
+      rc = writeNumberVar(t, options);
+      p = valTermRef(t);
+      w = *p;
+      popTermRef();
+      if ( rc == TRUE )
+	return TRUE;
+      if ( rc < 0 )
+	return FALSE;
+      f = valueTerm(w);
+    }
+
+    if ( f->definition != FUNCTOR_dot2 &&
+	 ( fd->name == ATOM_dict ||
+	   ( false(options, PL_WRT_IGNOREOPS) &&
+	     ( fd->name == ATOM_curl || fd->name == ATOM_nil ||
+	       ( arity <= 2 && priorityOperator(options->module, fd->name) > 0 ))) ||
+	   ( false(options, PL_WRT_BRACETERMS) &&
+	     f->definition == FUNCTOR_curl1 ) ) )
+      goto fallback;
+
+    if ( !(t = PL_new_term_ref()) )
+      return FALSE;
+    *valTermRef(t) = w;		/* anchor; p may be shifted */
+#define FT() valueTerm(*valTermRef(t))
+
+    if ( fd->functor == FUNCTOR_dot2 )
+    { rc = PutcASCII('[', out);
+      while(rc)
+      { if ( !(rc=writeTermFast(&FT()->arguments[0], 999, W_LIST_ARG, options)) )
+	  break;
+	p = &FT()->arguments[1];
+	deRef(p);
+	if ( *p == ATOM_nil )
+	{ rc = PutcASCII(']', out);
+	  break;
+	}
+	if ( isTerm(*p) && valueTerm(*p)->definition == FUNCTOR_dot2 )
+	{ *valTermRef(t) = *p;
+	  rc = PutCommaFast(options);
+	} else
+	{ rc = ( PutcASCII('|', out) &&
+		 writeTermFast(&FT()->arguments[1], 999, W_LIST_TAIL, options) &&
+		 PutcASCII(']', out) );
+	  break;
+	}
+      }
+    } else
+    { rc = ( writeAtomFast(fd->name, options) &&
+	     PutcASCII('(', out) );
+      for(n=0; rc && n<arity; n++)
+      { if ( n > 0 && !(rc=PutCommaFast(options)) )
+	  break;
+	rc = writeTermFast(&FT()->arguments[n], 999, W_COMPOUND_ARG, options);
+      }
+      rc = rc && PutcASCII(')', out);
+    }
+#undef FT
+
+    PL_reset_term_refs(t);
+    return rc;
+  }
+
+fallback:
+  t = pushWordAsTermRef(p);
+  rc = writeTerm(t, prec, options, flags);
+  popTermRef();
+
+  return rc;
+}
+
+
 		 /*******************************
 		 *	  CYCLE HANDLING	*
 		 *******************************/
@@ -1848,10 +2188,17 @@ writeTopTerm(term_t term, int prec, write_options *options)
   Slock(options->out);
   if ( (!(options->flags&PL_WRT_NO_CYCLES) && options->max_depth) ||
        PL_is_acyclic(term) )
-  { C_STACK_OVERFLOW_GUARDED(
-	rc,
-	writeTerm(term, prec, options, wflags),
-        (void)0);
+  { if ( wflags == W_TOP && canWriteFast(options) )
+    { C_STACK_OVERFLOW_GUARDED(
+	  rc,
+	  writeTermFast(valTermRef(term), prec, wflags, options),
+	  (void)0);
+    } else
+    { C_STACK_OVERFLOW_GUARDED(
+	  rc,
+	  writeTerm(term, prec, options, wflags),
+	  (void)0);
+    }
   } else
   { fid_t fid;
     term_t template, substitutions, cycles, at_term;